@@ -0,0 +1,433 @@
+#include "allocation-counter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if _WIN32
+#include <malloc.h>
+#endif // _WIN32
+
+namespace
+{
+
+// no constructor runs for these, so counting is safe from the first
+// allocation of a thread on
+constinit thread_local uint64_t thread_allocations { };
+constinit thread_local uint64_t thread_allocated_bytes { };
+
+[[maybe_unused]] void CountAllocation(
+   const size_t size ) noexcept
+{
+   ++thread_allocations;
+   thread_allocated_bytes += size;
+}
+
+} // namespace
+
+bool IsAllocationTrackingEnabled( ) noexcept
+{
+#if MATH_FACTS_TRACK_ALLOCATIONS
+   return true;
+#else
+   return false;
+#endif // MATH_FACTS_TRACK_ALLOCATIONS
+}
+
+AllocationCounts GetThreadAllocationCounts( ) noexcept
+{
+   return
+      AllocationCounts {
+         thread_allocations,
+         thread_allocated_bytes
+      };
+}
+
+#if MATH_FACTS_TRACK_ALLOCATIONS
+
+#if __GLIBC__
+// qt containers, strings and images allocate with malloc rather than new,
+// so with glibc malloc itself is counted, and new is counted through it
+extern "C"
+{
+
+void * __libc_malloc(
+   size_t size );
+void * __libc_calloc(
+   size_t count,
+   size_t size );
+void * __libc_realloc(
+   void * pointer,
+   size_t size );
+void * __libc_memalign(
+   size_t alignment,
+   size_t size );
+
+void * malloc(
+   size_t size )
+{
+   CountAllocation(
+      size);
+
+   return
+      __libc_malloc(
+         size);
+}
+
+void * calloc(
+   size_t count,
+   size_t size )
+{
+   CountAllocation(
+      count * size);
+
+   return
+      __libc_calloc(
+         count,
+         size);
+}
+
+void * realloc(
+   void * pointer,
+   size_t size )
+{
+   CountAllocation(
+      size);
+
+   return
+      __libc_realloc(
+         pointer,
+         size);
+}
+
+// qt and glibc itself allocate aligned memory through these, which do not
+// go through malloc
+void * memalign(
+   size_t alignment,
+   size_t size )
+{
+   CountAllocation(
+      size);
+
+   return
+      __libc_memalign(
+         alignment,
+         size);
+}
+
+void * aligned_alloc(
+   size_t alignment,
+   size_t size )
+{
+   CountAllocation(
+      size);
+
+   return
+      __libc_memalign(
+         alignment,
+         size);
+}
+
+int posix_memalign(
+   void ** pointer,
+   size_t alignment,
+   size_t size )
+{
+   const bool valid_alignment =
+      alignment % sizeof(void *) == 0 &&
+      (alignment & (alignment - 1)) == 0 &&
+      alignment != 0;
+
+   if (!valid_alignment)
+      return
+         EINVAL;
+
+   CountAllocation(
+      size);
+
+   void * const allocated =
+      __libc_memalign(
+         alignment,
+         size);
+
+   if (!allocated)
+      return
+         ENOMEM;
+
+   *pointer = allocated;
+
+   return
+      0;
+}
+
+} // extern "C"
+#endif // __GLIBC__
+
+namespace
+{
+
+void * Allocate(
+   size_t size ) noexcept
+{
+#if !__GLIBC__
+   CountAllocation(
+      size);
+#endif // !__GLIBC__
+
+   if (size == 0)
+   {
+      size = 1;
+   }
+
+   for (;;)
+   {
+      if (void * const pointer = std::malloc(size))
+         return pointer;
+
+      const std::new_handler handler =
+         std::get_new_handler();
+
+      if (!handler)
+         return nullptr;
+
+      handler();
+   }
+}
+
+void * AllocateAligned(
+   size_t size,
+   const std::align_val_t alignment ) noexcept
+{
+#if !__GLIBC__
+   CountAllocation(
+      size);
+#endif // !__GLIBC__
+
+   const size_t alignment_bytes =
+      static_cast< size_t >(alignment);
+
+   // aligned_alloc takes whole multiples of the alignment only
+   size =
+      (std::max(size, size_t { 1 }) + alignment_bytes - 1) &
+      ~(alignment_bytes - 1);
+
+   for (;;)
+   {
+#if _WIN32
+      void * const pointer =
+         _aligned_malloc(
+            size,
+            alignment_bytes);
+#else
+      void * const pointer =
+         std::aligned_alloc(
+            alignment_bytes,
+            size);
+#endif // _WIN32
+
+      if (pointer)
+         return pointer;
+
+      const std::new_handler handler =
+         std::get_new_handler();
+
+      if (!handler)
+         return nullptr;
+
+      handler();
+   }
+}
+
+void FreeAligned(
+   void * const pointer ) noexcept
+{
+#if _WIN32
+   _aligned_free(
+      pointer);
+#else
+   std::free(
+      pointer);
+#endif // _WIN32
+}
+
+} // namespace
+
+void * operator new(
+   const size_t size )
+{
+   if (void * const pointer = Allocate(size))
+      return pointer;
+
+   throw std::bad_alloc { };
+}
+
+void * operator new[](
+   const size_t size )
+{
+   if (void * const pointer = Allocate(size))
+      return pointer;
+
+   throw std::bad_alloc { };
+}
+
+void * operator new(
+   const size_t size,
+   const std::nothrow_t & ) noexcept
+{
+   return
+      Allocate(
+         size);
+}
+
+void * operator new[](
+   const size_t size,
+   const std::nothrow_t & ) noexcept
+{
+   return
+      Allocate(
+         size);
+}
+
+void operator delete(
+   void * const pointer ) noexcept
+{
+   std::free(
+      pointer);
+}
+
+void operator delete[](
+   void * const pointer ) noexcept
+{
+   std::free(
+      pointer);
+}
+
+void operator delete(
+   void * const pointer,
+   const size_t ) noexcept
+{
+   std::free(
+      pointer);
+}
+
+void operator delete[](
+   void * const pointer,
+   const size_t ) noexcept
+{
+   std::free(
+      pointer);
+}
+
+void operator delete(
+   void * const pointer,
+   const std::nothrow_t & ) noexcept
+{
+   std::free(
+      pointer);
+}
+
+void operator delete[](
+   void * const pointer,
+   const std::nothrow_t & ) noexcept
+{
+   std::free(
+      pointer);
+}
+
+void * operator new(
+   const size_t size,
+   const std::align_val_t alignment )
+{
+   if (void * const pointer = AllocateAligned(size, alignment))
+      return pointer;
+
+   throw std::bad_alloc { };
+}
+
+void * operator new[](
+   const size_t size,
+   const std::align_val_t alignment )
+{
+   if (void * const pointer = AllocateAligned(size, alignment))
+      return pointer;
+
+   throw std::bad_alloc { };
+}
+
+void * operator new(
+   const size_t size,
+   const std::align_val_t alignment,
+   const std::nothrow_t & ) noexcept
+{
+   return
+      AllocateAligned(
+         size,
+         alignment);
+}
+
+void * operator new[](
+   const size_t size,
+   const std::align_val_t alignment,
+   const std::nothrow_t & ) noexcept
+{
+   return
+      AllocateAligned(
+         size,
+         alignment);
+}
+
+void operator delete(
+   void * const pointer,
+   const std::align_val_t ) noexcept
+{
+   FreeAligned(
+      pointer);
+}
+
+void operator delete[](
+   void * const pointer,
+   const std::align_val_t ) noexcept
+{
+   FreeAligned(
+      pointer);
+}
+
+void operator delete(
+   void * const pointer,
+   const size_t,
+   const std::align_val_t ) noexcept
+{
+   FreeAligned(
+      pointer);
+}
+
+void operator delete[](
+   void * const pointer,
+   const size_t,
+   const std::align_val_t ) noexcept
+{
+   FreeAligned(
+      pointer);
+}
+
+void operator delete(
+   void * const pointer,
+   const std::align_val_t,
+   const std::nothrow_t & ) noexcept
+{
+   FreeAligned(
+      pointer);
+}
+
+void operator delete[](
+   void * const pointer,
+   const std::align_val_t,
+   const std::nothrow_t & ) noexcept
+{
+   FreeAligned(
+      pointer);
+}
+
+#endif // MATH_FACTS_TRACK_ALLOCATIONS
@@ -0,0 +1,46 @@
+#ifndef _ALLOCATION_COUNTER_HPP_
+#define _ALLOCATION_COUNTER_HPP_
+
+#include <cstdint>
+
+// heap allocations made by the calling thread.  only counted when built
+// with MATH_FACTS_TRACK_ALLOCATIONS, which replaces every form of the
+// global operator new and delete and, with glibc, malloc; otherwise every
+// count reads as zero.
+struct AllocationCounts
+{
+   uint64_t allocations;
+   uint64_t bytes;
+};
+
+bool IsAllocationTrackingEnabled( ) noexcept;
+
+AllocationCounts GetThreadAllocationCounts( ) noexcept;
+
+// the allocations of this thread since the scope was entered
+class AllocationScope
+{
+public:
+   AllocationScope( ) noexcept :
+   start_ { GetThreadAllocationCounts() }
+   {
+   }
+
+   AllocationCounts Counts( ) const noexcept
+   {
+      const AllocationCounts now =
+         GetThreadAllocationCounts();
+
+      return
+         AllocationCounts {
+            now.allocations - start_.allocations,
+            now.bytes - start_.bytes
+         };
+   }
+
+private:
+   AllocationCounts start_;
+
+};
+
+#endif // _ALLOCATION_COUNTER_HPP_
@@ -0,0 +1,427 @@
+#include "answer-journal.hpp"
+#include "session-format.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <string>
+#include <system_error>
+
+#if _WIN32
+#  include <fcntl.h>
+#  include <io.h>
+#  include <sys/stat.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif // _WIN32
+
+namespace
+{
+
+// journal files start with this header and are followed by records.
+// both are stored in host byte order, as the journal is only ever read
+// back on the machine that wrote it.
+struct JournalHeader
+{
+   char magic[4];
+   uint16_t version;
+   uint16_t record_size;
+   uint64_t session_start_unix_ms;
+};
+
+static_assert(sizeof(JournalHeader) == 16);
+
+constexpr char JOURNAL_MAGIC[4] { 'M', 'F', 'S', 'J' };
+constexpr uint16_t JOURNAL_VERSION { 2 };
+constexpr size_t JOURNAL_BATCH_RECORDS { 256 };
+
+uint32_t RecordChecksum(
+   const JournalRecord & record ) noexcept
+{
+   return
+      Crc32(
+         reinterpret_cast< const uint8_t * >(&record),
+         offsetof(JournalRecord, checksum));
+}
+
+// append only file that can be synced to disk
+class AppendFile
+{
+public:
+   AppendFile(
+      const std::filesystem::path & path ) noexcept :
+   descriptor_ { -1 }
+   {
+#if _WIN32
+      _wsopen_s(
+         &descriptor_,
+         path.c_str(),
+         _O_WRONLY | _O_CREAT | _O_TRUNC | _O_APPEND | _O_BINARY,
+         _SH_DENYWR,
+         _S_IREAD | _S_IWRITE);
+#else
+      descriptor_ =
+         ::open(
+            path.c_str(),
+            O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC,
+            0644);
+#endif // _WIN32
+   }
+
+   ~AppendFile( ) noexcept
+   {
+      if (IsOpen())
+      {
+#if _WIN32
+         _close(descriptor_);
+#else
+         ::close(descriptor_);
+#endif // _WIN32
+      }
+   }
+
+   AppendFile(
+      const AppendFile & ) = delete;
+   AppendFile & operator = (
+      const AppendFile & ) = delete;
+
+   bool IsOpen( ) const noexcept
+   {
+      return
+         descriptor_ >= 0;
+   }
+
+   bool Write(
+      const void * const data,
+      const size_t size ) noexcept
+   {
+      const char * bytes =
+         static_cast< const char * >(data);
+      size_t remaining { size };
+
+      while (remaining)
+      {
+#if _WIN32
+         const int written =
+            _write(
+               descriptor_,
+               bytes,
+               static_cast< unsigned int >(
+                  std::min< size_t >(remaining, 1u << 30)));
+#else
+         const ssize_t written =
+            ::write(
+               descriptor_,
+               bytes,
+               remaining);
+#endif // _WIN32
+
+         if (written <= 0)
+            return false;
+
+         bytes += written;
+         remaining -= written;
+      }
+
+      return true;
+   }
+
+   bool Sync( ) noexcept
+   {
+#if _WIN32
+      return
+         _commit(descriptor_) == 0;
+#elif __APPLE__
+      return
+         ::fsync(descriptor_) == 0;
+#else
+      return
+         ::fdatasync(descriptor_) == 0;
+#endif // _WIN32
+   }
+
+private:
+   int descriptor_;
+
+};
+
+} // namespace
+
+AnswerJournal::AnswerJournal( ) noexcept :
+flush_interval_ { },
+stop_requested_ { },
+next_sequence_ { },
+dropped_records_ { }
+{
+}
+
+AnswerJournal::~AnswerJournal( ) noexcept
+{
+   Stop();
+}
+
+bool AnswerJournal::Start(
+   const std::filesystem::path & journal_path,
+   const uint64_t session_start_unix_ms,
+   const std::chrono::milliseconds flush_interval ) noexcept
+{
+   if (writer_.joinable())
+      return false;
+
+   path_ = journal_path;
+   flush_interval_ = flush_interval;
+   stop_requested_ = false;
+   next_sequence_ = 0;
+
+   try
+   {
+      writer_ =
+         std::thread {
+            &AnswerJournal::WriterLoop,
+            this,
+            session_start_unix_ms
+         };
+   }
+   catch (...)
+   {
+      return false;
+   }
+
+   return true;
+}
+
+void AnswerJournal::Stop( ) noexcept
+{
+   if (writer_.joinable())
+   {
+      {
+         const std::lock_guard< std::mutex > lock {
+            wake_mutex_
+         };
+
+         stop_requested_ = true;
+      }
+
+      wake_.notify_one();
+      writer_.join();
+   }
+}
+
+bool AnswerJournal::Append(
+   const AnswerRecord & answer ) noexcept
+{
+   JournalRecord record { };
+
+   record.sequence = next_sequence_++;
+   record.fact_id = answer.fact_id;
+   record.operation = static_cast< uint8_t >(answer.operation);
+   record.number_of_responses =
+      static_cast< uint8_t >(
+         std::min< size_t >(answer.responses.size(), UINT8_MAX));
+   record.answered_at_ms = answer.answered_at_ms;
+   record.response_time_ms = answer.response_time_ms;
+   record.think_time_ms = answer.think_time_ms;
+   record.typing_time_ms = answer.typing_time_ms;
+   record.ui_latency_ms = answer.ui_latency_ms;
+
+   std::copy_n(
+      answer.responses.begin(),
+      std::min(answer.responses.size(), JournalRecord::MAX_RESPONSES),
+      record.responses);
+
+   record.checksum =
+      RecordChecksum(record);
+
+   const bool pushed =
+      writer_.joinable() &&
+      ring_.TryPush(record);
+
+   if (!pushed)
+   {
+      dropped_records_.fetch_add(
+         1,
+         std::memory_order_relaxed);
+   }
+
+   return
+      pushed;
+}
+
+size_t AnswerJournal::DroppedRecords( ) const noexcept
+{
+   return
+      dropped_records_.load(std::memory_order_relaxed);
+}
+
+size_t AnswerJournal::QueueDepth( ) const noexcept
+{
+   return
+      ring_.Size();
+}
+
+const std::filesystem::path & AnswerJournal::GetPath( ) const noexcept
+{
+   return
+      path_;
+}
+
+void AnswerJournal::WriterLoop(
+   const uint64_t session_start_unix_ms ) noexcept
+{
+   std::error_code error;
+
+   std::filesystem::create_directories(
+      path_.parent_path(),
+      error);
+
+   AppendFile journal_file {
+      path_
+   };
+
+   if (journal_file.IsOpen())
+   {
+      JournalHeader header { };
+
+      std::memcpy(
+         header.magic,
+         JOURNAL_MAGIC,
+         sizeof(JOURNAL_MAGIC));
+
+      header.version = JOURNAL_VERSION;
+      header.record_size = sizeof(JournalRecord);
+      header.session_start_unix_ms = session_start_unix_ms;
+
+      journal_file.Write(
+         &header,
+         sizeof(header));
+      journal_file.Sync();
+   }
+
+   JournalRecord batch[JOURNAL_BATCH_RECORDS];
+
+   bool stopping { };
+
+   while (!stopping)
+   {
+      {
+         std::unique_lock< std::mutex > lock {
+            wake_mutex_
+         };
+
+         wake_.wait_for(
+            lock,
+            flush_interval_,
+            [ this ] ( ) { return stop_requested_; });
+
+         stopping = stop_requested_;
+      }
+
+      // one sync per flush interval no matter how many batches
+      bool written { };
+
+      for (size_t batch_size { }; ; batch_size = 0)
+      {
+         while (batch_size < JOURNAL_BATCH_RECORDS)
+         {
+            const auto record =
+               ring_.TryPop();
+
+            if (!record)
+               break;
+
+            batch[batch_size++] = *record;
+         }
+
+         if (!batch_size)
+            break;
+
+         if (journal_file.IsOpen())
+         {
+            written |=
+               journal_file.Write(
+                  batch,
+                  batch_size * sizeof(JournalRecord));
+         }
+      }
+
+      if (written)
+      {
+         journal_file.Sync();
+      }
+   }
+}
+
+bool AnswerJournal::ReadFrom(
+   const std::filesystem::path & journal_path,
+   uint64_t & offset,
+   uint64_t & session_start_unix_ms,
+   std::vector< AnswerRecord > & answers ) noexcept
+{
+   try
+   {
+      std::ifstream journal_file {
+         journal_path,
+         std::ios_base::in | std::ios_base::binary
+      };
+
+      JournalHeader header { };
+
+      if (!journal_file.read(reinterpret_cast< char * >(&header), sizeof(header)) ||
+          std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+          header.version != JOURNAL_VERSION ||
+          header.record_size != sizeof(JournalRecord))
+      {
+         return false;
+      }
+
+      session_start_unix_ms =
+         header.session_start_unix_ms;
+
+      // always on a record boundary after the header
+      offset =
+         std::max< uint64_t >(
+            offset,
+            sizeof(header));
+
+      if (!journal_file.seekg(static_cast< std::streamoff >(offset)))
+         return false;
+
+      JournalRecord record { };
+
+      while (journal_file.read(reinterpret_cast< char * >(&record), sizeof(record)))
+      {
+         // a torn record is read again once it has been completed
+         if (record.checksum != RecordChecksum(record))
+            break;
+
+         offset += sizeof(record);
+
+         answers.push_back(
+            AnswerRecord {
+               record.fact_id,
+               static_cast< FactOperation >(record.operation),
+               record.answered_at_ms,
+               record.response_time_ms,
+               record.think_time_ms,
+               record.typing_time_ms,
+               record.ui_latency_ms,
+               std::vector< int32_t > {
+                  record.responses,
+                  record.responses +
+                     std::min< size_t >(
+                        record.number_of_responses,
+                        JournalRecord::MAX_RESPONSES) },
+               std::string { }
+            });
+      }
+
+      return true;
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
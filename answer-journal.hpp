@@ -0,0 +1,103 @@
+#ifndef _ANSWER_JOURNAL_HPP_
+#define _ANSWER_JOURNAL_HPP_
+
+#include "answer-record.hpp"
+#include "spsc-ring.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed size journal entry; the checksum covers every byte before it so
+// that a record torn by a power cut is detected and dropped on recovery
+struct JournalRecord
+{
+   static constexpr size_t MAX_RESPONSES { 7 };
+
+   uint32_t sequence;
+   uint16_t fact_id;
+   uint8_t operation;
+   // counts every response, even those beyond MAX_RESPONSES
+   uint8_t number_of_responses;
+   uint64_t answered_at_ms;
+   uint32_t response_time_ms;
+   // kept so that a recovered session has the same latency breakdown
+   uint32_t think_time_ms;
+   uint32_t typing_time_ms;
+   uint32_t ui_latency_ms;
+   int32_t responses[MAX_RESPONSES];
+   uint32_t checksum;
+};
+
+static_assert(sizeof(JournalRecord) == 64);
+
+// write ahead journal of answered problems.  Append never blocks; it
+// hands the record to a background writer through a lock free ring and
+// the writer appends batches to the file, syncing them to disk once per
+// flush interval.
+class AnswerJournal
+{
+public:
+   static constexpr size_t RING_CAPACITY { 1024 };
+   static constexpr const char * EXTENSION { ".journal" };
+
+   AnswerJournal( ) noexcept;
+   ~AnswerJournal( ) noexcept;
+
+   AnswerJournal(
+      const AnswerJournal & ) = delete;
+   AnswerJournal & operator = (
+      const AnswerJournal & ) = delete;
+
+   bool Start(
+      const std::filesystem::path & journal_path,
+      const uint64_t session_start_unix_ms,
+      const std::chrono::milliseconds flush_interval ) noexcept;
+   // flushes everything appended so far and stops the writer
+   void Stop( ) noexcept;
+
+   // called from a single thread only
+   bool Append(
+      const AnswerRecord & answer ) noexcept;
+
+   size_t DroppedRecords( ) const noexcept;
+   size_t QueueDepth( ) const noexcept;
+   const std::filesystem::path & GetPath( ) const noexcept;
+
+   // reads a journal that may still be written to, or one left behind
+   // by a session that never finished.  offset is 0 or the value left by
+   // an earlier call and is advanced past the records read, so only
+   // records appended since are returned; a record with a bad checksum
+   // ends the read.
+   static bool ReadFrom(
+      const std::filesystem::path & journal_path,
+      uint64_t & offset,
+      uint64_t & session_start_unix_ms,
+      std::vector< AnswerRecord > & answers ) noexcept;
+
+private:
+   void WriterLoop(
+      const uint64_t session_start_unix_ms ) noexcept;
+
+   SpscRing< JournalRecord, RING_CAPACITY > ring_;
+
+   std::filesystem::path path_;
+   std::chrono::milliseconds flush_interval_;
+
+   std::thread writer_;
+   std::mutex wake_mutex_;
+   std::condition_variable wake_;
+   bool stop_requested_;
+
+   uint32_t next_sequence_;
+   std::atomic< size_t > dropped_records_;
+
+};
+
+#endif // _ANSWER_JOURNAL_HPP_
@@ -0,0 +1,31 @@
+#ifndef _ANSWER_RECORD_HPP_
+#define _ANSWER_RECORD_HPP_
+
+#include "fact-operation.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// plain description of an answered problem, independent of qt, that
+// can outlive the problem object it was taken from
+struct AnswerRecord
+{
+   uint16_t fact_id;
+   FactOperation operation;
+
+   // milliseconds since the practice session started
+   uint64_t answered_at_ms;
+   uint32_t response_time_ms;
+   uint32_t think_time_ms;
+   uint32_t typing_time_ms;
+   uint32_t ui_latency_ms;
+
+   // arithmetic responses are the values typed in; time responses are
+   // packed with EncodeTimeResponse
+   std::vector< int32_t > responses;
+
+   std::string question_with_answer;
+};
+
+#endif // _ANSWER_RECORD_HPP_
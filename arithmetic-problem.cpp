@@ -1,8 +1,11 @@
 #include "arithmetic-problem.hpp"
+#include "fact-id.hpp"
+#include "fact-table.hpp"
 
 #include <QtCore/QPointF>
 #include <QtCore/QRect>
 #include <QtCore/QRectF>
+#include <QtCore/QSize>
 #include <QtCore/Qt>
 #include <QtCore/QtTypes>
 #include <QtCore/QVector>
@@ -18,42 +21,6 @@
 
 #include <cassert>
 
-static int32_t GenerateAnswer(
-   const int32_t top,
-   const int32_t bottom,
-   const ArithmeticProblem::Operation operation ) noexcept
-{
-   int32_t answer { };
-
-   switch (operation)
-   {
-   case ArithmeticProblem::Operation::ADD:
-      answer = top + bottom;
-      break;
-
-   case ArithmeticProblem::Operation::SUB:
-      answer = top - bottom;
-      break;
-
-   case ArithmeticProblem::Operation::MUL:
-      answer = top * bottom;
-      break;
-
-   case ArithmeticProblem::Operation::DIV:
-      assert(bottom != 0);
-      assert(top % bottom == 0);
-      answer = top / bottom;
-      break;
-
-   default:
-      assert(false);
-      break;
-   }
-
-   return
-      answer;
-}
-
 static QString ArithmeticSymbol(
    const ArithmeticProblem::Operation operation ) noexcept
 {
@@ -92,9 +59,31 @@ ArithmeticProblem::ArithmeticProblem(
    const Operation operation ) noexcept :
 top_ { QString::number(top) },
 bottom_ { QString::number(bottom) },
-answer_ { GenerateAnswer(top, bottom, operation) },
-operation_ { operation }
+operation_ { operation },
+problem_width_ { },
+problem_height_ { },
+fact_id_ { }
 {
+   assert(operation_ != Operation::DIV || (bottom != 0 && top % bottom == 0));
+
+   fact_id_ =
+      ArithmeticFactId(
+         GetOperation(),
+         top,
+         bottom);
+
+   switch (operation_)
+   {
+   case Operation::ADD: bottom_line_ = "+  "; break;
+   case Operation::SUB: bottom_line_ = "-  "; break;
+   case Operation::MUL: bottom_line_ = "x  "; break;
+   case Operation::DIV: bottom_line_ = "\u00F7  "; break;
+   }
+
+   bottom_line_ += bottom_;
+
+   response_.reserve(
+      MAX_RESPONSE_LENGTH);
 }
 
 ArithmeticProblem::~ArithmeticProblem( ) noexcept
@@ -124,7 +113,7 @@ QString ArithmeticProblem::GetQuestionWithAnswer( ) const noexcept
       " " +
       bottom_ +
       " = " +
-      QString::number(answer_);
+      QString::number(GetArithmeticAnswer(fact_id_));
 }
 
 size_t ArithmeticProblem::GetNumberOfResponses( ) const noexcept
@@ -133,15 +122,125 @@ size_t ArithmeticProblem::GetNumberOfResponses( ) const noexcept
       responses_.size();
 }
 
+FactOperation ArithmeticProblem::GetOperation( ) const noexcept
+{
+   FactOperation operation { };
+
+   switch (operation_)
+   {
+   case Operation::ADD: operation = FactOperation::ADD; break;
+   case Operation::SUB: operation = FactOperation::SUB; break;
+   case Operation::MUL: operation = FactOperation::MUL; break;
+   case Operation::DIV: operation = FactOperation::DIV; break;
+   }
+
+   return
+      operation;
+}
+
+uint16_t ArithmeticProblem::GetFactId( ) const noexcept
+{
+   return
+      fact_id_;
+}
+
+std::vector< int32_t > ArithmeticProblem::GetResponseValues( ) const noexcept
+{
+   return
+      responses_;
+}
+
 void ArithmeticProblem::OnPaintEvent(
    QPaintEvent * paint_event,
+   QPainter & painter,
    QWidget & widget ) noexcept
 {
-   // pixmap is at pixel ratio of 1.0
-   QPixmap text_pixmap {
-      2048, 2048
+   if (!IsCanvasCurrent(Canvas::TEXT))
+   {
+      RenderText(
+         ClaimCanvas(Canvas::TEXT));
+   }
+
+   const QPixmap & text_pixmap =
+      GetCanvas(
+         Canvas::TEXT);
+
+   // aspect of the inner background box
+   const qreal background_box_width { widget.width() - 60.0 };
+   const qreal background_box_height { widget.height() - 60.0 };
+   
+   const qreal background_box_aspect {
+      background_box_width / background_box_height
    };
 
+   const qreal problem_crop_x_start =
+      text_pixmap.width() - problem_width_;
+
+   const qreal problem_box_aspect =
+      problem_width_ / problem_height_;
+
+   qreal scaled_width { };
+   qreal scaled_height { };
+
+   if (background_box_aspect >= 1.0)
+   {
+      // the background box is wider than it is tall
+
+      // make the height of problem box match background box height
+      scaled_height = background_box_height;
+      scaled_width = problem_box_aspect * scaled_height;
+
+      if (scaled_width > background_box_width)
+      {
+         scaled_width = background_box_width;
+         scaled_height = scaled_width / problem_box_aspect;
+      }
+   }
+   else
+   {
+      // the background box is taller than it is wide
+
+      // make the width of problem box match background box width
+      scaled_width = background_box_width;
+      scaled_height = scaled_width / problem_box_aspect;
+
+      if (scaled_height > background_box_height)
+      {
+         scaled_height = background_box_height;
+         scaled_width = problem_box_aspect * scaled_height;
+      }
+   }
+
+   painter.setRenderHint(
+      QPainter::RenderHint::SmoothPixmapTransform,
+      true);
+
+   painter.drawPixmap(
+      QRectF { 
+         widget.width() / 2.0 - scaled_width / 2.0,
+         widget.height() / 2.0 - scaled_height / 2.0,
+         scaled_width,
+         scaled_height },
+      text_pixmap,
+      QRectF {
+         problem_crop_x_start,
+         0.0,
+         text_pixmap.width() - problem_crop_x_start,
+         problem_height_ });
+}
+
+void ArithmeticProblem::RenderText(
+   QPixmap & text_pixmap ) noexcept
+{
+   // pixmap is at pixel ratio of 1.0
+   if (text_pixmap.size() != QSize { 2048, 2048 })
+   {
+      text_pixmap =
+         QPixmap {
+            2048, 2048
+         };
+   }
+
    text_pixmap.fill(
       QColor { 0, 0, 0, 0 });
 
@@ -156,17 +255,8 @@ void ArithmeticProblem::OnPaintEvent(
       QPainter::RenderHint::TextAntialiasing,
       true);
 
-   const QFont font {
-   #if _WIN32
-      "Comic Sans MS",
-   #else
-      "Noto Sans Mono",
-   #endif
-      200
-   };
-
    text_painter.setFont(
-      font);
+      GetFont());
 
    // set the line thickness
    // set the color of line and font
@@ -180,22 +270,10 @@ void ArithmeticProblem::OnPaintEvent(
       text_painter.font()
    };
 
-   QString bottom;
-
-   switch (operation_)
-   {
-   case Operation::ADD: bottom += "+  "; break;
-   case Operation::SUB: bottom += "-  "; break;
-   case Operation::MUL: bottom += "x  "; break;
-   case Operation::DIV: bottom += "\u00F7  "; break;
-   }
-
-   bottom += bottom_;
-
    // problem two is always the longest line
    const QRect text_bounding_rect =
       font_metrics.tightBoundingRect(
-         bottom);
+         bottom_line_);
 
    // add a bit of space between the lines
    const int32_t line_space_gap { 10 };
@@ -213,7 +291,7 @@ void ArithmeticProblem::OnPaintEvent(
    text_painter.drawText(
       QRect { 0, line_height, text_pixmap.width(), text_pixmap.height() },
       Qt::AlignmentFlag::AlignRight,
-      bottom,
+      bottom_line_,
       &line2_bounding_box);
 
    text_painter.drawText(
@@ -236,77 +314,13 @@ void ArithmeticProblem::OnPaintEvent(
          static_cast< qreal >(text_pixmap.width() - answer_line_width),
          answer_line_y });
 
-   // aspect of the inner background box
-   const qreal background_box_width { widget.width() - 60.0 };
-   const qreal background_box_height { widget.height() - 60.0 };
-   
-   const qreal background_box_aspect {
-      background_box_width / background_box_height
-   };
-
-   const qreal problem_width =
+   problem_width_ =
       line2_bounding_box.width();
-   const qreal problem_height =
-      (line_height * 2 + 40 + font_metrics.height());
-   const qreal problem_crop_x_start =
-      text_pixmap.width() - problem_width;
-
-   const qreal problem_box_aspect =
-      problem_width / problem_height;
-
-   qreal scaled_width { };
-   qreal scaled_height { };
-
-   if (background_box_aspect >= 1.0)
-   {
-      // the background box is wider than it is tall
-
-      // make the height of problem box match background box height
-      scaled_height = background_box_height;
-      scaled_width = problem_box_aspect * scaled_height;
-
-      if (scaled_width > background_box_width)
-      {
-         scaled_width = background_box_width;
-         scaled_height = scaled_width / problem_box_aspect;
-      }
-   }
-   else
-   {
-      // the background box is taller than it is wide
-
-      // make the width of problem box match background box width
-      scaled_width = background_box_width;
-      scaled_height = scaled_width / problem_box_aspect;
-
-      if (scaled_height > background_box_height)
-      {
-         scaled_height = background_box_height;
-         scaled_width = problem_box_aspect * scaled_height;
-      }
-   }
-
-   QPainter painter { &widget };
-
-   painter.setRenderHint(
-      QPainter::RenderHint::SmoothPixmapTransform,
-      true);
-
-   painter.drawPixmap(
-      QRectF { 
-         widget.width() / 2.0 - scaled_width / 2.0,
-         widget.height() / 2.0 - scaled_height / 2.0,
-         scaled_width,
-         scaled_height },
-      text_pixmap,
-      QRectF {
-         problem_crop_x_start,
-         0.0,
-         text_pixmap.width() - problem_crop_x_start,
-         problem_height });
+   problem_height_ =
+      line_height * 2 + 40 + font_metrics.height();
 }
 
-void ArithmeticProblem::OnKeyReleaseEvent(
+void ArithmeticProblem::OnKeyPressEvent(
    QKeyEvent * key_event,
    const QWidget & widget ) noexcept
 {
@@ -316,9 +330,11 @@ void ArithmeticProblem::OnKeyReleaseEvent(
       [ this ] (
          const char c )
       {
-         if (response_.size() < 3)
+         if (response_.size() < MAX_RESPONSE_LENGTH)
          {
             response_ += c;
+
+            InvalidateCanvases();
          }
       };
 
@@ -340,6 +356,8 @@ void ArithmeticProblem::OnKeyReleaseEvent(
       {
          response_.resize(
             response_.size() - 1);
+
+         InvalidateCanvases();
       }
       
       break;
@@ -364,13 +382,17 @@ void ArithmeticProblem::GradeAnswer( ) noexcept
       response);
 
    const auto result =
-      response == answer_ ?
+      GradeArithmeticResponse(fact_id_, response) ?
       AnswerResult::CORRECT :
       AnswerResult::INCORRECT;
 
    if (result == AnswerResult::INCORRECT)
    {
-      response_.clear();
+      // clear would give up the reserved capacity
+      response_.truncate(
+         0);
+
+      InvalidateCanvases();
    }
 
    emit
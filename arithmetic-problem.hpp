@@ -4,10 +4,13 @@
 #include "problem.hpp"
 
 #include <QtCore/QString>
+#include <QtCore/QtTypes>
 
 #include <cstdint>
 #include <vector>
 
+class QPainter;
+class QPixmap;
 class QWidget;
 
 class ArithmeticProblem :
@@ -28,23 +31,39 @@ public:
    virtual QVector< QString > GetResponses( ) const noexcept override;
    virtual QString GetQuestionWithAnswer( ) const noexcept override;
    virtual size_t GetNumberOfResponses( ) const noexcept override;
+   virtual FactOperation GetOperation( ) const noexcept override;
+   virtual uint16_t GetFactId( ) const noexcept override;
+   virtual std::vector< int32_t > GetResponseValues( ) const noexcept override;
 
    virtual void OnPaintEvent(
       QPaintEvent * paint_event,
+      QPainter & painter,
       QWidget & widget ) noexcept override;
-   virtual void OnKeyReleaseEvent(
+   virtual void OnKeyPressEvent(
       QKeyEvent * key_event,
       const QWidget & widget ) noexcept override;
 
 private:
+   static constexpr int32_t MAX_RESPONSE_LENGTH { 3 };
+
+   // draws the problem at a pixel ratio of 1.0 and measures it
+   void RenderText(
+      QPixmap & text_pixmap ) noexcept;
    void GradeAnswer( ) noexcept;
 
    QString top_;
    QString bottom_;
+   // the symbol and the bottom number, as drawn
+   QString bottom_line_;
+   // its capacity is reserved, so typing never allocates
    QString response_;
    Operation operation_;
-   
-   int32_t answer_;
+
+   // the part of the text canvas the problem was drawn on
+   qreal problem_width_;
+   qreal problem_height_;
+
+   uint16_t fact_id_;
 
    std::vector< int32_t > responses_;
 
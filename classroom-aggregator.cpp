@@ -0,0 +1,309 @@
+#include "classroom-aggregator.hpp"
+
+#include <QtCore/QObject>
+#include <QtCore/QtEndian>
+#include <QtNetwork/QAbstractSocket>
+#include <QtNetwork/QLocalSocket>
+
+#include <algorithm>
+
+void StudentStatistics::Add(
+   const ClassroomAnswer & answer ) noexcept
+{
+   const bool retried =
+      answer.number_of_responses > 1;
+
+   ++answers;
+   retried_answers += retried;
+   ++answers_by_operation[static_cast< size_t >(answer.operation)];
+   last_answered_unix_ms =
+      std::max(
+         last_answered_unix_ms,
+         answer.answered_unix_ms);
+
+   recent_answers[next_recent] =
+      RecentAnswer {
+         answer.response_time_ms,
+         retried
+      };
+
+   next_recent = (next_recent + 1) % RECENT_ANSWERS;
+   recent_count = std::min(recent_count + 1, RECENT_ANSWERS);
+}
+
+double StudentStatistics::RecentMeanResponseTimeMs( ) const noexcept
+{
+   if (!recent_count)
+      return 0.0;
+
+   uint64_t sum { };
+
+   for (size_t i { }; i < recent_count; ++i)
+   {
+      sum += recent_answers[i].response_time_ms;
+   }
+
+   return
+      static_cast< double >(sum) / recent_count;
+}
+
+double StudentStatistics::RecentRetryRate( ) const noexcept
+{
+   if (!recent_count)
+      return 0.0;
+
+   size_t retried { };
+
+   for (size_t i { }; i < recent_count; ++i)
+   {
+      retried += recent_answers[i].retried;
+   }
+
+   return
+      static_cast< double >(retried) / recent_count;
+}
+
+ClassroomAggregator::ClassroomAggregator( ) noexcept :
+answer_count_ { },
+rejected_session_count_ { }
+{
+   // a whole classroom may connect at once when the aggregator starts
+   server_.setMaxPendingConnections(
+      1024);
+
+   QObject::connect(
+      &server_,
+      &QLocalServer::newConnection,
+      &server_,
+      [ this ] ( )
+      {
+         OnNewConnection();
+      });
+}
+
+bool ClassroomAggregator::Listen( ) noexcept
+{
+   // every student on a shared host runs as a different user
+   server_.setSocketOptions(
+      QLocalServer::SocketOption::WorldAccessOption);
+
+   if (server_.listen(CLASSROOM_SERVER_NAME))
+      return true;
+
+   if (server_.serverError() != QAbstractSocket::SocketError::AddressInUseError)
+      return false;
+
+   // left behind by an aggregator that did not shut down cleanly, unless
+   // another one is still answering
+   QLocalSocket probe;
+
+   probe.connectToServer(
+      CLASSROOM_SERVER_NAME);
+
+   if (probe.waitForConnected(1000))
+      return false;
+
+   QLocalServer::removeServer(
+      CLASSROOM_SERVER_NAME);
+
+   return
+      server_.listen(
+         CLASSROOM_SERVER_NAME);
+}
+
+QString ClassroomAggregator::ErrorString( ) const noexcept
+{
+   return
+      server_.errorString();
+}
+
+size_t ClassroomAggregator::SessionCount( ) const noexcept
+{
+   return
+      sessions_.size();
+}
+
+uint64_t ClassroomAggregator::AnswerCount( ) const noexcept
+{
+   return
+      answer_count_;
+}
+
+uint64_t ClassroomAggregator::RejectedSessionCount( ) const noexcept
+{
+   return
+      rejected_session_count_;
+}
+
+const std::map< QString, StudentStatistics > & ClassroomAggregator::Students( ) const noexcept
+{
+   return
+      students_;
+}
+
+void ClassroomAggregator::OnNewConnection( ) noexcept
+{
+   while (QLocalSocket * const socket = server_.nextPendingConnection())
+   {
+      sessions_.emplace(
+         socket,
+         Session { });
+
+      QObject::connect(
+         socket,
+         &QLocalSocket::readyRead,
+         socket,
+         [ this, socket ] ( )
+         {
+            OnReadyRead(
+               socket);
+         });
+
+      QObject::connect(
+         socket,
+         &QLocalSocket::disconnected,
+         socket,
+         [ this, socket ] ( )
+         {
+            OnDisconnected(
+               socket);
+         });
+
+      // the session may have sent its hello before it was accepted
+      if (socket->bytesAvailable() > 0)
+      {
+         OnReadyRead(
+            socket);
+      }
+   }
+}
+
+void ClassroomAggregator::OnReadyRead(
+   QLocalSocket * const socket ) noexcept
+{
+   const auto found =
+      sessions_.find(
+         socket);
+
+   if (found == sessions_.end())
+      return;
+
+   auto & session =
+      found->second;
+
+   for (;;)
+   {
+      if (!session.frame_size)
+      {
+         uint32_t frame_size { };
+
+         if (socket->bytesAvailable() < static_cast< qint64 >(sizeof(frame_size)))
+            return;
+
+         socket->read(
+            reinterpret_cast< char * >(&frame_size),
+            sizeof(frame_size));
+
+         session.frame_size =
+            qFromLittleEndian(
+               frame_size);
+
+         if (!session.frame_size ||
+             session.frame_size > CLASSROOM_MAX_FRAME_SIZE)
+         {
+            ++rejected_session_count_;
+
+            socket->abort();
+
+            return;
+         }
+      }
+
+      if (socket->bytesAvailable() < session.frame_size)
+         return;
+
+      const QByteArray payload =
+         socket->read(
+            session.frame_size);
+
+      session.frame_size = 0;
+
+      if (!HandleFrame(session, payload))
+      {
+         ++rejected_session_count_;
+
+         socket->abort();
+
+         return;
+      }
+   }
+}
+
+void ClassroomAggregator::OnDisconnected(
+   QLocalSocket * const socket ) noexcept
+{
+   if (const auto found = sessions_.find(socket);
+       found != sessions_.end())
+   {
+      // students stay listed once they stop, so their teacher sees them
+      if (const auto student = students_.find(found->second.username);
+          student != students_.end() && student->second.sessions)
+      {
+         --student->second.sessions;
+      }
+
+      sessions_.erase(
+         found);
+   }
+
+   socket->deleteLater();
+}
+
+bool ClassroomAggregator::HandleFrame(
+   Session & session,
+   const QByteArray & payload ) noexcept
+{
+   ClassroomFrame frame { };
+
+   if (!DecodeClassroomFrame(payload, frame))
+      return false;
+
+   if (frame.type == ClassroomFrameType::HELLO)
+   {
+      // a session says hello once, in a version this aggregator speaks
+      if (!session.username.isEmpty() ||
+          frame.username.isEmpty() ||
+          frame.version != CLASSROOM_PROTOCOL_VERSION)
+      {
+         return false;
+      }
+
+      session.username =
+         frame.username;
+
+      ++students_[session.username].sessions;
+
+      return true;
+   }
+
+   if (session.username.isEmpty())
+      return false;
+
+   auto & student =
+      students_[session.username];
+
+   student.dropped_answers +=
+      frame.dropped_answers;
+
+   for (const auto & answer : frame.answers)
+   {
+      student.Add(
+         answer);
+   }
+
+   answer_count_ +=
+      frame.answers.size();
+
+   return
+      true;
+}
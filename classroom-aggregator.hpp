@@ -0,0 +1,100 @@
+#ifndef _CLASSROOM_AGGREGATOR_HPP_
+#define _CLASSROOM_AGGREGATOR_HPP_
+
+#include "classroom-protocol.hpp"
+#include "fact-operation.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtNetwork/QLocalServer>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+class QLocalSocket;
+
+// how a student is doing, over every session of theirs on this host
+struct StudentStatistics
+{
+   static constexpr size_t RECENT_ANSWERS { 32 };
+
+   struct RecentAnswer
+   {
+      uint32_t response_time_ms;
+      bool retried;
+   };
+
+   uint32_t sessions;
+   uint64_t answers;
+   uint64_t retried_answers;
+   // given but never seen by the aggregator
+   uint64_t dropped_answers;
+   std::array< uint64_t, FACT_OPERATION_COUNT > answers_by_operation;
+   uint64_t last_answered_unix_ms;
+
+   // a ring of the most recent answers
+   std::array< RecentAnswer, RECENT_ANSWERS > recent_answers;
+   size_t recent_count;
+   size_t next_recent;
+
+   void Add(
+      const ClassroomAnswer & answer ) noexcept;
+
+   double RecentMeanResponseTimeMs( ) const noexcept;
+   double RecentRetryRate( ) const noexcept;
+};
+
+// accepts the sessions of every student on this host and keeps their
+// statistics in memory.  all work happens on the thread of the event
+// loop; a frame is only decoded once it has arrived in full, so a slow
+// or stuck session never holds up the others.
+class ClassroomAggregator
+{
+public:
+   ClassroomAggregator( ) noexcept;
+
+   ClassroomAggregator(
+      const ClassroomAggregator & ) = delete;
+   ClassroomAggregator & operator = (
+      const ClassroomAggregator & ) = delete;
+
+   bool Listen( ) noexcept;
+   QString ErrorString( ) const noexcept;
+
+   size_t SessionCount( ) const noexcept;
+   uint64_t AnswerCount( ) const noexcept;
+   uint64_t RejectedSessionCount( ) const noexcept;
+
+   // ordered by username
+   const std::map< QString, StudentStatistics > & Students( ) const noexcept;
+
+private:
+   struct Session
+   {
+      QString username;
+      // 0 until the size prefix of the next frame has been read
+      uint32_t frame_size;
+   };
+
+   void OnNewConnection( ) noexcept;
+   void OnReadyRead(
+      QLocalSocket * const socket ) noexcept;
+   void OnDisconnected(
+      QLocalSocket * const socket ) noexcept;
+   bool HandleFrame(
+      Session & session,
+      const QByteArray & payload ) noexcept;
+
+   QLocalServer server_;
+   std::unordered_map< QLocalSocket *, Session > sessions_;
+   std::map< QString, StudentStatistics > students_;
+
+   uint64_t answer_count_;
+   uint64_t rejected_session_count_;
+
+};
+
+#endif // _CLASSROOM_AGGREGATOR_HPP_
@@ -0,0 +1,209 @@
+#include "classroom-feed.hpp"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QObject>
+#include <QtCore/QRandomGenerator>
+
+#include <algorithm>
+#include <span>
+
+ClassroomFeed::ClassroomFeed(
+   const QString & username,
+   const bool enabled ) noexcept :
+username_ { username },
+enabled_ { enabled },
+unreported_drops_ { },
+dropped_answers_ { },
+hidden_ { }
+{
+   flush_timer_.setSingleShot(
+      true);
+   flush_timer_.setInterval(
+      FLUSH_INTERVAL);
+
+   QObject::connect(
+      &flush_timer_,
+      &QTimer::timeout,
+      &flush_timer_,
+      [ this ] ( )
+      {
+         Flush();
+      });
+
+   // a classroom of sessions that lost the aggregator at the same time
+   // should not all come back at the same time
+   reconnect_timer_.setSingleShot(
+      true);
+   reconnect_timer_.setInterval(
+      RECONNECT_INTERVAL +
+      std::chrono::milliseconds {
+         QRandomGenerator::global()->bounded(
+            static_cast< int >(RECONNECT_INTERVAL.count()))
+      });
+
+   QObject::connect(
+      &reconnect_timer_,
+      &QTimer::timeout,
+      &reconnect_timer_,
+      [ this ] ( )
+      {
+         Connect();
+      });
+
+   QObject::connect(
+      &socket_,
+      &QLocalSocket::connected,
+      &socket_,
+      [ this ] ( )
+      {
+         socket_.write(
+            EncodeClassroomHello(
+               username_,
+               static_cast< uint32_t >(QCoreApplication::applicationPid())));
+      });
+
+   QObject::connect(
+      &socket_,
+      &QLocalSocket::disconnected,
+      &socket_,
+      [ this ] ( )
+      {
+         pending_answers_.clear();
+         unreported_drops_ = 0;
+
+         ScheduleReconnect();
+      });
+
+   QObject::connect(
+      &socket_,
+      &QLocalSocket::errorOccurred,
+      &socket_,
+      [ this ] ( )
+      {
+         // most often there is no aggregator running
+         if (socket_.state() == QLocalSocket::LocalSocketState::UnconnectedState)
+         {
+            ScheduleReconnect();
+         }
+      });
+
+   // once the aggregator catches up, the answers held back can go
+   QObject::connect(
+      &socket_,
+      &QLocalSocket::bytesWritten,
+      &socket_,
+      [ this ] ( )
+      {
+         if (!pending_answers_.empty() && !flush_timer_.isActive())
+         {
+            flush_timer_.start();
+         }
+      });
+
+   Connect();
+}
+
+void ClassroomFeed::Append(
+   const ClassroomAnswer & answer ) noexcept
+{
+   if (!IsConnected())
+      return;
+
+   if (pending_answers_.size() >= MAX_PENDING_ANSWERS)
+   {
+      // the most recent answers say the most about how a student is doing
+      pending_answers_.erase(
+         pending_answers_.begin());
+
+      ++unreported_drops_;
+      ++dropped_answers_;
+   }
+
+   pending_answers_.push_back(
+      answer);
+
+   if (!flush_timer_.isActive())
+   {
+      flush_timer_.start();
+   }
+}
+
+bool ClassroomFeed::IsConnected( ) const noexcept
+{
+   return
+      socket_.state() == QLocalSocket::LocalSocketState::ConnectedState;
+}
+
+uint64_t ClassroomFeed::DroppedAnswers( ) const noexcept
+{
+   return
+      dropped_answers_;
+}
+
+void ClassroomFeed::SetHidden(
+   const bool hidden ) noexcept
+{
+   if (hidden == hidden_)
+      return;
+
+   hidden_ = hidden;
+
+   if (hidden_)
+   {
+      reconnect_timer_.stop();
+   }
+   else if (!IsConnected())
+   {
+      // the aggregator may have come up while nobody looked
+      reconnect_timer_.stop();
+
+      Connect();
+   }
+}
+
+void ClassroomFeed::Connect( ) noexcept
+{
+   if (!enabled_ ||
+       socket_.state() != QLocalSocket::LocalSocketState::UnconnectedState)
+      return;
+
+   socket_.connectToServer(
+      CLASSROOM_SERVER_NAME);
+}
+
+void ClassroomFeed::ScheduleReconnect( ) noexcept
+{
+   // shown again, SetHidden connects at once
+   if (!hidden_)
+   {
+      reconnect_timer_.start();
+   }
+}
+
+void ClassroomFeed::Flush( ) noexcept
+{
+   size_t sent { };
+
+   while (IsConnected() &&
+          sent < pending_answers_.size() &&
+          socket_.bytesToWrite() < MAX_UNSENT_BYTES)
+   {
+      const size_t count =
+         std::min(
+            pending_answers_.size() - sent,
+            CLASSROOM_MAX_BATCH_ANSWERS);
+
+      socket_.write(
+         EncodeClassroomAnswers(
+            unreported_drops_,
+            std::span { pending_answers_ }.subspan(sent, count)));
+
+      unreported_drops_ = 0;
+      sent += count;
+   }
+
+   // whatever is left waits for bytesWritten
+   pending_answers_.erase(
+      pending_answers_.begin(),
+      pending_answers_.begin() + sent);
+}
@@ -0,0 +1,69 @@
+#ifndef _CLASSROOM_FEED_HPP_
+#define _CLASSROOM_FEED_HPP_
+
+#include "classroom-protocol.hpp"
+
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtNetwork/QLocalSocket>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// streams the answers of a session to the classroom aggregator, if one is
+// running.  nothing here ever waits on the socket: answers given within a
+// flush interval go out as one frame, and while the aggregator lags behind
+// they pile up to a limit, past which the oldest are dropped and counted.
+class ClassroomFeed
+{
+public:
+   static constexpr std::chrono::milliseconds FLUSH_INTERVAL { 250 };
+   static constexpr std::chrono::milliseconds RECONNECT_INTERVAL { 10000 };
+   static constexpr size_t MAX_PENDING_ANSWERS { 4096 };
+   // written but not yet taken by the aggregator
+   static constexpr qint64 MAX_UNSENT_BYTES { 64 * 1024 };
+
+   // a disabled feed never connects, so it sends nothing
+   ClassroomFeed(
+      const QString & username,
+      const bool enabled ) noexcept;
+
+   ClassroomFeed(
+      const ClassroomFeed & ) = delete;
+   ClassroomFeed & operator = (
+      const ClassroomFeed & ) = delete;
+
+   // answers given while no aggregator is connected are not kept
+   void Append(
+      const ClassroomAnswer & answer ) noexcept;
+
+   bool IsConnected( ) const noexcept;
+   uint64_t DroppedAnswers( ) const noexcept;
+
+   // no reconnect is tried while the window cannot be seen; once it is
+   // shown again, one is tried at once
+   void SetHidden(
+      const bool hidden ) noexcept;
+
+private:
+   void Connect( ) noexcept;
+   void ScheduleReconnect( ) noexcept;
+   void Flush( ) noexcept;
+
+   QString username_;
+   bool enabled_;
+   QLocalSocket socket_;
+   QTimer flush_timer_;
+   QTimer reconnect_timer_;
+
+   std::vector< ClassroomAnswer > pending_answers_;
+   // reported with the next frame
+   uint32_t unreported_drops_;
+   uint64_t dropped_answers_;
+   bool hidden_;
+
+};
+
+#endif // _CLASSROOM_FEED_HPP_
@@ -0,0 +1,191 @@
+#include "classroom-protocol.hpp"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QIODevice>
+#include <QtCore/QtEndian>
+
+#include <utility>
+
+namespace
+{
+
+// both ends are built from the same sources, but the version is pinned anyway
+constexpr QDataStream::Version STREAM_VERSION { QDataStream::Version::Qt_5_15 };
+
+QDataStream & OpenStream(
+   QDataStream & stream ) noexcept
+{
+   stream.setVersion(
+      STREAM_VERSION);
+   stream.setByteOrder(
+      QDataStream::ByteOrder::LittleEndian);
+
+   return
+      stream;
+}
+
+// reserves the size prefix, which is filled in by FinishFrame
+QByteArray StartFrame( ) noexcept
+{
+   return
+      QByteArray(
+         sizeof(uint32_t),
+         '\0');
+}
+
+QByteArray FinishFrame(
+   QByteArray frame ) noexcept
+{
+   qToLittleEndian(
+      static_cast< uint32_t >(frame.size() - sizeof(uint32_t)),
+      frame.data());
+
+   return
+      frame;
+}
+
+} // namespace
+
+QByteArray EncodeClassroomHello(
+   const QString & username,
+   const uint32_t process_id ) noexcept
+{
+   QByteArray frame =
+      StartFrame();
+
+   QDataStream stream {
+      &frame,
+      QIODevice::OpenModeFlag::WriteOnly | QIODevice::OpenModeFlag::Append
+   };
+
+   OpenStream(stream)
+      << static_cast< quint8 >(ClassroomFrameType::HELLO)
+      << static_cast< quint16 >(CLASSROOM_PROTOCOL_VERSION)
+      << username
+      << static_cast< quint32 >(process_id);
+
+   return
+      FinishFrame(
+         std::move(frame));
+}
+
+QByteArray EncodeClassroomAnswers(
+   const uint32_t dropped_answers,
+   const std::span< const ClassroomAnswer > answers ) noexcept
+{
+   QByteArray frame =
+      StartFrame();
+
+   QDataStream stream {
+      &frame,
+      QIODevice::OpenModeFlag::WriteOnly | QIODevice::OpenModeFlag::Append
+   };
+
+   OpenStream(stream)
+      << static_cast< quint8 >(ClassroomFrameType::ANSWERS)
+      << static_cast< quint32 >(dropped_answers)
+      << static_cast< quint16 >(answers.size());
+
+   for (const auto & answer : answers)
+   {
+      stream
+         << static_cast< quint16 >(answer.fact_id)
+         << static_cast< quint8 >(answer.operation)
+         << static_cast< quint8 >(answer.number_of_responses)
+         << static_cast< quint32 >(answer.response_time_ms)
+         << static_cast< quint64 >(answer.answered_unix_ms);
+   }
+
+   return
+      FinishFrame(
+         std::move(frame));
+}
+
+bool DecodeClassroomFrame(
+   const QByteArray & payload,
+   ClassroomFrame & frame ) noexcept
+{
+   QDataStream stream {
+      payload
+   };
+
+   quint8 type { };
+
+   OpenStream(stream)
+      >> type;
+
+   frame.type =
+      static_cast< ClassroomFrameType >(type);
+
+   switch (frame.type)
+   {
+   case ClassroomFrameType::HELLO:
+   {
+      quint16 version { };
+      quint32 process_id { };
+
+      stream
+         >> version
+         >> frame.username
+         >> process_id;
+
+      frame.version = version;
+      frame.process_id = process_id;
+
+      break;
+   }
+
+   case ClassroomFrameType::ANSWERS:
+   {
+      quint32 dropped_answers { };
+      quint16 count { };
+
+      stream
+         >> dropped_answers
+         >> count;
+
+      if (count > CLASSROOM_MAX_BATCH_ANSWERS)
+         return false;
+
+      frame.dropped_answers = dropped_answers;
+      frame.answers.resize(count);
+
+      for (auto & answer : frame.answers)
+      {
+         quint16 fact_id { };
+         quint8 operation { };
+         quint8 number_of_responses { };
+         quint32 response_time_ms { };
+         quint64 answered_unix_ms { };
+
+         stream
+            >> fact_id
+            >> operation
+            >> number_of_responses
+            >> response_time_ms
+            >> answered_unix_ms;
+
+         if (operation >= FACT_OPERATION_COUNT)
+            return false;
+
+         answer =
+            ClassroomAnswer {
+               fact_id,
+               static_cast< FactOperation >(operation),
+               number_of_responses,
+               response_time_ms,
+               answered_unix_ms
+            };
+      }
+
+      break;
+   }
+
+   default:
+      return false;
+   }
+
+   return
+      stream.status() == QDataStream::Status::Ok &&
+      stream.atEnd();
+}
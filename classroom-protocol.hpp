@@ -0,0 +1,74 @@
+#ifndef _CLASSROOM_PROTOCOL_HPP_
+#define _CLASSROOM_PROTOCOL_HPP_
+
+#include "fact-operation.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// practice sessions report their answers to the classroom aggregator over
+// a local socket.  every frame is a 32 bit size followed by that many
+// bytes: a frame type and its fields, written with qdatastream.
+//
+//    HELLO    version, username, process id
+//    ANSWERS  answers dropped since the previous frame, answer count and
+//             the answers, 16 bytes each
+//
+// a session says hello once, right after connecting.
+constexpr const char * CLASSROOM_SERVER_NAME { "math-facts-classroom" };
+
+constexpr uint16_t CLASSROOM_PROTOCOL_VERSION { 1 };
+
+// keeps a frame well within the socket buffers of both ends
+constexpr size_t CLASSROOM_MAX_BATCH_ANSWERS { 512 };
+constexpr uint32_t CLASSROOM_MAX_FRAME_SIZE { 64 * 1024 };
+
+enum class ClassroomFrameType : uint8_t
+{
+   HELLO = 1,
+   ANSWERS = 2
+};
+
+struct ClassroomAnswer
+{
+   uint16_t fact_id;
+   FactOperation operation;
+   // capped at 255
+   uint8_t number_of_responses;
+   uint32_t response_time_ms;
+   uint64_t answered_unix_ms;
+};
+
+struct ClassroomFrame
+{
+   ClassroomFrameType type;
+
+   // hello
+   uint16_t version;
+   QString username;
+   uint32_t process_id;
+
+   // answers
+   uint32_t dropped_answers;
+   std::vector< ClassroomAnswer > answers;
+};
+
+// the frames include their size prefix
+QByteArray EncodeClassroomHello(
+   const QString & username,
+   const uint32_t process_id ) noexcept;
+QByteArray EncodeClassroomAnswers(
+   const uint32_t dropped_answers,
+   const std::span< const ClassroomAnswer > answers ) noexcept;
+
+// decodes a frame without its size prefix; false if it is malformed
+bool DecodeClassroomFrame(
+   const QByteArray & payload,
+   ClassroomFrame & frame ) noexcept;
+
+#endif // _CLASSROOM_PROTOCOL_HPP_
@@ -0,0 +1,709 @@
+#include "dashboard-model.hpp"
+#include "answer-journal.hpp"
+#include "answer-record.hpp"
+#include "report-parser.hpp"
+#include "session-format.hpp"
+#include "session-report.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+
+// the cache is only read back on the machine that wrote it, so values
+// are stored in host byte order
+constexpr char CACHE_MAGIC[4] { 'M', 'F', 'D', 'C' };
+constexpr uint16_t CACHE_VERSION { 1 };
+
+class CacheWriter
+{
+public:
+   template < typename T >
+   void Put(
+      const T value )
+   {
+      static_assert(std::is_arithmetic_v< T >);
+
+      const auto bytes =
+         reinterpret_cast< const uint8_t * >(&value);
+
+      data_.insert(
+         data_.end(),
+         bytes,
+         bytes + sizeof(value));
+   }
+
+   void Put(
+      const std::string_view text )
+   {
+      Put(
+         static_cast< uint16_t >(text.size()));
+
+      data_.insert(
+         data_.end(),
+         text.begin(),
+         text.begin() + static_cast< uint16_t >(text.size()));
+   }
+
+   std::vector< uint8_t > & Data( ) noexcept
+   {
+      return
+         data_;
+   }
+
+private:
+   std::vector< uint8_t > data_;
+
+};
+
+class CacheReader
+{
+public:
+   CacheReader(
+      const uint8_t * const begin,
+      const uint8_t * const end ) noexcept :
+   position_ { begin },
+   end_ { end },
+   failed_ { }
+   {
+   }
+
+   template < typename T >
+   T Get( ) noexcept
+   {
+      static_assert(std::is_arithmetic_v< T >);
+
+      T value { };
+
+      if (static_cast< size_t >(end_ - position_) < sizeof(value))
+      {
+         failed_ = true;
+      }
+      else
+      {
+         std::memcpy(
+            &value,
+            position_,
+            sizeof(value));
+
+         position_ += sizeof(value);
+      }
+
+      return
+         value;
+   }
+
+   std::string GetString( )
+   {
+      const auto size =
+         Get< uint16_t >();
+
+      if (static_cast< size_t >(end_ - position_) < size)
+      {
+         failed_ = true;
+
+         return { };
+      }
+
+      std::string text {
+         reinterpret_cast< const char * >(position_),
+         size
+      };
+
+      position_ += size;
+
+      return
+         text;
+   }
+
+   bool Failed( ) const noexcept
+   {
+      return
+         failed_;
+   }
+
+private:
+   const uint8_t * position_;
+   const uint8_t * end_;
+   bool failed_;
+
+};
+
+std::string SessionKey(
+   const std::string_view username,
+   const uint64_t session_start_unix_ms )
+{
+   std::string session { username };
+
+   session += '/';
+   session += std::to_string(session_start_unix_ms);
+
+   return
+      session;
+}
+
+} // namespace
+
+DashboardModel::DashboardModel( ) noexcept :
+facts_ ( FACT_ID_COUNT )
+{
+}
+
+bool DashboardModel::Update(
+   const std::filesystem::path & reports_directory ) noexcept
+{
+   bool changed { };
+
+   try
+   {
+      std::vector< std::filesystem::path > journals;
+      std::vector< std::filesystem::path > session_files;
+      std::set< std::string, std::less< > > present;
+
+      std::error_code error;
+
+      // listing the directory does not read any file
+      for (std::filesystem::directory_iterator entry {
+              reports_directory,
+              error };
+           !error && entry != std::filesystem::directory_iterator { };
+           entry.increment(error))
+      {
+         const auto & path =
+            entry->path();
+         const auto extension =
+            path.extension();
+
+         if (extension == AnswerJournal::EXTENSION)
+         {
+            journals.push_back(path);
+         }
+         else if (extension == SESSION_FORMAT_EXTENSION)
+         {
+            if (!session_files_.contains(path.filename().string()))
+            {
+               session_files.push_back(path);
+            }
+         }
+         else
+         {
+            continue;
+         }
+
+         present.insert(
+            path.filename().string());
+      }
+
+      std::map< std::string_view, uint32_t > active_sessions;
+
+      // journals first, so a session whose file appeared since the last
+      // update is completed from where its journal left off
+      for (const auto & journal : journals)
+      {
+         const std::string name = journal.filename().string();
+         const std::string report_name = journal.stem().string();
+
+         std::string_view username;
+         std::string_view date_time;
+
+         if (ParseReportName(report_name, username, date_time))
+         {
+            FoldJournal(
+               journal,
+               name,
+               username,
+               changed);
+
+            ++active_sessions[students_.find(username)->first];
+         }
+      }
+
+      for (const auto & session_file : session_files)
+      {
+         const std::string name = session_file.filename().string();
+         const std::string report_name = session_file.stem().string();
+
+         std::string_view username;
+         std::string_view date_time;
+
+         if (ParseReportName(report_name, username, date_time))
+         {
+            FoldSessionFile(
+               session_file,
+               username,
+               changed);
+         }
+
+         session_files_.insert(
+            name);
+      }
+
+      for (auto & [username, student] : students_)
+      {
+         const auto active =
+            active_sessions.find(username);
+         const uint32_t active_count =
+            active != active_sessions.end() ?
+               active->second :
+               0;
+
+         changed |= student.active_sessions != active_count;
+         student.active_sessions = active_count;
+      }
+
+      // forget files that were removed or archived
+      std::erase_if(
+         journal_offsets_,
+         [ & ] (
+            const auto & journal )
+         {
+            return
+               !present.contains(journal.first);
+         });
+
+      std::erase_if(
+         session_files_,
+         [ & ] (
+            const std::string & session_file )
+         {
+            return
+               !present.contains(session_file);
+         });
+   }
+   catch (...)
+   {
+   }
+
+   return
+      changed;
+}
+
+DashboardSummary DashboardModel::Summarize( ) const
+{
+   DashboardSummary summary;
+
+   summary.students.reserve(
+      students_.size());
+
+   for (const auto & [username, student] : students_)
+   {
+      const uint64_t answers =
+         student.response_time.Count();
+
+      summary.students.push_back(
+         StudentProgress {
+            username,
+            student.sessions,
+            student.active_sessions,
+            answers,
+            student.response_time.Mean(),
+            answers ?
+               static_cast< double >(student.retried_answers) / answers :
+               0.0,
+            student.last_answer_unix_ms });
+   }
+
+   for (uint16_t fact_id { }; fact_id < facts_.size(); ++fact_id)
+   {
+      const auto & fact =
+         facts_[fact_id];
+      const uint64_t answers =
+         fact.response_time.Count();
+
+      if (answers)
+      {
+         summary.facts.push_back(
+            FactProgress {
+               fact_id,
+               answers,
+               fact.response_time.Mean(),
+               static_cast< double >(fact.retried_answers) / answers });
+      }
+   }
+
+   return
+      summary;
+}
+
+std::vector< std::filesystem::path > DashboardModel::JournalPaths(
+   const std::filesystem::path & reports_directory ) const
+{
+   std::vector< std::filesystem::path > journal_paths;
+
+   for (const auto & journal : journal_offsets_)
+   {
+      journal_paths.push_back(
+         reports_directory / journal.first);
+   }
+
+   return
+      journal_paths;
+}
+
+bool DashboardModel::Save(
+   const std::filesystem::path & path ) const noexcept
+{
+   try
+   {
+      CacheWriter cache;
+
+      for (const char c : CACHE_MAGIC)
+      {
+         cache.Put(c);
+      }
+
+      cache.Put(CACHE_VERSION);
+
+      cache.Put(static_cast< uint32_t >(students_.size()));
+
+      for (const auto & [username, student] : students_)
+      {
+         cache.Put(std::string_view { username });
+         cache.Put(student.response_time.Count());
+         cache.Put(student.response_time.Mean());
+         cache.Put(student.response_time.SumOfSquares());
+         cache.Put(student.retried_answers);
+         cache.Put(student.last_answer_unix_ms);
+         cache.Put(student.sessions);
+      }
+
+      for (const auto & fact : facts_)
+      {
+         cache.Put(fact.response_time.Count());
+         cache.Put(fact.response_time.Mean());
+         cache.Put(fact.response_time.SumOfSquares());
+         cache.Put(fact.retried_answers);
+      }
+
+      cache.Put(static_cast< uint32_t >(journal_offsets_.size()));
+
+      for (const auto & [name, journal] : journal_offsets_)
+      {
+         cache.Put(std::string_view { name });
+         cache.Put(journal.offset);
+         cache.Put(journal.records);
+      }
+
+      cache.Put(static_cast< uint32_t >(session_files_.size()));
+
+      for (const auto & name : session_files_)
+      {
+         cache.Put(std::string_view { name });
+      }
+
+      cache.Put(static_cast< uint32_t >(session_answers_.size()));
+
+      for (const auto & [session, answers] : session_answers_)
+      {
+         cache.Put(std::string_view { session });
+         cache.Put(answers);
+      }
+
+      auto & data =
+         cache.Data();
+
+      cache.Put(
+         Crc32(
+            data.data(),
+            data.size()));
+
+      std::error_code error;
+
+      std::filesystem::create_directories(
+         path.parent_path(),
+         error);
+
+      return
+         WriteFileAtomically(
+            path,
+            data.data(),
+            data.size());
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+bool DashboardModel::Load(
+   const std::filesystem::path & path ) noexcept
+{
+   try
+   {
+      std::ifstream cache_file {
+         path,
+         std::ios_base::in | std::ios_base::binary
+      };
+
+      if (!cache_file.is_open())
+         return false;
+
+      const std::vector< uint8_t > data {
+         std::istreambuf_iterator< char > { cache_file },
+         std::istreambuf_iterator< char > { }
+      };
+
+      if (data.size() < sizeof(CACHE_MAGIC) + sizeof(uint32_t) ||
+          std::memcmp(data.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0)
+      {
+         return false;
+      }
+
+      const size_t payload_size =
+         data.size() - sizeof(uint32_t);
+
+      CacheReader crc_reader {
+         data.data() + payload_size,
+         data.data() + data.size()
+      };
+
+      if (crc_reader.Get< uint32_t >() != Crc32(data.data(), payload_size))
+         return false;
+
+      CacheReader cache {
+         data.data() + sizeof(CACHE_MAGIC),
+         data.data() + payload_size
+      };
+
+      if (cache.Get< uint16_t >() != CACHE_VERSION)
+         return false;
+
+      DashboardModel model;
+
+      const auto GetStatistics =
+         [ & ] ( )
+         {
+            const auto count = cache.Get< uint64_t >();
+            const auto mean = cache.Get< double >();
+            const auto sum_of_squares = cache.Get< double >();
+
+            return
+               RunningStatistics {
+                  count,
+                  mean,
+                  sum_of_squares
+               };
+         };
+
+      for (auto students = cache.Get< uint32_t >(); students && !cache.Failed(); --students)
+      {
+         auto username = cache.GetString();
+
+         StudentAggregate student { };
+
+         student.response_time = GetStatistics();
+         student.retried_answers = cache.Get< uint64_t >();
+         student.last_answer_unix_ms = cache.Get< uint64_t >();
+         student.sessions = cache.Get< uint32_t >();
+
+         model.students_.emplace(
+            std::move(username),
+            student);
+      }
+
+      for (auto & fact : model.facts_)
+      {
+         fact.response_time = GetStatistics();
+         fact.retried_answers = cache.Get< uint64_t >();
+      }
+
+      for (auto journals = cache.Get< uint32_t >(); journals && !cache.Failed(); --journals)
+      {
+         auto name = cache.GetString();
+
+         JournalProgress journal { };
+
+         journal.offset = cache.Get< uint64_t >();
+         journal.records = cache.Get< uint64_t >();
+
+         model.journal_offsets_.emplace(
+            std::move(name),
+            journal);
+      }
+
+      for (auto session_files = cache.Get< uint32_t >(); session_files && !cache.Failed(); --session_files)
+      {
+         model.session_files_.insert(
+            cache.GetString());
+      }
+
+      for (auto sessions = cache.Get< uint32_t >(); sessions && !cache.Failed(); --sessions)
+      {
+         auto session = cache.GetString();
+
+         model.session_answers_.emplace(
+            std::move(session),
+            cache.Get< uint64_t >());
+      }
+
+      if (cache.Failed())
+         return false;
+
+      *this = std::move(model);
+
+      return true;
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+void DashboardModel::Fold(
+   StudentAggregate & student,
+   const uint16_t fact_id,
+   const uint32_t response_time_ms,
+   const uint32_t number_of_responses,
+   const uint64_t answered_unix_ms ) noexcept
+{
+   const bool retried =
+      number_of_responses > 1;
+
+   student.response_time.Add(
+      response_time_ms);
+   student.retried_answers += retried;
+   student.last_answer_unix_ms =
+      std::max(
+         student.last_answer_unix_ms,
+         answered_unix_ms);
+
+   if (fact_id < facts_.size())
+   {
+      auto & fact =
+         facts_[fact_id];
+
+      fact.response_time.Add(
+         response_time_ms);
+      fact.retried_answers += retried;
+   }
+}
+
+uint64_t & DashboardModel::SessionAnswers(
+   StudentAggregate & student,
+   const std::string_view username,
+   const uint64_t session_start_unix_ms )
+{
+   const auto [answers, inserted] =
+      session_answers_.try_emplace(
+         SessionKey(username, session_start_unix_ms),
+         0);
+
+   if (inserted)
+   {
+      ++student.sessions;
+   }
+
+   return
+      answers->second;
+}
+
+void DashboardModel::FoldJournal(
+   const std::filesystem::path & path,
+   const std::string & name,
+   const std::string_view username,
+   bool & changed )
+{
+   auto & journal =
+      journal_offsets_.try_emplace(
+         name,
+         JournalProgress { }).first->second;
+
+   auto & student =
+      students_.try_emplace(
+         std::string { username },
+         StudentAggregate { }).first->second;
+
+   std::error_code error;
+
+   const auto size =
+      std::filesystem::file_size(
+         path,
+         error);
+
+   if (error || size <= journal.offset)
+      return;
+
+   uint64_t session_start_unix_ms { };
+   std::vector< AnswerRecord > answers;
+
+   if (!AnswerJournal::ReadFrom(path, journal.offset, session_start_unix_ms, answers))
+      return;
+
+   auto & session_answers =
+      SessionAnswers(
+         student,
+         username,
+         session_start_unix_ms);
+
+   for (size_t i { }; i < answers.size(); ++i)
+   {
+      const uint64_t index =
+         journal.records + i;
+
+      if (index < session_answers)
+         continue;
+
+      const auto & answer =
+         answers[i];
+
+      Fold(
+         student,
+         answer.fact_id,
+         answer.response_time_ms,
+         static_cast< uint32_t >(answer.responses.size()),
+         session_start_unix_ms + answer.answered_at_ms);
+
+      session_answers = index + 1;
+      changed = true;
+   }
+
+   journal.records += answers.size();
+}
+
+void DashboardModel::FoldSessionFile(
+   const std::filesystem::path & path,
+   const std::string_view username,
+   bool & changed )
+{
+   SessionColumns columns;
+
+   if (!ReadSessionFile(path, columns))
+      return;
+
+   auto & student =
+      students_.try_emplace(
+         std::string { username },
+         StudentAggregate { }).first->second;
+
+   const uint64_t session_start_unix_ms =
+      columns.header.session_start_unix_ms;
+
+   auto & session_answers =
+      SessionAnswers(
+         student,
+         username,
+         session_start_unix_ms);
+
+   for (size_t i = session_answers; i < columns.fact_ids.size(); ++i)
+   {
+      Fold(
+         student,
+         columns.fact_ids[i],
+         columns.response_times_ms[i],
+         columns.attempt_counts[i],
+         session_start_unix_ms + columns.answered_at_ms[i]);
+
+      changed = true;
+   }
+
+   // the session is complete and is not seen again
+   session_answers_.erase(
+      SessionKey(username, session_start_unix_ms));
+}
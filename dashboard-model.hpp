@@ -0,0 +1,129 @@
+#ifndef _DASHBOARD_MODEL_HPP_
+#define _DASHBOARD_MODEL_HPP_
+
+#include "fact-id.hpp"
+#include "session-statistics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct StudentProgress
+{
+   std::string username;
+   uint32_t sessions;
+   // sessions with a journal, which are most likely still running
+   uint32_t active_sessions;
+   uint64_t answers;
+   double mean_response_time_ms;
+   double retry_rate;
+   uint64_t last_answer_unix_ms;
+};
+
+struct FactProgress
+{
+   uint16_t fact_id;
+   uint64_t answers;
+   double mean_response_time_ms;
+   double retry_rate;
+};
+
+struct DashboardSummary
+{
+   std::vector< StudentProgress > students;
+   std::vector< FactProgress > facts;
+};
+
+// class wide progress folded from the journals of running sessions and
+// the session files of finished ones.  every file is read only as far as
+// it has not been read before, so an update costs time proportional to
+// the answers added since the previous update, plus listing the
+// directory.  the state can be saved and loaded, so a restart does not
+// have to read the reports directory again.
+class DashboardModel
+{
+public:
+   DashboardModel( ) noexcept;
+
+   // returns true if any aggregate changed
+   bool Update(
+      const std::filesystem::path & reports_directory ) noexcept;
+
+   DashboardSummary Summarize( ) const;
+
+   // journals being watched for appended records
+   std::vector< std::filesystem::path > JournalPaths(
+      const std::filesystem::path & reports_directory ) const;
+
+   bool Save(
+      const std::filesystem::path & path ) const noexcept;
+   bool Load(
+      const std::filesystem::path & path ) noexcept;
+
+private:
+   struct StudentAggregate
+   {
+      RunningStatistics response_time;
+      uint64_t retried_answers;
+      uint64_t last_answer_unix_ms;
+      uint32_t sessions;
+      uint32_t active_sessions;
+   };
+
+   struct FactAggregate
+   {
+      RunningStatistics response_time;
+      uint64_t retried_answers;
+   };
+
+   struct JournalProgress
+   {
+      uint64_t offset;
+      uint64_t records;
+   };
+
+   void Fold(
+      StudentAggregate & student,
+      const uint16_t fact_id,
+      const uint32_t response_time_ms,
+      const uint32_t number_of_responses,
+      const uint64_t answered_unix_ms ) noexcept;
+
+   // the amount of answers of the session folded so far.  a session is
+   // first seen through its journal and then through its session file,
+   // which repeats the journaled answers in the same order.
+   uint64_t & SessionAnswers(
+      StudentAggregate & student,
+      const std::string_view username,
+      const uint64_t session_start_unix_ms );
+
+   void FoldJournal(
+      const std::filesystem::path & path,
+      const std::string & name,
+      const std::string_view username,
+      bool & changed );
+   void FoldSessionFile(
+      const std::filesystem::path & path,
+      const std::string_view username,
+      bool & changed );
+
+   std::map< std::string, StudentAggregate, std::less< > > students_;
+   std::vector< FactAggregate > facts_;
+
+   // journal file name to how far it has been read
+   std::map< std::string, JournalProgress, std::less< > > journal_offsets_;
+   // session files already folded
+   std::set< std::string, std::less< > > session_files_;
+   // "username/session start" to the amount of answers folded, for
+   // sessions whose session file has not been read yet
+   std::map< std::string, uint64_t, std::less< > > session_answers_;
+
+};
+
+#endif // _DASHBOARD_MODEL_HPP_
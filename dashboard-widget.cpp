@@ -0,0 +1,374 @@
+#include "dashboard-widget.hpp"
+#include "fact-id.hpp"
+#include "fact-operation.hpp"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QMetaObject>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/Qt>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVariant>
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QTableWidget>
+#include <QtWidgets/QTableWidgetItem>
+#include <QtWidgets/QTabWidget>
+#include <QtWidgets/QVBoxLayout>
+
+#include <cmath>
+#include <functional>
+#include <system_error>
+
+static QTableWidget * CreateTable(
+   const QStringList & headers,
+   QWidget * const parent )
+{
+   const auto table =
+      new QTableWidget { 0, static_cast< int >(headers.size()), parent };
+
+   table->setHorizontalHeaderLabels(
+      headers);
+   table->setEditTriggers(
+      QAbstractItemView::EditTrigger::NoEditTriggers);
+   table->setSelectionBehavior(
+      QAbstractItemView::SelectionBehavior::SelectRows);
+   table->verticalHeader()->setVisible(
+      false);
+   table->horizontalHeader()->setStretchLastSection(
+      true);
+
+   return
+      table;
+}
+
+// items hold the value itself so that columns sort numerically
+static QTableWidgetItem * CreateItem(
+   const QVariant & value )
+{
+   const auto item =
+      new QTableWidgetItem;
+
+   item->setData(
+      Qt::ItemDataRole::DisplayRole,
+      value);
+
+   return
+      item;
+}
+
+DashboardWidget::DashboardWidget(
+   const std::filesystem::path & reports_directory,
+   QWidget * const parent ) noexcept :
+QWidget { parent },
+reports_directory_ { reports_directory },
+cache_path_ { GetCachePath(reports_directory) },
+model_loaded_ { },
+update_running_ { },
+update_pending_ { },
+summary_shown_ { },
+status_label_ { nullptr },
+students_table_ { nullptr },
+facts_table_ { nullptr }
+{
+   setWindowTitle(
+      "Math Facts Dashboard");
+
+   status_label_ =
+      new QLabel { "Reading the reports directory...", this };
+
+   students_table_ =
+      CreateTable(
+         { "Student", "Sessions", "Practicing", "Answers",
+           "Mean Response ms", "Retry %", "Last Answer" },
+         this);
+
+   facts_table_ =
+      CreateTable(
+         { "Fact", "Operation", "Answers", "Mean Response ms", "Retry %" },
+         this);
+
+   const auto tabs =
+      new QTabWidget { this };
+
+   tabs->addTab(
+      students_table_,
+      "Students");
+   tabs->addTab(
+      facts_table_,
+      "Facts");
+
+   const auto layout =
+      new QVBoxLayout { this };
+
+   layout->addWidget(
+      status_label_);
+   layout->addWidget(
+      tabs);
+
+   std::error_code create_dir_error;
+
+   std::filesystem::create_directories(
+      reports_directory_,
+      create_dir_error);
+
+   watcher_.addPath(
+      QString::fromStdString(reports_directory_.string()));
+
+   change_timer_.setSingleShot(
+      true);
+   change_timer_.setInterval(
+      std::chrono::milliseconds { 250 });
+
+   QObject::connect(
+      &change_timer_,
+      &QTimer::timeout,
+      this,
+      &DashboardWidget::StartUpdate);
+
+   QObject::connect(
+      &watcher_,
+      &QFileSystemWatcher::directoryChanged,
+      &change_timer_,
+      qOverload< >(&QTimer::start));
+
+   QObject::connect(
+      &watcher_,
+      &QFileSystemWatcher::fileChanged,
+      &change_timer_,
+      qOverload< >(&QTimer::start));
+
+   QObject::connect(
+      &poll_timer_,
+      &QTimer::timeout,
+      this,
+      &DashboardWidget::StartUpdate);
+
+   poll_timer_.start(
+      std::chrono::seconds { 30 });
+
+   StartUpdate();
+}
+
+DashboardWidget::~DashboardWidget( ) noexcept
+{
+   // the update task must not outlive the widget it reports back to
+   update_pool_.waitForDone();
+
+   if (model_loaded_)
+   {
+      model_.Save(
+         cache_path_);
+   }
+}
+
+void DashboardWidget::StartUpdate( ) noexcept
+{
+   if (update_running_)
+   {
+      update_pending_ = true;
+
+      return;
+   }
+
+   update_running_ = true;
+
+   update_pool_.start(
+      [ this ] ( )
+      {
+         if (!model_loaded_)
+         {
+            // a missing or stale cache just means a cold start
+            model_.Load(
+               cache_path_);
+
+            model_loaded_ = true;
+         }
+
+         const bool changed =
+            model_.Update(
+               reports_directory_);
+
+         const auto now =
+            std::chrono::steady_clock::now();
+
+         if (changed &&
+             now - last_save_time_ >= std::chrono::seconds { 10 })
+         {
+            model_.Save(
+               cache_path_);
+
+            last_save_time_ = now;
+         }
+
+         const auto summary =
+            std::make_shared< const DashboardSummary >(
+               model_.Summarize());
+         const auto journals =
+            model_.JournalPaths(
+               reports_directory_);
+
+         QMetaObject::invokeMethod(
+            this,
+            [ this, summary, journals, changed ] ( )
+            {
+               OnModelUpdated(
+                  summary,
+                  journals,
+                  changed);
+            },
+            Qt::ConnectionType::QueuedConnection);
+      });
+}
+
+void DashboardWidget::OnModelUpdated(
+   const std::shared_ptr< const DashboardSummary > & summary,
+   const std::vector< std::filesystem::path > & journals,
+   const bool changed ) noexcept
+{
+   update_running_ = false;
+
+   if (changed || !summary_shown_)
+   {
+      ShowSummary(
+         *summary);
+
+      summary_shown_ = true;
+   }
+
+   // appending to a journal does not change the directory, so the
+   // journals of running sessions are watched on their own
+   QStringList journal_paths;
+
+   for (const auto & journal : journals)
+   {
+      journal_paths.push_back(
+         QString::fromStdString(journal.string()));
+   }
+
+   for (const auto & watched : watcher_.files())
+   {
+      if (!journal_paths.contains(watched))
+      {
+         watcher_.removePath(
+            watched);
+      }
+   }
+
+   for (const auto & journal_path : journal_paths)
+   {
+      if (!watcher_.files().contains(journal_path))
+      {
+         watcher_.addPath(
+            journal_path);
+      }
+   }
+
+   if (update_pending_)
+   {
+      update_pending_ = false;
+
+      StartUpdate();
+   }
+}
+
+void DashboardWidget::ShowSummary(
+   const DashboardSummary & summary ) noexcept
+{
+   uint64_t total_answers { };
+   uint32_t practicing { };
+
+   students_table_->setSortingEnabled(
+      false);
+   students_table_->setRowCount(
+      static_cast< int >(summary.students.size()));
+
+   for (int row { }; row < static_cast< int >(summary.students.size()); ++row)
+   {
+      const auto & student =
+         summary.students[row];
+
+      total_answers += student.answers;
+      practicing += student.active_sessions != 0;
+
+      students_table_->setItem(
+         row, 0, CreateItem(QString::fromStdString(student.username)));
+      students_table_->setItem(
+         row, 1, CreateItem(student.sessions));
+      students_table_->setItem(
+         row, 2, CreateItem(student.active_sessions ? "yes" : ""));
+      students_table_->setItem(
+         row, 3, CreateItem(static_cast< qulonglong >(student.answers)));
+      students_table_->setItem(
+         row, 4, CreateItem(static_cast< qlonglong >(std::llround(student.mean_response_time_ms))));
+      students_table_->setItem(
+         row, 5, CreateItem(std::round(student.retry_rate * 1000.0) / 10.0));
+      students_table_->setItem(
+         row, 6, CreateItem(
+            QDateTime::fromMSecsSinceEpoch(
+               static_cast< qint64 >(student.last_answer_unix_ms)).toString(
+                  "yyyy-MM-dd hh:mm")));
+   }
+
+   students_table_->setSortingEnabled(
+      true);
+
+   facts_table_->setSortingEnabled(
+      false);
+   facts_table_->setRowCount(
+      static_cast< int >(summary.facts.size()));
+
+   for (int row { }; row < static_cast< int >(summary.facts.size()); ++row)
+   {
+      const auto & fact =
+         summary.facts[row];
+
+      facts_table_->setItem(
+         row, 0, CreateItem(QString::fromStdString(FormatFact(fact.fact_id))));
+      facts_table_->setItem(
+         row, 1, CreateItem(FactOperationName(FactIdOperation(fact.fact_id))));
+      facts_table_->setItem(
+         row, 2, CreateItem(static_cast< qulonglong >(fact.answers)));
+      facts_table_->setItem(
+         row, 3, CreateItem(static_cast< qlonglong >(std::llround(fact.mean_response_time_ms))));
+      facts_table_->setItem(
+         row, 4, CreateItem(std::round(fact.retry_rate * 1000.0) / 10.0));
+   }
+
+   facts_table_->setSortingEnabled(
+      true);
+
+   status_label_->setText(
+      QString { "%1 students, %2 practicing now, %3 answers; updated %4" }
+         .arg(summary.students.size())
+         .arg(practicing)
+         .arg(total_answers)
+         .arg(QDateTime::currentDateTime().toString("hh:mm:ss")));
+}
+
+std::filesystem::path DashboardWidget::GetCachePath(
+   const std::filesystem::path & reports_directory ) noexcept
+{
+   std::error_code error;
+
+   const auto absolute_directory =
+      std::filesystem::absolute(
+         reports_directory,
+         error);
+
+   // one cache per reports directory
+   const size_t directory_hash =
+      std::hash< std::string > { }(
+         absolute_directory.lexically_normal().string());
+
+   const std::filesystem::path cache_directory =
+      QStandardPaths::writableLocation(
+         QStandardPaths::StandardLocation::CacheLocation).toStdString();
+
+   return
+      cache_directory /
+      ("dashboard-" +
+       QString::number(directory_hash, 16).toStdString() +
+       ".cache");
+}
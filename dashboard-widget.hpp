@@ -0,0 +1,70 @@
+#ifndef _DASHBOARD_WIDGET_HPP_
+#define _DASHBOARD_WIDGET_HPP_
+
+#include "dashboard-model.hpp"
+
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+#include <QtWidgets/QWidget>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+class QLabel;
+class QTableWidget;
+
+// class wide progress for teachers, shown instead of the practice widget
+// when started with --dashboard.  the reports directory and the journals
+// of running sessions are watched, and every change folds only the new
+// answers into the model on a background task.
+class DashboardWidget :
+   public QWidget
+{
+public:
+   DashboardWidget(
+      const std::filesystem::path & reports_directory,
+      QWidget * const parent ) noexcept;
+   virtual ~DashboardWidget( ) noexcept;
+
+private:
+   void StartUpdate( ) noexcept;
+   void OnModelUpdated(
+      const std::shared_ptr< const DashboardSummary > & summary,
+      const std::vector< std::filesystem::path > & journals,
+      const bool changed ) noexcept;
+   void ShowSummary(
+      const DashboardSummary & summary ) noexcept;
+
+   static std::filesystem::path GetCachePath(
+      const std::filesystem::path & reports_directory ) noexcept;
+
+   std::filesystem::path reports_directory_;
+   std::filesystem::path cache_path_;
+
+   // only used by the update task, of which there is at most one
+   DashboardModel model_;
+   bool model_loaded_;
+   std::chrono::steady_clock::time_point last_save_time_;
+   // runs the update task only, so that destroying the widget waits for
+   // nothing else
+   QThreadPool update_pool_;
+
+   QFileSystemWatcher watcher_;
+   // coalesces bursts of change notifications
+   QTimer change_timer_;
+   // network shares often do not report changes
+   QTimer poll_timer_;
+   bool update_running_;
+   bool update_pending_;
+   bool summary_shown_;
+
+   QLabel * status_label_;
+   QTableWidget * students_table_;
+   QTableWidget * facts_table_;
+
+};
+
+#endif // _DASHBOARD_WIDGET_HPP_
@@ -0,0 +1,111 @@
+#include "durable-file.hpp"
+
+#include <system_error>
+
+#if _WIN32
+#  define NOMINMAX
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif // _WIN32
+
+namespace
+{
+
+bool SyncFile(
+   const std::filesystem::path & path ) noexcept
+{
+#if _WIN32
+   const HANDLE file =
+      CreateFileW(
+         path.c_str(),
+         GENERIC_WRITE,
+         FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+         nullptr,
+         OPEN_EXISTING,
+         FILE_ATTRIBUTE_NORMAL,
+         nullptr);
+
+   if (file == INVALID_HANDLE_VALUE)
+      return false;
+
+   const bool synced =
+      FlushFileBuffers(file) != 0;
+
+   CloseHandle(
+      file);
+#else
+   const int descriptor =
+      ::open(
+         path.c_str(),
+         O_RDONLY | O_CLOEXEC);
+
+   if (descriptor < 0)
+      return false;
+
+   const bool synced =
+      ::fsync(descriptor) == 0;
+
+   ::close(
+      descriptor);
+#endif // _WIN32
+
+   return
+      synced;
+}
+
+// a rename is an update of its directory.  ntfs journals it on its own,
+// and windows cannot open a directory for flushing anyway.
+void SyncDirectory(
+   const std::filesystem::path & directory ) noexcept
+{
+#if !_WIN32
+   const int descriptor =
+      ::open(
+         directory.empty() ?
+            "." :
+            directory.c_str(),
+         O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+   if (descriptor < 0)
+      return;
+
+   ::fsync(
+      descriptor);
+   ::close(
+      descriptor);
+#endif // !_WIN32
+}
+
+} // namespace
+
+bool CommitTemporaryFile(
+   const std::filesystem::path & temporary_path,
+   const std::filesystem::path & path ) noexcept
+{
+   std::error_code error;
+
+   if (SyncFile(temporary_path))
+   {
+      std::filesystem::rename(
+         temporary_path,
+         path,
+         error);
+
+      if (!error)
+      {
+         SyncDirectory(
+            path.parent_path());
+
+         return true;
+      }
+   }
+
+   std::filesystem::remove(
+      temporary_path,
+      error);
+
+   return false;
+}
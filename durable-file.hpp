@@ -0,0 +1,14 @@
+#ifndef _DURABLE_FILE_HPP_
+#define _DURABLE_FILE_HPP_
+
+#include <filesystem>
+
+// moves a written and closed temporary file over the destination, so that
+// after a power cut either the old file or the whole new one is found:
+// the contents reach the disk before the rename, and the rename before
+// this returns.  the temporary file is removed if it cannot be moved.
+bool CommitTemporaryFile(
+   const std::filesystem::path & temporary_path,
+   const std::filesystem::path & path ) noexcept;
+
+#endif // _DURABLE_FILE_HPP_
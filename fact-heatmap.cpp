@@ -0,0 +1,490 @@
+#include "fact-heatmap.hpp"
+#include "fact-operation.hpp"
+
+#include <QtCore/QPointF>
+#include <QtCore/QSize>
+#include <QtCore/Qt>
+#include <QtGui/QBrush>
+#include <QtGui/QFont>
+#include <QtGui/QPaintDevice>
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+#include <QtGui/QPen>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// tiles of every grid, plus a header row and column and a title row
+constexpr int GRID_COLUMNS { ARITHMETIC_FACT_OPERANDS + 1 };
+constexpr int GRID_ROWS { ARITHMETIC_FACT_OPERANDS + 2 };
+
+// response times are colored from green at FAST_MS to red at SLOW_MS
+constexpr double FAST_MS { 1000.0 };
+constexpr double SLOW_MS { 10000.0 };
+
+QColor TileColor(
+   const double mean_response_time_ms ) noexcept
+{
+   const double slowness =
+      std::clamp(
+         std::log(std::max(mean_response_time_ms, 1.0) / FAST_MS) /
+            std::log(SLOW_MS / FAST_MS),
+         0.0,
+         1.0);
+
+   return
+      QColor::fromHsvF(
+         (1.0 - slowness) / 3.0,
+         0.6,
+         0.95);
+}
+
+} // namespace
+
+FactHeatmap::FactHeatmap( ) noexcept :
+cells_ ( FACT_ID_COUNT ),
+is_dirty_ ( FACT_ID_COUNT ),
+tile_size_ { },
+device_pixel_ratio_ { 1.0 },
+visible_grids_ { }
+{
+   for (size_t operation { }; operation < FACT_OPERATION_COUNT - 1; ++operation)
+   {
+      auto & grid =
+         grids_[operation];
+
+      grid.title =
+         FactOperationName(
+            static_cast< FactOperation >(operation));
+      grid.first_fact_id =
+         static_cast< uint16_t >(
+            operation * ARITHMETIC_FACT_OPERANDS * ARITHMETIC_FACT_OPERANDS);
+      grid.size =
+         ARITHMETIC_FACT_OPERANDS;
+
+      for (int i { }; i < ARITHMETIC_FACT_OPERANDS; ++i)
+      {
+         grid.row_labels[i] = QString::number(i);
+         grid.column_labels[i] = QString::number(i);
+      }
+   }
+
+   const char * const TIME_TITLES[] {
+      "clock",
+      "military morning",
+      "military afternoon"
+   };
+
+   for (size_t kind { }; kind < 3; ++kind)
+   {
+      auto & grid =
+         grids_[FACT_OPERATION_COUNT - 1 + kind];
+
+      grid.title =
+         TIME_TITLES[kind];
+      grid.first_fact_id =
+         static_cast< uint16_t >(
+            ARITHMETIC_FACT_COUNT + kind * TIME_FACTS_PER_KIND);
+      grid.size =
+         12;
+
+      for (int i { }; i < 12; ++i)
+      {
+         const int hour { i + 1 };
+
+         grid.row_labels[i] =
+            QString::number(
+               kind == 0 ? hour :
+               kind == 1 ? hour % 12 :
+               hour == 12 ? 12 : hour + 12);
+         grid.column_labels[i] =
+            QString { ":%1" }.arg(i * 5, 2, 10, QChar { '0' });
+      }
+   }
+}
+
+void FactHeatmap::Add(
+   const uint16_t fact_id,
+   const std::chrono::milliseconds response_time,
+   const size_t number_of_responses ) noexcept
+{
+   if (fact_id >= FACT_ID_COUNT)
+      return;
+
+   auto & cell =
+      cells_[fact_id];
+
+   ++cell.answers;
+   cell.retried_answers += number_of_responses > 1;
+   cell.response_time_ms += static_cast< uint64_t >(response_time.count());
+
+   auto & grid =
+      grids_[GridOf(fact_id)];
+
+   if (grid.answers++ == 0)
+   {
+      // a grid appears, so every grid moves
+      tile_size_ = 0;
+   }
+   else if (!is_dirty_[fact_id])
+   {
+      is_dirty_[fact_id] = true;
+      dirty_facts_.push_back(fact_id);
+   }
+}
+
+bool FactHeatmap::IsEmpty( ) const noexcept
+{
+   return
+      std::none_of(
+         grids_.begin(),
+         grids_.end(),
+         [ ] (
+            const Grid & grid )
+         {
+            return
+               grid.answers != 0;
+         });
+}
+
+size_t FactHeatmap::CacheBytes( ) const noexcept
+{
+   size_t bytes { };
+
+   for (const auto & grid : grids_)
+   {
+      bytes +=
+         static_cast< size_t >(grid.canvas.width()) *
+         static_cast< size_t >(grid.canvas.height()) *
+         static_cast< size_t >(grid.canvas.depth()) / 8;
+   }
+
+   return
+      bytes;
+}
+
+void FactHeatmap::Paint(
+   QPainter & painter,
+   const QRectF & area,
+   const QColor & text_color ) noexcept
+{
+   const qreal device_pixel_ratio =
+      painter.device()->devicePixelRatioF();
+
+   if (tile_size_ == 0 ||
+       area != area_ ||
+       text_color != text_color_ ||
+       device_pixel_ratio != device_pixel_ratio_)
+   {
+      area_ = area;
+      text_color_ = text_color;
+
+      Layout(
+         area,
+         device_pixel_ratio);
+   }
+   else
+   {
+      for (const uint16_t fact_id : dirty_facts_)
+      {
+         auto & grid =
+            grids_[GridOf(fact_id)];
+
+         QPainter canvas_painter {
+            &grid.canvas
+         };
+
+         RedrawTile(
+            canvas_painter,
+            grid,
+            fact_id);
+      }
+   }
+
+   for (const uint16_t fact_id : dirty_facts_)
+   {
+      is_dirty_[fact_id] = false;
+   }
+
+   dirty_facts_.clear();
+
+   if (tile_size_ == 0)
+      return;
+
+   for (size_t i { }; i < grids_.size(); ++i)
+   {
+      if (grids_[i].answers)
+      {
+         painter.drawPixmap(
+            grid_rects_[i].topLeft(),
+            grids_[i].canvas);
+      }
+   }
+}
+
+size_t FactHeatmap::GridOf(
+   const uint16_t fact_id ) const noexcept
+{
+   return
+      fact_id < ARITHMETIC_FACT_COUNT ?
+         fact_id / (ARITHMETIC_FACT_OPERANDS * ARITHMETIC_FACT_OPERANDS) :
+         FACT_OPERATION_COUNT - 1 + (fact_id - ARITHMETIC_FACT_COUNT) / TIME_FACTS_PER_KIND;
+}
+
+void FactHeatmap::Layout(
+   const QRectF & area,
+   const qreal device_pixel_ratio ) noexcept
+{
+   device_pixel_ratio_ = device_pixel_ratio;
+   tile_size_ = 0;
+
+   visible_grids_ =
+      std::count_if(
+         grids_.begin(),
+         grids_.end(),
+         [ ] (
+            const Grid & grid )
+         {
+            return
+               grid.answers != 0;
+         });
+
+   if (visible_grids_ == 0)
+      return;
+
+   // the arrangement of grids with the largest tiles, one tile apart
+   int columns { 1 };
+
+   for (int candidate_columns { 1 }; candidate_columns <= static_cast< int >(visible_grids_); ++candidate_columns)
+   {
+      const int candidate_rows =
+         (static_cast< int >(visible_grids_) + candidate_columns - 1) / candidate_columns;
+
+      const int tile_size =
+         static_cast< int >(
+            std::min(
+               area.width() / (candidate_columns * (GRID_COLUMNS + 1) - 1),
+               area.height() / (candidate_rows * (GRID_ROWS + 1) - 1)));
+
+      if (tile_size > tile_size_)
+      {
+         tile_size_ = tile_size;
+         columns = candidate_columns;
+      }
+   }
+
+   if (tile_size_ < 4)
+   {
+      tile_size_ = 0;
+
+      return;
+   }
+
+   const int rows =
+      (static_cast< int >(visible_grids_) + columns - 1) / columns;
+   const int used_columns =
+      std::min(columns, static_cast< int >(visible_grids_));
+
+   const QPointF origin {
+      std::round(area.center().x() - (used_columns * (GRID_COLUMNS + 1) - 1) * tile_size_ / 2.0),
+      std::round(area.center().y() - (rows * (GRID_ROWS + 1) - 1) * tile_size_ / 2.0)
+   };
+
+   size_t position { };
+
+   for (size_t i { }; i < grids_.size(); ++i)
+   {
+      auto & grid =
+         grids_[i];
+
+      if (!grid.answers)
+      {
+         grid.canvas = QPixmap { };
+
+         continue;
+      }
+
+      const int column = static_cast< int >(position % columns);
+      const int row = static_cast< int >(position / columns);
+
+      grid_rects_[i] =
+         QRectF {
+            origin.x() + column * (GRID_COLUMNS + 1) * tile_size_,
+            origin.y() + row * (GRID_ROWS + 1) * tile_size_,
+            static_cast< qreal >(GRID_COLUMNS * tile_size_),
+            static_cast< qreal >(GRID_ROWS * tile_size_)
+         };
+
+      RedrawCanvas(
+         grid);
+
+      ++position;
+   }
+}
+
+void FactHeatmap::RedrawCanvas(
+   Grid & grid ) noexcept
+{
+   grid.canvas =
+      QPixmap {
+         QSize { GRID_COLUMNS * tile_size_, GRID_ROWS * tile_size_ } *
+         device_pixel_ratio_
+      };
+
+   grid.canvas.setDevicePixelRatio(
+      device_pixel_ratio_);
+   grid.canvas.fill(
+      Qt::GlobalColor::transparent);
+
+   QPainter painter {
+      &grid.canvas
+   };
+
+   painter.setRenderHint(
+      QPainter::RenderHint::TextAntialiasing,
+      true);
+
+   QFont font {
+      painter.font()
+   };
+
+   font.setPixelSize(
+      std::max(6, tile_size_ * 3 / 4));
+   font.setBold(
+      true);
+
+   painter.setFont(
+      font);
+   painter.setPen(
+      text_color_);
+
+   painter.drawText(
+      QRectF {
+         0.0, 0.0,
+         static_cast< qreal >(GRID_COLUMNS * tile_size_),
+         static_cast< qreal >(tile_size_) },
+      Qt::AlignmentFlag::AlignLeft | Qt::AlignmentFlag::AlignVCenter,
+      grid.title);
+
+   font.setPixelSize(
+      std::max(5, tile_size_ * 2 / 5));
+   font.setBold(
+      false);
+
+   painter.setFont(
+      font);
+
+   for (int i { }; i < grid.size; ++i)
+   {
+      painter.drawText(
+         QRectF {
+            0.0,
+            static_cast< qreal >((i + 2) * tile_size_),
+            static_cast< qreal >(tile_size_),
+            static_cast< qreal >(tile_size_) },
+         Qt::AlignmentFlag::AlignCenter,
+         grid.row_labels[i]);
+
+      painter.drawText(
+         QRectF {
+            static_cast< qreal >((i + 1) * tile_size_),
+            static_cast< qreal >(tile_size_),
+            static_cast< qreal >(tile_size_),
+            static_cast< qreal >(tile_size_) },
+         Qt::AlignmentFlag::AlignCenter,
+         grid.column_labels[i]);
+   }
+
+   for (uint16_t fact_id { grid.first_fact_id };
+        fact_id < grid.first_fact_id + grid.size * grid.size;
+        ++fact_id)
+   {
+      RedrawTile(
+         painter,
+         grid,
+         fact_id);
+   }
+}
+
+void FactHeatmap::RedrawTile(
+   QPainter & painter,
+   const Grid & grid,
+   const uint16_t fact_id ) const noexcept
+{
+   const auto & cell =
+      cells_[fact_id];
+
+   const int tile = fact_id - grid.first_fact_id;
+   const int row = tile / grid.size;
+   const int column = tile % grid.size;
+
+   const QRectF tile_rect {
+      static_cast< qreal >((column + 1) * tile_size_ + 1),
+      static_cast< qreal >((row + 2) * tile_size_ + 1),
+      static_cast< qreal >(tile_size_ - 2),
+      static_cast< qreal >(tile_size_ - 2)
+   };
+
+   const double mean_response_time_ms =
+      cell.answers ?
+         static_cast< double >(cell.response_time_ms) / cell.answers :
+         0.0;
+
+   // replaces whatever the tile showed before
+   painter.setCompositionMode(
+      QPainter::CompositionMode::CompositionMode_Source);
+   painter.fillRect(
+      tile_rect,
+      cell.answers ?
+         TileColor(mean_response_time_ms) :
+         QColor { 255, 255, 255, 80 });
+   painter.setCompositionMode(
+      QPainter::CompositionMode::CompositionMode_SourceOver);
+
+   if (!cell.answers)
+      return;
+
+   if (cell.retried_answers)
+   {
+      const qreal corner =
+         tile_rect.width() / 3.0;
+
+      QPainterPath retried_mark;
+
+      retried_mark.moveTo(tile_rect.topRight());
+      retried_mark.lineTo(tile_rect.topRight() - QPointF { corner, 0.0 });
+      retried_mark.lineTo(tile_rect.topRight() + QPointF { 0.0, corner });
+      retried_mark.closeSubpath();
+
+      painter.fillPath(
+         retried_mark,
+         text_color_);
+   }
+
+   // seconds are only readable on reasonably large tiles
+   if (tile_size_ >= 20)
+   {
+      QFont font {
+         painter.font()
+      };
+
+      font.setPixelSize(
+         std::max(6, tile_size_ * 2 / 5));
+
+      painter.setFont(
+         font);
+      painter.setPen(
+         text_color_);
+
+      painter.drawText(
+         tile_rect,
+         Qt::AlignmentFlag::AlignCenter,
+         QString::number(
+            mean_response_time_ms / 1000.0,
+            'f',
+            1));
+   }
+}
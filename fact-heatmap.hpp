@@ -0,0 +1,92 @@
+#ifndef _FACT_HEATMAP_HPP_
+#define _FACT_HEATMAP_HPP_
+
+#include "fact-id.hpp"
+
+#include <QtCore/QRectF>
+#include <QtCore/QString>
+#include <QtGui/QColor>
+#include <QtGui/QPixmap>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class QPainter;
+
+// mean response time and retries of every fact answered in the session,
+// drawn as a 13 x 13 grid per operation and a 12 x 12 grid per kind of
+// time fact.  each grid is a cached canvas of tiles, one tile per fact;
+// a paint only redraws the tiles whose statistics changed since the
+// previous paint, or every tile once the size or colors change.
+class FactHeatmap
+{
+public:
+   FactHeatmap( ) noexcept;
+
+   void Add(
+      const uint16_t fact_id,
+      const std::chrono::milliseconds response_time,
+      const size_t number_of_responses ) noexcept;
+
+   bool IsEmpty( ) const noexcept;
+   // memory held by the cached canvases
+   size_t CacheBytes( ) const noexcept;
+
+   // only grids with answers are shown
+   void Paint(
+      QPainter & painter,
+      const QRectF & area,
+      const QColor & text_color ) noexcept;
+
+private:
+   struct Cell
+   {
+      uint32_t answers;
+      uint32_t retried_answers;
+      uint64_t response_time_ms;
+   };
+
+   struct Grid
+   {
+      QString title;
+      QString row_labels[13];
+      QString column_labels[13];
+      uint16_t first_fact_id;
+      uint16_t size;
+      uint32_t answers;
+      QPixmap canvas;
+   };
+
+   static constexpr size_t GRID_COUNT { FACT_OPERATION_COUNT - 1 + 3 };
+
+   size_t GridOf(
+      const uint16_t fact_id ) const noexcept;
+   void Layout(
+      const QRectF & area,
+      const qreal device_pixel_ratio ) noexcept;
+   void RedrawCanvas(
+      Grid & grid ) noexcept;
+   void RedrawTile(
+      QPainter & painter,
+      const Grid & grid,
+      const uint16_t fact_id ) const noexcept;
+
+   std::vector< Cell > cells_;
+   std::vector< uint16_t > dirty_facts_;
+   std::vector< bool > is_dirty_;
+
+   std::array< Grid, GRID_COUNT > grids_;
+   std::array< QRectF, GRID_COUNT > grid_rects_;
+
+   QRectF area_;
+   int tile_size_;
+   qreal device_pixel_ratio_;
+   QColor text_color_;
+   size_t visible_grids_;
+
+};
+
+#endif // _FACT_HEATMAP_HPP_
@@ -0,0 +1,214 @@
+#ifndef _FACT_ID_HPP_
+#define _FACT_ID_HPP_
+
+#include "fact-operation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// every fact that can be practiced has a stable numeric id
+//    0 -  675: arithmetic; operation * 169 + left * 13 + right
+//              left / right are the operands, except for division
+//              where left is the quotient and right the divisor
+//  676 - 1107: time; 676 + kind * 144 + (hour - 1) * 12 + minute / 5
+//              kind 0 is a clock, 1 is military morning, 2 is military afternoon
+constexpr uint16_t ARITHMETIC_FACT_OPERANDS { 13 };
+constexpr uint16_t ARITHMETIC_FACT_COUNT { 4 * ARITHMETIC_FACT_OPERANDS * ARITHMETIC_FACT_OPERANDS };
+constexpr uint16_t TIME_FACTS_PER_KIND { 12 * 12 };
+constexpr uint16_t TIME_FACT_COUNT { 3 * TIME_FACTS_PER_KIND };
+constexpr uint16_t FACT_ID_COUNT { ARITHMETIC_FACT_COUNT + TIME_FACT_COUNT };
+
+enum class TimeFactKind : uint8_t
+{
+   CLOCK,
+   MILITARY_MORNING,
+   MILITARY_AFTERNOON
+};
+
+constexpr uint16_t ArithmeticFactId(
+   const FactOperation operation,
+   const int32_t top,
+   const int32_t bottom ) noexcept
+{
+   const int32_t left =
+      operation == FactOperation::DIV ?
+         (bottom != 0 ? top / bottom : 0) :
+         top;
+
+   return
+      static_cast< uint16_t >(
+         static_cast< int32_t >(operation) *
+            ARITHMETIC_FACT_OPERANDS * ARITHMETIC_FACT_OPERANDS +
+         left * ARITHMETIC_FACT_OPERANDS +
+         bottom);
+}
+
+constexpr uint16_t TimeFactId(
+   const TimeFactKind kind,
+   const uint8_t hour,
+   const uint8_t minute ) noexcept
+{
+   return
+      static_cast< uint16_t >(
+         ARITHMETIC_FACT_COUNT +
+         static_cast< uint16_t >(kind) * TIME_FACTS_PER_KIND +
+         (hour - 1) * 12 +
+         minute / 5);
+}
+
+constexpr FactOperation FactIdOperation(
+   const uint16_t fact_id ) noexcept
+{
+   return
+      fact_id < ARITHMETIC_FACT_COUNT ?
+         static_cast< FactOperation >(
+            fact_id / (ARITHMETIC_FACT_OPERANDS * ARITHMETIC_FACT_OPERANDS)) :
+         FactOperation::TIME;
+}
+
+constexpr size_t MAX_TIME_RESPONSE_SIZE { 5 };
+
+// time responses are stored as integers by packing up to five digits and
+// colons as base 12 digits, least significant first; 0 terminates the
+// response, 1 - 10 are '0' - '9' and 11 is ':'
+constexpr int32_t EncodeTimeResponse(
+   const std::string_view response ) noexcept
+{
+   int32_t encoded { };
+   int32_t place { 1 };
+
+   for (size_t i { }; i < response.size() && i < MAX_TIME_RESPONSE_SIZE; ++i)
+   {
+      const char c = response[i];
+
+      const int32_t digit =
+         c == ':' ?
+            11 :
+            c >= '0' && c <= '9' ?
+               c - '0' + 1 :
+               0;
+
+      if (digit == 0)
+         break;
+
+      encoded += digit * place;
+      place *= 12;
+   }
+
+   return
+      encoded;
+}
+
+// writes at most MAX_TIME_RESPONSE_SIZE characters and returns the amount
+constexpr size_t DecodeTimeResponse(
+   int32_t encoded,
+   char * const characters ) noexcept
+{
+   size_t size { };
+
+   while (encoded > 0 && size < MAX_TIME_RESPONSE_SIZE)
+   {
+      const int32_t digit = encoded % 12;
+
+      if (digit == 0)
+         break;
+
+      characters[size++] =
+         digit == 11 ?
+            ':' :
+            static_cast< char >('0' + digit - 1);
+
+      encoded /= 12;
+   }
+
+   return
+      size;
+}
+
+inline std::string DecodeTimeResponse(
+   const int32_t encoded )
+{
+   char characters[MAX_TIME_RESPONSE_SIZE] { };
+
+   return
+      std::string {
+         characters,
+         DecodeTimeResponse(encoded, characters)
+      };
+}
+
+inline std::string FormatResponse(
+   const FactOperation operation,
+   const int32_t response )
+{
+   return
+      operation == FactOperation::TIME ?
+         DecodeTimeResponse(response) :
+         std::to_string(response);
+}
+
+// human readable fact, such as "7 * 8" or "military 15:05"
+inline std::string FormatFact(
+   const uint16_t fact_id )
+{
+   if (fact_id >= FACT_ID_COUNT)
+      return "unknown";
+
+   if (fact_id < ARITHMETIC_FACT_COUNT)
+   {
+      constexpr char SYMBOLS[] { '+', '-', '*', '/' };
+
+      const uint16_t operation =
+         fact_id / (ARITHMETIC_FACT_OPERANDS * ARITHMETIC_FACT_OPERANDS);
+      const uint16_t left =
+         fact_id / ARITHMETIC_FACT_OPERANDS % ARITHMETIC_FACT_OPERANDS;
+      const uint16_t right =
+         fact_id % ARITHMETIC_FACT_OPERANDS;
+
+      const uint16_t top =
+         static_cast< FactOperation >(operation) == FactOperation::DIV ?
+            left * right :
+            left;
+
+      return
+         std::to_string(top) +
+         " " +
+         SYMBOLS[operation] +
+         " " +
+         std::to_string(right);
+   }
+
+   const uint16_t time_fact =
+      fact_id - ARITHMETIC_FACT_COUNT;
+   const auto kind =
+      static_cast< TimeFactKind >(time_fact / TIME_FACTS_PER_KIND);
+
+   int32_t hour =
+      time_fact % TIME_FACTS_PER_KIND / 12 + 1;
+   const int32_t minute =
+      time_fact % 12 * 5;
+
+   if (kind == TimeFactKind::MILITARY_MORNING && hour == 12)
+      hour = 0;
+   else if (kind == TimeFactKind::MILITARY_AFTERNOON && hour != 12)
+      hour += 12;
+
+   std::string time =
+      kind == TimeFactKind::CLOCK ?
+         "clock " :
+         "military ";
+
+   if (kind != TimeFactKind::CLOCK && hour < 10)
+      time += '0';
+
+   time += std::to_string(hour);
+   time += minute < 10 ? ":0" : ":";
+   time += std::to_string(minute);
+
+   return
+      time;
+}
+
+#endif // _FACT_ID_HPP_
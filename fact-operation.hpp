@@ -0,0 +1,34 @@
+#ifndef _FACT_OPERATION_HPP_
+#define _FACT_OPERATION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+enum class FactOperation : uint8_t
+{
+   ADD,
+   SUB,
+   MUL,
+   DIV,
+   TIME
+};
+
+constexpr size_t FACT_OPERATION_COUNT { 5 };
+
+constexpr const char * FactOperationName(
+   const FactOperation operation ) noexcept
+{
+   switch (operation)
+   {
+   case FactOperation::ADD: return "addition";
+   case FactOperation::SUB: return "subtraction";
+   case FactOperation::MUL: return "multiplication";
+   case FactOperation::DIV: return "division";
+   case FactOperation::TIME: return "time";
+   }
+
+   return
+      "unknown";
+}
+
+#endif // _FACT_OPERATION_HPP_
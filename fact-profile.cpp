@@ -0,0 +1,416 @@
+#include "fact-profile.hpp"
+#include "fact-id.hpp"
+#include "session-format.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <system_error>
+
+#if _WIN32
+#  define NOMINMAX
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif // _WIN32
+
+namespace
+{
+
+constexpr char PROFILE_MAGIC[4] { 'M', 'F', 'F', 'P' };
+
+// generations wrap around, so the newer of two is found with serial
+// number arithmetic
+bool IsNewer(
+   const uint32_t generation,
+   const uint32_t other_generation ) noexcept
+{
+   return
+      static_cast< int32_t >(generation - other_generation) > 0;
+}
+
+} // namespace
+
+FactProfile::FactProfile( ) noexcept :
+data_ { },
+size_ { }
+#if _WIN32
+, mapping_ { }
+#endif // _WIN32
+{
+}
+
+FactProfile::~FactProfile( ) noexcept
+{
+   Close();
+}
+
+bool FactProfile::Open(
+   const std::filesystem::path & path ) noexcept
+{
+   Close();
+
+   const size_t required_size =
+      sizeof(FactProfileHeader) +
+      FACT_ID_COUNT * sizeof(FactProfileRecord);
+
+   std::error_code error;
+
+   if (!std::filesystem::exists(path, error))
+   {
+      std::ofstream {
+         path,
+         std::ios_base::out | std::ios_base::binary
+      };
+   }
+
+   const auto file_size =
+      std::filesystem::file_size(
+         path,
+         error);
+
+   if (error)
+      return false;
+
+   FactProfileHeader header { };
+
+   if (file_size >= sizeof(header))
+   {
+      std::ifstream {
+         path,
+         std::ios_base::in | std::ios_base::binary
+      }.read(
+         reinterpret_cast< char * >(&header),
+         sizeof(header));
+   }
+
+   const bool magic_matches =
+      std::memcmp(
+         header.magic,
+         PROFILE_MAGIC,
+         sizeof(PROFILE_MAGIC)) == 0;
+
+   if (magic_matches && header.version > VERSION)
+      return false;
+
+   const bool valid =
+      magic_matches &&
+      header.version == VERSION &&
+      header.header_size == sizeof(FactProfileHeader) &&
+      header.record_size == sizeof(FactProfileRecord) &&
+      header.fact_count <= FACT_ID_COUNT &&
+      file_size >=
+         sizeof(FactProfileHeader) +
+         header.fact_count * sizeof(FactProfileRecord);
+
+   if (!valid)
+   {
+      // zeroed records read as facts that were never answered
+      std::filesystem::resize_file(
+         path,
+         0,
+         error);
+   }
+
+   if (!valid || file_size < required_size)
+   {
+      std::filesystem::resize_file(
+         path,
+         required_size,
+         error);
+
+      if (error)
+         return false;
+   }
+
+#if _WIN32
+   const HANDLE file =
+      CreateFileW(
+         path.c_str(),
+         GENERIC_READ | GENERIC_WRITE,
+         FILE_SHARE_READ,
+         nullptr,
+         OPEN_EXISTING,
+         FILE_ATTRIBUTE_NORMAL,
+         nullptr);
+
+   if (file == INVALID_HANDLE_VALUE)
+      return false;
+
+   mapping_ =
+      CreateFileMappingW(
+         file,
+         nullptr,
+         PAGE_READWRITE,
+         0, 0,
+         nullptr);
+
+   if (mapping_)
+   {
+      data_ =
+         MapViewOfFile(
+            mapping_,
+            FILE_MAP_READ | FILE_MAP_WRITE,
+            0, 0,
+            0);
+   }
+
+   // the mapping keeps the file open
+   CloseHandle(file);
+#else
+   const int descriptor =
+      ::open(
+         path.c_str(),
+         O_RDWR | O_CLOEXEC);
+
+   if (descriptor < 0)
+      return false;
+
+   void * const data =
+      ::mmap(
+         nullptr,
+         required_size,
+         PROT_READ | PROT_WRITE,
+         MAP_SHARED,
+         descriptor,
+         0);
+
+   if (data != MAP_FAILED)
+   {
+      data_ = data;
+   }
+
+   // the mapping keeps the file open
+   ::close(descriptor);
+#endif // _WIN32
+
+   if (!data_)
+   {
+      Close();
+
+      return false;
+   }
+
+   size_ = required_size;
+
+   auto & mapped_header =
+      *static_cast< FactProfileHeader * >(data_);
+
+   if (!valid)
+   {
+      std::memcpy(
+         mapped_header.magic,
+         PROFILE_MAGIC,
+         sizeof(PROFILE_MAGIC));
+
+      mapped_header.version = VERSION;
+      mapped_header.header_size = sizeof(FactProfileHeader);
+      mapped_header.record_size = sizeof(FactProfileRecord);
+      mapped_header.created_unix_ms =
+         static_cast< uint64_t >(
+            std::chrono::duration_cast<
+               std::chrono::milliseconds >(
+                  std::chrono::system_clock::now().time_since_epoch()).count());
+   }
+
+   // the records of new facts are already zero
+   mapped_header.fact_count = FACT_ID_COUNT;
+
+   return true;
+}
+
+void FactProfile::Close( ) noexcept
+{
+#if _WIN32
+   if (data_)
+   {
+      UnmapViewOfFile(data_);
+   }
+
+   if (mapping_)
+   {
+      CloseHandle(mapping_);
+   }
+
+   mapping_ = nullptr;
+#else
+   if (data_)
+   {
+      ::munmap(
+         data_,
+         size_);
+   }
+#endif // _WIN32
+
+   data_ = nullptr;
+   size_ = 0;
+}
+
+bool FactProfile::IsOpen( ) const noexcept
+{
+   return
+      data_ != nullptr;
+}
+
+size_t FactProfile::SizeInBytes( ) const noexcept
+{
+   return
+      size_;
+}
+
+void FactProfile::Record(
+   const uint16_t fact_id,
+   const uint32_t response_time_ms,
+   const size_t number_of_responses,
+   const uint64_t answered_unix_ms ) noexcept
+{
+   if (!data_ || fact_id >= FACT_ID_COUNT)
+      return;
+
+   auto & record =
+      Records()[fact_id];
+
+   const auto current =
+      CurrentSlot(
+         record);
+
+   FactProfileSlot next { };
+
+   if (current)
+   {
+      next = *current;
+   }
+
+   // 0 marks a slot that was never written
+   if (++next.generation == 0)
+   {
+      next.generation = 1;
+   }
+
+   ++next.answers;
+
+   next.retried_answers += number_of_responses > 1;
+
+   next.mean_response_time_ms +=
+      (response_time_ms - next.mean_response_time_ms) / next.answers;
+   next.recent_response_time_ms =
+      next.answers == 1 ?
+         response_time_ms :
+         next.recent_response_time_ms +
+            RECENT_WEIGHT * (response_time_ms - next.recent_response_time_ms);
+   next.best_response_time_ms =
+      next.answers == 1 ?
+         response_time_ms :
+         std::min(
+            next.best_response_time_ms,
+            response_time_ms);
+   next.last_answered_unix_ms =
+      answered_unix_ms;
+   next.checksum =
+      SlotChecksum(
+         next);
+
+   // the current slot is never touched
+   auto & target =
+      current == &record.slots[0] ?
+         record.slots[1] :
+         record.slots[0];
+
+   std::memcpy(
+      &target,
+      &next,
+      sizeof(next));
+}
+
+FactMastery FactProfile::Get(
+   const uint16_t fact_id ) const noexcept
+{
+   if (!data_ || fact_id >= FACT_ID_COUNT)
+      return { };
+
+   const auto slot =
+      CurrentSlot(
+         Records()[fact_id]);
+
+   if (!slot)
+      return { };
+
+   return
+      FactMastery {
+         slot->answers,
+         slot->retried_answers,
+         slot->best_response_time_ms,
+         slot->mean_response_time_ms,
+         slot->recent_response_time_ms,
+         slot->last_answered_unix_ms
+      };
+}
+
+void FactProfile::Flush( ) noexcept
+{
+   if (!data_)
+      return;
+
+#if _WIN32
+   FlushViewOfFile(
+      data_,
+      0);
+#else
+   ::msync(
+      data_,
+      size_,
+      MS_ASYNC);
+#endif // _WIN32
+}
+
+const FactProfileSlot * FactProfile::CurrentSlot(
+   const FactProfileRecord & record ) noexcept
+{
+   const auto IsValid =
+      [ ] (
+         const FactProfileSlot & slot )
+      {
+         return
+            slot.generation != 0 &&
+            slot.checksum == SlotChecksum(slot);
+      };
+
+   const bool first_valid = IsValid(record.slots[0]);
+   const bool second_valid = IsValid(record.slots[1]);
+
+   if (first_valid && second_valid)
+   {
+      return
+         IsNewer(record.slots[1].generation, record.slots[0].generation) ?
+            &record.slots[1] :
+            &record.slots[0];
+   }
+
+   return
+      first_valid ? &record.slots[0] :
+      second_valid ? &record.slots[1] :
+      nullptr;
+}
+
+uint32_t FactProfile::SlotChecksum(
+   const FactProfileSlot & slot ) noexcept
+{
+   return
+      Crc32(
+         reinterpret_cast< const uint8_t * >(&slot),
+         offsetof(FactProfileSlot, checksum));
+}
+
+FactProfileRecord * FactProfile::Records( ) const noexcept
+{
+   return
+      reinterpret_cast< FactProfileRecord * >(
+         static_cast< uint8_t * >(data_) +
+         sizeof(FactProfileHeader));
+}
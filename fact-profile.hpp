@@ -0,0 +1,120 @@
+#ifndef _FACT_PROFILE_HPP_
+#define _FACT_PROFILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// the profile is a fixed layout file mapped into memory: a header and one
+// record per fact id.  values are in host byte order, as the profile
+// never leaves the machine of its user.
+struct FactProfileHeader
+{
+   char magic[4];
+   uint16_t version;
+   uint16_t header_size;
+   uint32_t record_size;
+   // grows when new facts are added; records beyond it read as empty
+   uint32_t fact_count;
+   uint64_t created_unix_ms;
+   uint8_t reserved[40];
+};
+
+static_assert(sizeof(FactProfileHeader) == 64);
+
+// an update writes the slot that is not current and then makes it current
+// by giving it the next generation.  the checksum covers every byte before
+// it, so a slot torn by a crash or power cut is ignored and the other slot
+// still holds the previous statistics.
+struct FactProfileSlot
+{
+   uint32_t generation;
+   uint32_t answers;
+   uint32_t retried_answers;
+   uint32_t best_response_time_ms;
+   double mean_response_time_ms;
+   // exponential moving average that follows recent sessions
+   double recent_response_time_ms;
+   uint64_t last_answered_unix_ms;
+   uint32_t reserved;
+   uint32_t checksum;
+};
+
+static_assert(sizeof(FactProfileSlot) == 48);
+
+struct FactProfileRecord
+{
+   FactProfileSlot slots[2];
+};
+
+struct FactMastery
+{
+   uint32_t answers;
+   uint32_t retried_answers;
+   uint32_t best_response_time_ms;
+   double mean_response_time_ms;
+   double recent_response_time_ms;
+   uint64_t last_answered_unix_ms;
+};
+
+// statistics of every fact a user has ever answered.  opening maps the
+// file, so nothing is read until a fact is looked at, and recording an
+// answer rewrites one slot of one record in place.
+class FactProfile
+{
+public:
+   static constexpr uint16_t VERSION { 1 };
+   static constexpr const char * EXTENSION { ".profile" };
+   // weight of the newest answer in the recent response time
+   static constexpr double RECENT_WEIGHT { 0.3 };
+
+   FactProfile( ) noexcept;
+   ~FactProfile( ) noexcept;
+
+   FactProfile(
+      const FactProfile & ) = delete;
+   FactProfile & operator = (
+      const FactProfile & ) = delete;
+
+   // creates the profile if it does not exist.  a damaged profile is
+   // started over; one written by a newer version is left alone.
+   bool Open(
+      const std::filesystem::path & path ) noexcept;
+   void Close( ) noexcept;
+
+   bool IsOpen( ) const noexcept;
+   // the mapped size; pages are only resident once touched
+   size_t SizeInBytes( ) const noexcept;
+
+   void Record(
+      const uint16_t fact_id,
+      const uint32_t response_time_ms,
+      const size_t number_of_responses,
+      const uint64_t answered_unix_ms ) noexcept;
+
+   FactMastery Get(
+      const uint16_t fact_id ) const noexcept;
+
+   // asks the operating system to start writing changed pages to disk
+   void Flush( ) noexcept;
+
+private:
+   // the current slot of a record, or nullptr if the fact was never answered
+   static const FactProfileSlot * CurrentSlot(
+      const FactProfileRecord & record ) noexcept;
+
+   static uint32_t SlotChecksum(
+      const FactProfileSlot & slot ) noexcept;
+
+   FactProfileRecord * Records( ) const noexcept;
+
+   void * data_;
+   size_t size_;
+
+#if _WIN32
+   void * mapping_;
+#endif // _WIN32
+
+};
+
+#endif // _FACT_PROFILE_HPP_
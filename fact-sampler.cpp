@@ -0,0 +1,111 @@
+#include "fact-sampler.hpp"
+#include "fact-table.hpp"
+
+#include <algorithm>
+
+FactSampler::FactSampler(
+   const uint32_t seed ) noexcept :
+random_engine_ { seed },
+operation_bits_ { }
+{
+}
+
+void FactSampler::SetOperations(
+   const uint32_t operation_bits ) noexcept
+{
+   operation_bits_ = operation_bits;
+
+   Fill();
+}
+
+void FactSampler::RestrictOperations(
+   const uint32_t operation_bits ) noexcept
+{
+   operation_bits_ = operation_bits;
+
+   for (size_t operation { }; operation < FACT_OPERATION_COUNT; ++operation)
+   {
+      if (!(operation_bits_ & (1u << operation)))
+      {
+         pools_[operation].clear();
+      }
+   }
+}
+
+uint16_t FactSampler::Next( ) noexcept
+{
+   const auto IsEmpty =
+      [ this ] ( )
+      {
+         return
+            std::all_of(
+               pools_.cbegin(),
+               pools_.cend(),
+               [ ] (
+                  const std::vector< uint16_t > & pool )
+               {
+                  return
+                     pool.empty();
+               });
+      };
+
+   if (IsEmpty())
+   {
+      Fill();
+
+      if (IsEmpty())
+         return NO_FACT;
+   }
+
+   std::uniform_int_distribution< size_t > operation_distribution {
+      0, FACT_OPERATION_COUNT - 1
+   };
+
+   size_t operation =
+      operation_distribution(
+         random_engine_);
+
+   while (pools_[operation].empty())
+   {
+      operation =
+         operation_distribution(
+            random_engine_);
+   }
+
+   const uint16_t fact_id =
+      pools_[operation].back();
+
+   pools_[operation].pop_back();
+
+   return
+      fact_id;
+}
+
+size_t FactSampler::Remaining(
+   const FactOperation operation ) const noexcept
+{
+   return
+      pools_[static_cast< size_t >(operation)].size();
+}
+
+void FactSampler::Fill( ) noexcept
+{
+   for (size_t operation { }; operation < FACT_OPERATION_COUNT; ++operation)
+   {
+      if (operation_bits_ & (1u << operation))
+      {
+         pools_[operation] =
+            GetFactTable(
+               static_cast< FactOperation >(operation));
+
+         std::shuffle(
+            pools_[operation].begin(),
+            pools_[operation].end(),
+            random_engine_);
+      }
+      else
+      {
+         pools_[operation].clear();
+      }
+   }
+}
@@ -0,0 +1,49 @@
+#ifndef _FACT_SAMPLER_HPP_
+#define _FACT_SAMPLER_HPP_
+
+#include "fact-id.hpp"
+#include "fact-operation.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// draws the facts of a session.  every operation has a shuffled pool of
+// its facts; a draw picks an operation at random among those with facts
+// left and takes the next fact of its pool, so no fact repeats until
+// every pool ran out and all of them are filled again.
+class FactSampler
+{
+public:
+   // returned by Next when no operation is enabled
+   static constexpr uint16_t NO_FACT { FACT_ID_COUNT };
+
+   explicit FactSampler(
+      const uint32_t seed ) noexcept;
+
+   // bit n enables the operation n; refills the enabled pools and
+   // empties the others
+   void SetOperations(
+      const uint32_t operation_bits ) noexcept;
+   // enables only these operations; what is left of their pools is kept
+   void RestrictOperations(
+      const uint32_t operation_bits ) noexcept;
+
+   uint16_t Next( ) noexcept;
+
+   // facts left before the pools are filled again
+   size_t Remaining(
+      const FactOperation operation ) const noexcept;
+
+private:
+   void Fill( ) noexcept;
+
+   std::default_random_engine random_engine_;
+   uint32_t operation_bits_;
+   std::array< std::vector< uint16_t >, FACT_OPERATION_COUNT > pools_;
+
+};
+
+#endif // _FACT_SAMPLER_HPP_
@@ -0,0 +1,183 @@
+#include "fact-table.hpp"
+
+FactOperands GetFactOperands(
+   const uint16_t fact_id ) noexcept
+{
+   FactOperands operands { };
+
+   operands.operation =
+      FactIdOperation(
+         fact_id);
+
+   if (fact_id < ARITHMETIC_FACT_COUNT)
+   {
+      const int32_t left =
+         fact_id / ARITHMETIC_FACT_OPERANDS % ARITHMETIC_FACT_OPERANDS;
+      const int32_t right =
+         fact_id % ARITHMETIC_FACT_OPERANDS;
+
+      // division facts are kept by quotient and divisor
+      operands.top =
+         operands.operation == FactOperation::DIV ?
+            left * right :
+            left;
+      operands.bottom = right;
+   }
+   else if (fact_id < FACT_ID_COUNT)
+   {
+      const uint16_t time_fact =
+         fact_id - ARITHMETIC_FACT_COUNT;
+
+      operands.time_kind =
+         static_cast< TimeFactKind >(
+            time_fact / TIME_FACTS_PER_KIND);
+      operands.hour =
+         static_cast< uint8_t >(time_fact % TIME_FACTS_PER_KIND / 12 + 1);
+      operands.minute =
+         static_cast< uint8_t >(time_fact % 12 * 5);
+   }
+
+   return
+      operands;
+}
+
+std::vector< uint16_t > GetFactTable(
+   const FactOperation operation )
+{
+   std::vector< uint16_t > fact_ids;
+
+   switch (operation)
+   {
+   case FactOperation::ADD: [[fallthrough]];
+   case FactOperation::MUL:
+      for (int32_t top { }; top <= 12; ++top)
+      {
+         for (int32_t bottom { }; bottom <= 12; ++bottom)
+         {
+            fact_ids.push_back(
+               ArithmeticFactId(operation, top, bottom));
+         }
+      }
+
+      break;
+
+   case FactOperation::SUB:
+      for (int32_t top { }; top <= 12; ++top)
+      {
+         for (int32_t bottom { }; bottom <= top; ++bottom)
+         {
+            fact_ids.push_back(
+               ArithmeticFactId(operation, top, bottom));
+         }
+      }
+
+      break;
+
+   case FactOperation::DIV:
+      for (int32_t denominator { 1 }; denominator <= 12; ++denominator)
+      {
+         for (int32_t answer { }; answer <= 12; ++answer)
+         {
+            fact_ids.push_back(
+               ArithmeticFactId(
+                  operation,
+                  denominator * answer,
+                  denominator));
+         }
+      }
+
+      break;
+
+   case FactOperation::TIME:
+      for (uint8_t hour { 1 }; hour <= 12; ++hour)
+      {
+         for (uint8_t minute { }; minute < 60; minute += 5)
+         {
+            fact_ids.push_back(
+               TimeFactId(TimeFactKind::CLOCK, hour, minute));
+            fact_ids.push_back(
+               TimeFactId(TimeFactKind::MILITARY_MORNING, hour, minute));
+            fact_ids.push_back(
+               TimeFactId(TimeFactKind::MILITARY_AFTERNOON, hour, minute));
+         }
+      }
+
+      break;
+   }
+
+   return
+      fact_ids;
+}
+
+int32_t GetArithmeticAnswer(
+   const uint16_t fact_id ) noexcept
+{
+   const FactOperands operands =
+      GetFactOperands(
+         fact_id);
+
+   switch (operands.operation)
+   {
+   case FactOperation::ADD: return operands.top + operands.bottom;
+   case FactOperation::SUB: return operands.top - operands.bottom;
+   case FactOperation::MUL: return operands.top * operands.bottom;
+   case FactOperation::DIV:
+      return
+         operands.bottom != 0 ?
+            operands.top / operands.bottom :
+            0;
+   case FactOperation::TIME: break;
+   }
+
+   return
+      0;
+}
+
+std::string GetTimeAnswer(
+   const uint16_t fact_id )
+{
+   const FactOperands operands =
+      GetFactOperands(
+         fact_id);
+
+   if (operands.operation != FactOperation::TIME)
+      return { };
+
+   int32_t hour =
+      operands.hour;
+
+   if (operands.time_kind == TimeFactKind::MILITARY_MORNING && hour == 12)
+      hour = 0;
+   else if (operands.time_kind == TimeFactKind::MILITARY_AFTERNOON && hour != 12)
+      hour += 12;
+
+   std::string answer;
+
+   if (operands.time_kind != TimeFactKind::CLOCK && hour < 10)
+      answer += '0';
+
+   answer += std::to_string(hour);
+   answer += operands.minute < 10 ? ":0" : ":";
+   answer += std::to_string(operands.minute);
+
+   return
+      answer;
+}
+
+bool GradeArithmeticResponse(
+   const uint16_t fact_id,
+   const int32_t response ) noexcept
+{
+   return
+      FactIdOperation(fact_id) != FactOperation::TIME &&
+      response == GetArithmeticAnswer(fact_id);
+}
+
+bool GradeTimeResponse(
+   const uint16_t fact_id,
+   const std::string_view response )
+{
+   return
+      FactIdOperation(fact_id) == FactOperation::TIME &&
+      response == GetTimeAnswer(fact_id);
+}
@@ -0,0 +1,52 @@
+#ifndef _FACT_TABLE_HPP_
+#define _FACT_TABLE_HPP_
+
+#include "fact-id.hpp"
+#include "fact-operation.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// what a fact shows the student
+struct FactOperands
+{
+   FactOperation operation;
+
+   // arithmetic; for division top is the dividend
+   int32_t top;
+   int32_t bottom;
+
+   // time; the hour is on the clock, 1 - 12
+   TimeFactKind time_kind;
+   uint8_t hour;
+   uint8_t minute;
+};
+
+FactOperands GetFactOperands(
+   const uint16_t fact_id ) noexcept;
+
+// every fact practiced for an operation:
+//    addition and multiplication  0 - 12 with 0 - 12
+//    subtraction                  0 - 12 less 0 - 12, never below 0
+//    division                     the products of 1 - 12 and 0 - 12 by 1 - 12
+//    time                         every five minutes of a clock, and of
+//                                 a morning and an afternoon in military time
+std::vector< uint16_t > GetFactTable(
+   const FactOperation operation );
+
+int32_t GetArithmeticAnswer(
+   const uint16_t fact_id ) noexcept;
+// "h:mm" for a clock and "hh:mm" for military time
+std::string GetTimeAnswer(
+   const uint16_t fact_id );
+
+bool GradeArithmeticResponse(
+   const uint16_t fact_id,
+   const int32_t response ) noexcept;
+bool GradeTimeResponse(
+   const uint16_t fact_id,
+   const std::string_view response );
+
+#endif // _FACT_TABLE_HPP_
@@ -0,0 +1,125 @@
+#include "latency-histogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram( ) noexcept :
+buckets_ { },
+count_ { },
+min_ { MAX_VALUE },
+max_ { }
+{
+}
+
+void LatencyHistogram::Record(
+   const uint64_t value ) noexcept
+{
+   const uint64_t clamped_value =
+      std::min(value, MAX_VALUE);
+
+   ++buckets_[BucketIndex(clamped_value)];
+   ++count_;
+
+   min_ = std::min(min_, clamped_value);
+   max_ = std::max(max_, clamped_value);
+}
+
+void LatencyHistogram::Merge(
+   const LatencyHistogram & histogram ) noexcept
+{
+   for (size_t i { }; i < BUCKETS; ++i)
+   {
+      buckets_[i] += histogram.buckets_[i];
+   }
+
+   count_ += histogram.count_;
+
+   min_ = std::min(min_, histogram.min_);
+   max_ = std::max(max_, histogram.max_);
+}
+
+void LatencyHistogram::Reset( ) noexcept
+{
+   *this = LatencyHistogram { };
+}
+
+uint64_t LatencyHistogram::Percentile(
+   const double percentile ) const noexcept
+{
+   if (count_ == 0)
+      return 0;
+
+   const double clamped_percentile =
+      std::clamp(percentile, 0.0, 100.0);
+
+   const uint64_t target =
+      std::max< uint64_t >(
+         1,
+         static_cast< uint64_t >(
+            std::ceil(clamped_percentile / 100.0 * count_)));
+
+   uint64_t cumulative_count { };
+
+   for (size_t i { }; i < BUCKETS; ++i)
+   {
+      cumulative_count += buckets_[i];
+
+      if (cumulative_count >= target)
+      {
+         return
+            std::clamp(
+               BucketHighestValue(i),
+               min_,
+               max_);
+      }
+   }
+
+   return
+      max_;
+}
+
+size_t LatencyHistogram::BucketIndex(
+   const uint64_t value ) noexcept
+{
+   if (value < SUB_BUCKETS)
+      return value;
+
+   // the top SUB_BUCKET_BITS + 1 bits select the sub bucket
+   const uint32_t shift =
+      std::bit_width(value) - 1 - SUB_BUCKET_BITS;
+
+   return
+      SUB_BUCKETS +
+      shift * SUB_BUCKETS +
+      ((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::BucketLowestValue(
+   const size_t index ) noexcept
+{
+   if (index < SUB_BUCKETS)
+      return index;
+
+   const uint64_t shift =
+      (index - SUB_BUCKETS) / SUB_BUCKETS;
+   const uint64_t sub_bucket =
+      (index - SUB_BUCKETS) % SUB_BUCKETS;
+
+   return
+      (SUB_BUCKETS + sub_bucket) << shift;
+}
+
+uint64_t LatencyHistogram::BucketHighestValue(
+   const size_t index ) noexcept
+{
+   if (index < SUB_BUCKETS)
+      return index;
+
+   const uint64_t shift =
+      (index - SUB_BUCKETS) / SUB_BUCKETS;
+
+   return
+      BucketLowestValue(index) +
+      (uint64_t { 1 } << shift) - 1;
+}
@@ -0,0 +1,59 @@
+#ifndef _LATENCY_HISTOGRAM_HPP_
+#define _LATENCY_HISTOGRAM_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// log-bucketed histogram in the style of hdr histogram.  every power of
+// two range is split into a fixed amount of linear sub buckets, so the
+// relative error of any reported value stays below 1 / SUB_BUCKETS.
+// recording and percentile lookups never allocate and are independent
+// of the amount of values recorded.
+class LatencyHistogram
+{
+public:
+   static constexpr uint32_t SUB_BUCKET_BITS { 4 };
+   static constexpr uint64_t SUB_BUCKETS { 1u << SUB_BUCKET_BITS };
+   static constexpr uint32_t MAX_VALUE_BITS { 40 };
+   static constexpr uint64_t MAX_VALUE { (uint64_t { 1 } << MAX_VALUE_BITS) - 1 };
+   static constexpr size_t BUCKETS {
+      SUB_BUCKETS * (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1)
+   };
+
+   LatencyHistogram( ) noexcept;
+
+   void Record(
+      const uint64_t value ) noexcept;
+   void Merge(
+      const LatencyHistogram & histogram ) noexcept;
+   void Reset( ) noexcept;
+
+   uint64_t Count( ) const noexcept { return count_; }
+   uint64_t Min( ) const noexcept { return count_ ? min_ : 0; }
+   uint64_t Max( ) const noexcept { return max_; }
+
+   // percentile within [0, 100]; returns the highest value that is
+   // equivalent to the bucket containing the requested percentile
+   uint64_t Percentile(
+      const double percentile ) const noexcept;
+
+   const std::array< uint64_t, BUCKETS > & Buckets( ) const noexcept { return buckets_; }
+
+   static size_t BucketIndex(
+      const uint64_t value ) noexcept;
+   static uint64_t BucketLowestValue(
+      const size_t index ) noexcept;
+   static uint64_t BucketHighestValue(
+      const size_t index ) noexcept;
+
+private:
+   std::array< uint64_t, BUCKETS > buckets_;
+
+   uint64_t count_;
+   uint64_t min_;
+   uint64_t max_;
+
+};
+
+#endif // _LATENCY_HISTOGRAM_HPP_
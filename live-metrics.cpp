@@ -0,0 +1,516 @@
+#include "live-metrics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#if _WIN32
+#  define NOMINMAX
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#  include <tlhelp32.h>
+#else
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <signal.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif // _WIN32
+
+namespace
+{
+
+constexpr char SEGMENT_MAGIC[4] { 'M', 'F', 'L', 'M' };
+constexpr const char * NAME_PREFIX { "math-facts-metrics-" };
+
+// a reader that loses this many races in a row gives up on the sample
+constexpr size_t MAX_READ_ATTEMPTS { 64 };
+
+#if _WIN32
+
+// local to the login session; readers run in the same session
+std::wstring SegmentName(
+   const uint32_t process_id ) noexcept
+{
+   return
+      L"Local\\math-facts-metrics-" + std::to_wstring(process_id);
+}
+
+#else
+
+// shows up in /dev/shm, which is how readers find the segments
+std::string SegmentName(
+   const uint32_t process_id ) noexcept
+{
+   return
+      "/" + std::string { NAME_PREFIX } + std::to_string(process_id);
+}
+
+#endif // _WIN32
+
+uint32_t CurrentProcessId( ) noexcept
+{
+#if _WIN32
+   return
+      static_cast< uint32_t >(GetCurrentProcessId());
+#else
+   return
+      static_cast< uint32_t >(::getpid());
+#endif // _WIN32
+}
+
+} // namespace
+
+LiveMetrics::LiveMetrics( ) noexcept :
+segment_ { }
+#if _WIN32
+, mapping_ { }
+#endif // _WIN32
+{
+}
+
+LiveMetrics::~LiveMetrics( ) noexcept
+{
+   Close();
+}
+
+bool LiveMetrics::Open(
+   const std::string & username ) noexcept
+{
+   Close();
+
+   const uint32_t process_id =
+      CurrentProcessId();
+
+   void * data { };
+
+#if _WIN32
+   // backed by the paging file, so nothing is ever written to disk
+   mapping_ =
+      CreateFileMappingW(
+         INVALID_HANDLE_VALUE,
+         nullptr,
+         PAGE_READWRITE,
+         0,
+         static_cast< DWORD >(sizeof(LiveMetricsSegment)),
+         SegmentName(process_id).c_str());
+
+   if (!mapping_)
+      return false;
+
+   data =
+      MapViewOfFile(
+         mapping_,
+         FILE_MAP_READ | FILE_MAP_WRITE,
+         0, 0,
+         sizeof(LiveMetricsSegment));
+#else
+   name_ =
+      SegmentName(
+         process_id);
+
+   // monitoring tools of other users may read but not write
+   const int descriptor =
+      ::shm_open(
+         name_.c_str(),
+         O_CREAT | O_RDWR | O_TRUNC | O_CLOEXEC,
+         0644);
+
+   if (descriptor < 0)
+      return false;
+
+   if (::ftruncate(descriptor, sizeof(LiveMetricsSegment)) == 0)
+   {
+      data =
+         ::mmap(
+            nullptr,
+            sizeof(LiveMetricsSegment),
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED,
+            descriptor,
+            0);
+
+      if (data == MAP_FAILED)
+      {
+         data = nullptr;
+      }
+   }
+
+   // the mapping keeps the segment open
+   ::close(descriptor);
+#endif // _WIN32
+
+   if (!data)
+   {
+      Close();
+
+      return false;
+   }
+
+   segment_ =
+      static_cast< LiveMetricsSegment * >(data);
+
+   std::memset(
+      segment_,
+      0,
+      sizeof(LiveMetricsSegment));
+
+   segment_->version = VERSION;
+   segment_->header_size = offsetof(LiveMetricsSegment, data);
+   segment_->data_size = sizeof(LiveMetricsData);
+   segment_->process_id = process_id;
+   segment_->started_unix_ms =
+      static_cast< uint64_t >(
+         std::chrono::duration_cast<
+            std::chrono::milliseconds >(
+               std::chrono::system_clock::now().time_since_epoch()).count());
+
+   username.copy(
+      segment_->username,
+      sizeof(segment_->username) - 1);
+
+   // readers ignore the segment until the magic shows that the header
+   // is complete
+   std::atomic_thread_fence(
+      std::memory_order_release);
+
+   std::memcpy(
+      segment_->magic,
+      SEGMENT_MAGIC,
+      sizeof(SEGMENT_MAGIC));
+
+   return
+      true;
+}
+
+void LiveMetrics::Close( ) noexcept
+{
+#if _WIN32
+   if (segment_)
+   {
+      UnmapViewOfFile(segment_);
+   }
+
+   // the segment goes away with its last handle
+   if (mapping_)
+   {
+      CloseHandle(mapping_);
+   }
+
+   mapping_ = nullptr;
+#else
+   if (segment_)
+   {
+      ::munmap(
+         segment_,
+         sizeof(LiveMetricsSegment));
+   }
+
+   if (!name_.empty())
+   {
+      ::shm_unlink(
+         name_.c_str());
+   }
+
+   name_.clear();
+#endif // _WIN32
+
+   segment_ = nullptr;
+}
+
+void LiveMetrics::Publish(
+   const LiveMetricsData & data ) noexcept
+{
+   if (!segment_)
+      return;
+
+   std::atomic_ref< uint32_t > sequence {
+      segment_->sequence
+   };
+
+   // only this thread writes, so the sequence can be read relaxed
+   const uint32_t current_sequence =
+      sequence.load(
+         std::memory_order_relaxed);
+
+   sequence.store(
+      current_sequence + 1,
+      std::memory_order_relaxed);
+
+   std::atomic_thread_fence(
+      std::memory_order_release);
+
+   std::memcpy(
+      &segment_->data,
+      &data,
+      sizeof(data));
+
+   sequence.store(
+      current_sequence + 2,
+      std::memory_order_release);
+}
+
+LiveMetricsReader::LiveMetricsReader(
+   const uint32_t process_id ) noexcept :
+segment_ { }
+#if _WIN32
+, mapping_ { }
+#endif // _WIN32
+{
+   const void * data { };
+
+#if _WIN32
+   mapping_ =
+      OpenFileMappingW(
+         FILE_MAP_READ,
+         FALSE,
+         SegmentName(process_id).c_str());
+
+   if (!mapping_)
+      return;
+
+   data =
+      MapViewOfFile(
+         mapping_,
+         FILE_MAP_READ,
+         0, 0,
+         sizeof(LiveMetricsSegment));
+#else
+   const int descriptor =
+      ::shm_open(
+         SegmentName(process_id).c_str(),
+         O_RDONLY | O_CLOEXEC,
+         0);
+
+   if (descriptor < 0)
+      return;
+
+   struct stat segment_status { };
+
+   if (::fstat(descriptor, &segment_status) == 0 &&
+       static_cast< size_t >(segment_status.st_size) >= sizeof(LiveMetricsSegment))
+   {
+      data =
+         ::mmap(
+            nullptr,
+            sizeof(LiveMetricsSegment),
+            PROT_READ,
+            MAP_SHARED,
+            descriptor,
+            0);
+
+      if (data == MAP_FAILED)
+      {
+         data = nullptr;
+      }
+   }
+
+   ::close(descriptor);
+#endif // _WIN32
+
+   if (!data)
+      return;
+
+   segment_ =
+      static_cast< const LiveMetricsSegment * >(data);
+
+   const bool valid =
+      std::memcmp(segment_->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) == 0 &&
+      segment_->version == LiveMetrics::VERSION &&
+      segment_->data_size == sizeof(LiveMetricsData);
+
+   std::atomic_thread_fence(
+      std::memory_order_acquire);
+
+   if (!valid)
+   {
+#if _WIN32
+      UnmapViewOfFile(segment_);
+#else
+      ::munmap(
+         const_cast< LiveMetricsSegment * >(segment_),
+         sizeof(LiveMetricsSegment));
+#endif // _WIN32
+
+      segment_ = nullptr;
+   }
+}
+
+LiveMetricsReader::~LiveMetricsReader( ) noexcept
+{
+#if _WIN32
+   if (segment_)
+   {
+      UnmapViewOfFile(segment_);
+   }
+
+   if (mapping_)
+   {
+      CloseHandle(mapping_);
+   }
+#else
+   if (segment_)
+   {
+      ::munmap(
+         const_cast< LiveMetricsSegment * >(segment_),
+         sizeof(LiveMetricsSegment));
+   }
+#endif // _WIN32
+}
+
+bool LiveMetricsReader::IsOpen( ) const noexcept
+{
+   return
+      segment_ != nullptr;
+}
+
+uint32_t LiveMetricsReader::ProcessId( ) const noexcept
+{
+   return
+      segment_ ?
+         segment_->process_id :
+         0;
+}
+
+std::string LiveMetricsReader::Username( ) const noexcept
+{
+   if (!segment_)
+      return { };
+
+   return {
+      segment_->username,
+      ::strnlen(segment_->username, sizeof(segment_->username))
+   };
+}
+
+uint64_t LiveMetricsReader::StartedUnixMs( ) const noexcept
+{
+   return
+      segment_ ?
+         segment_->started_unix_ms :
+         0;
+}
+
+bool LiveMetricsReader::Read(
+   LiveMetricsData & data ) const noexcept
+{
+   if (!segment_)
+      return false;
+
+   // the mapping is read only; a 32 bit atomic load never writes to it
+   std::atomic_ref< uint32_t > sequence {
+      const_cast< uint32_t & >(segment_->sequence)
+   };
+
+   for (size_t attempt { }; attempt < MAX_READ_ATTEMPTS; ++attempt)
+   {
+      const uint32_t sequence_before =
+         sequence.load(
+            std::memory_order_acquire);
+
+      if (sequence_before & 1)
+      {
+         std::this_thread::yield();
+
+         continue;
+      }
+
+      std::memcpy(
+         &data,
+         &segment_->data,
+         sizeof(data));
+
+      std::atomic_thread_fence(
+         std::memory_order_acquire);
+
+      if (sequence.load(std::memory_order_relaxed) == sequence_before)
+         return true;
+   }
+
+   return
+      false;
+}
+
+std::vector< uint32_t > FindLiveMetrics( ) noexcept
+{
+   std::vector< uint32_t > process_ids;
+
+#if _WIN32
+   // named mappings cannot be listed, so every practice process is tried
+   const HANDLE snapshot =
+      CreateToolhelp32Snapshot(
+         TH32CS_SNAPPROCESS,
+         0);
+
+   if (snapshot == INVALID_HANDLE_VALUE)
+      return process_ids;
+
+   PROCESSENTRY32W process_entry { };
+
+   process_entry.dwSize = sizeof(process_entry);
+
+   for (BOOL found = Process32FirstW(snapshot, &process_entry);
+        found;
+        found = Process32NextW(snapshot, &process_entry))
+   {
+      if (_wcsicmp(process_entry.szExeFile, L"math-facts.exe") == 0)
+      {
+         process_ids.push_back(
+            static_cast< uint32_t >(process_entry.th32ProcessID));
+      }
+   }
+
+   CloseHandle(snapshot);
+#else
+   const std::string_view prefix {
+      NAME_PREFIX
+   };
+
+   std::error_code error;
+
+   for (std::filesystem::directory_iterator entry { "/dev/shm", error }, end;
+        !error && entry != end;
+        entry.increment(error))
+   {
+      const std::string file_name =
+         entry->path().filename().string();
+
+      if (!file_name.starts_with(prefix))
+         continue;
+
+      uint32_t process_id { };
+
+      const auto [ end_of_number, parse_error ] =
+         std::from_chars(
+            file_name.data() + prefix.size(),
+            file_name.data() + file_name.size(),
+            process_id);
+
+      if (parse_error != std::errc { } ||
+          end_of_number != file_name.data() + file_name.size())
+         continue;
+
+      // segments of processes that crashed are left behind
+      if (::kill(static_cast< pid_t >(process_id), 0) == 0 || errno == EPERM)
+      {
+         process_ids.push_back(
+            process_id);
+      }
+   }
+#endif // _WIN32
+
+   std::sort(
+      process_ids.begin(),
+      process_ids.end());
+
+   return
+      process_ids;
+}
@@ -0,0 +1,133 @@
+#ifndef _LIVE_METRICS_HPP_
+#define _LIVE_METRICS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// what a running practice publishes about itself.  counters only grow;
+// gauges hold the value at the time of the last publish.
+struct LiveMetricsData
+{
+   // paints are counted by the bit width of their duration in microseconds
+   static constexpr size_t PAINT_TIME_BUCKETS { 20 };
+
+   uint64_t updated_unix_ms;
+   uint64_t stage;
+
+   uint64_t frames_painted;
+   uint64_t paint_time_us;
+   uint64_t paint_time_histogram[PAINT_TIME_BUCKETS];
+
+   uint64_t problems_answered;
+   uint64_t retried_answers;
+
+   // heap allocations of the gui thread, only counted in builds with
+   // MATH_FACTS_TRACK_ALLOCATIONS.  a paint counts what it draws, not the
+   // painter qt begins for it; key presses that grade an answer are left
+   // out.
+   uint64_t paint_allocations;
+   uint64_t allocating_paints;
+   uint64_t key_press_allocations;
+   uint64_t allocating_key_presses;
+
+   // gauges
+   uint64_t cache_bytes;
+   uint64_t journal_queue_depth;
+   uint64_t journal_dropped_records;
+   uint64_t background_tasks;
+};
+
+// layout of the shared memory segment of one process.  values are in host
+// byte order; the segment never leaves the machine.
+struct LiveMetricsSegment
+{
+   char magic[4];
+   uint16_t version;
+   uint16_t header_size;
+   uint32_t data_size;
+   uint32_t process_id;
+   uint64_t started_unix_ms;
+   char username[32];
+
+   // even while the data is stable and odd while the writer changes it
+   uint32_t sequence;
+   uint32_t reserved;
+
+   LiveMetricsData data;
+};
+
+// publishes the metrics of this process in a named shared memory segment.
+// a publish is a seqlock write: it never waits for a reader, and readers
+// simply try again if they saw it half done.
+class LiveMetrics
+{
+public:
+   static constexpr uint16_t VERSION { 3 };
+
+   LiveMetrics( ) noexcept;
+   ~LiveMetrics( ) noexcept;
+
+   LiveMetrics(
+      const LiveMetrics & ) = delete;
+   LiveMetrics & operator = (
+      const LiveMetrics & ) = delete;
+
+   bool Open(
+      const std::string & username ) noexcept;
+   // removes the segment
+   void Close( ) noexcept;
+
+   // called from a single thread only
+   void Publish(
+      const LiveMetricsData & data ) noexcept;
+
+private:
+   LiveMetricsSegment * segment_;
+   std::string name_;
+
+#if _WIN32
+   void * mapping_;
+#endif // _WIN32
+
+};
+
+// a read only view of the segment of another process.  reading copies the
+// data out of shared memory, so sampling involves no round trip to the
+// process being watched.
+class LiveMetricsReader
+{
+public:
+   explicit LiveMetricsReader(
+      const uint32_t process_id ) noexcept;
+   ~LiveMetricsReader( ) noexcept;
+
+   LiveMetricsReader(
+      const LiveMetricsReader & ) = delete;
+   LiveMetricsReader & operator = (
+      const LiveMetricsReader & ) = delete;
+
+   bool IsOpen( ) const noexcept;
+
+   uint32_t ProcessId( ) const noexcept;
+   std::string Username( ) const noexcept;
+   uint64_t StartedUnixMs( ) const noexcept;
+
+   // false if the writer kept changing the data while it was copied
+   bool Read(
+      LiveMetricsData & data ) const noexcept;
+
+private:
+   const LiveMetricsSegment * segment_;
+
+#if _WIN32
+   void * mapping_;
+#endif // _WIN32
+
+};
+
+// the processes of this host that publish metrics
+std::vector< uint32_t > FindLiveMetrics( ) noexcept;
+
+#endif // _LIVE_METRICS_HPP_
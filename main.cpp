@@ -1,10 +1,18 @@
+#include "dashboard-widget.hpp"
 #include "math-facts-widget.hpp"
+#include "single-instance.hpp"
 
+#include <QtCore/QMetaObject>
+#include <QtCore/QObject>
 #include <QtCore/QSize>
 #include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/Qt>
 #include <QtGui/QIcon>
 #include <QtWidgets/QApplication>
 
+#include <memory>
+
 int main(
    int argc,
    char ** argv )
@@ -19,14 +27,117 @@ int main(
    application.setStyle(
       "Fusion");
 
-   MathFactsWidget math_facts_widget {
-      nullptr
+   // teachers start the class dashboard instead of a practice session
+   if (application.arguments().contains("--dashboard"))
+   {
+      DashboardWidget dashboard_widget {
+         MathFactsWidget::GetReportsDirectory(),
+         nullptr
+      };
+
+      dashboard_widget.resize(
+         QSize { 800, 600 });
+
+      dashboard_widget.show();
+
+      return
+         application.exec();
+   }
+
+   SingleInstance single_instance {
+      QString::fromStdString(
+         "math-facts-" + MathFactsWidget::GetCurrentUserName())
    };
 
-   math_facts_widget.setMinimumSize(
-      QSize { 200, 200 });
+   // students double click the icon; later launches only bring the
+   // running practice to the front
+   if (single_instance.HandOff(application.arguments()))
+      return 0;
+
+   // started with --resident, e.g. at login, the widget is built and
+   // warmed up hidden, so that a launch only has to show it
+   const bool resident =
+      application.arguments().contains("--resident");
+
+   std::unique_ptr< MathFactsWidget > math_facts_widget;
+
+   const auto CreateWidget =
+      [ &math_facts_widget ] ( )
+      {
+         // the old widget waits for its tasks before the new one starts any
+         math_facts_widget.reset();
+         math_facts_widget =
+            std::make_unique< MathFactsWidget >(
+               nullptr);
+
+         math_facts_widget->setMinimumSize(
+            QSize { 200, 200 });
+      };
+
+   const auto ShowWidget =
+      [ &math_facts_widget ] ( )
+      {
+         if (math_facts_widget->isMinimized())
+         {
+            math_facts_widget->showNormal();
+         }
+         else
+         {
+            math_facts_widget->show();
+         }
+
+         math_facts_widget->raise();
+         math_facts_widget->activateWindow();
+      };
+
+   // launches are only handled once the event loop runs, after the
+   // widget was created
+   const bool listening =
+      single_instance.Listen(
+         [ ShowWidget ] (
+            const QStringList & arguments )
+         {
+            // starting resident twice changes nothing
+            if (!arguments.contains("--resident"))
+            {
+               ShowWidget();
+            }
+         });
+
+   // another launch became the running instance first
+   if (!listening)
+   {
+      return
+         single_instance.HandOff(application.arguments()) ?
+            0 :
+            1;
+   }
+
+   CreateWidget();
+
+   if (resident)
+   {
+      application.setQuitOnLastWindowClosed(
+         false);
 
-   math_facts_widget.show();
+      // a closed session leaves a fresh widget ready for the next launch;
+      // it is replaced once the close has been handled
+      QObject::connect(
+         &application,
+         &QApplication::lastWindowClosed,
+         &application,
+         [ &application, CreateWidget ] ( )
+         {
+            QMetaObject::invokeMethod(
+               &application,
+               CreateWidget,
+               Qt::ConnectionType::QueuedConnection);
+         });
+   }
+   else
+   {
+      ShowWidget();
+   }
 
    return
       application.exec();
@@ -0,0 +1,174 @@
+#include "mapped-file.hpp"
+
+#if _WIN32
+#  define NOMINMAX
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif // _WIN32
+
+MappedFile::MappedFile(
+   const std::filesystem::path & path ) noexcept :
+open_ { },
+data_ { },
+size_ { }
+#if _WIN32
+, mapping_ { }
+#endif // _WIN32
+{
+#if _WIN32
+   const HANDLE file =
+      CreateFileW(
+         path.c_str(),
+         GENERIC_READ,
+         FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+         nullptr,
+         OPEN_EXISTING,
+         FILE_FLAG_SEQUENTIAL_SCAN,
+         nullptr);
+
+   if (file == INVALID_HANDLE_VALUE)
+      return;
+
+   LARGE_INTEGER file_size { };
+
+   if (GetFileSizeEx(file, &file_size))
+   {
+      size_ = static_cast< size_t >(file_size.QuadPart);
+
+      if (!size_)
+      {
+         open_ = true;
+      }
+      else
+      {
+         mapping_ =
+            CreateFileMappingW(
+               file,
+               nullptr,
+               PAGE_READONLY,
+               0, 0,
+               nullptr);
+
+         if (mapping_)
+         {
+            data_ =
+               static_cast< const char * >(
+                  MapViewOfFile(
+                     mapping_,
+                     FILE_MAP_READ,
+                     0, 0,
+                     0));
+
+            open_ = data_ != nullptr;
+         }
+      }
+   }
+
+   // the mapping keeps the file open
+   CloseHandle(file);
+#else
+   const int descriptor =
+      ::open(
+         path.c_str(),
+         O_RDONLY | O_CLOEXEC);
+
+   if (descriptor < 0)
+      return;
+
+   struct stat file_status { };
+
+   if (::fstat(descriptor, &file_status) == 0)
+   {
+      size_ = static_cast< size_t >(file_status.st_size);
+
+      if (!size_)
+      {
+         open_ = true;
+      }
+      else
+      {
+         void * const data =
+            ::mmap(
+               nullptr,
+               size_,
+               PROT_READ,
+               MAP_PRIVATE,
+               descriptor,
+               0);
+
+         if (data != MAP_FAILED)
+         {
+            // reports are read once front to back
+            ::madvise(
+               data,
+               size_,
+               MADV_SEQUENTIAL);
+
+            data_ = static_cast< const char * >(data);
+            open_ = true;
+         }
+      }
+   }
+
+   // the mapping keeps the file open
+   ::close(descriptor);
+#endif // _WIN32
+
+   if (!open_)
+   {
+      size_ = 0;
+   }
+}
+
+MappedFile::~MappedFile( ) noexcept
+{
+#if _WIN32
+   if (data_)
+   {
+      UnmapViewOfFile(data_);
+   }
+
+   if (mapping_)
+   {
+      CloseHandle(mapping_);
+   }
+#else
+   if (data_)
+   {
+      ::munmap(
+         const_cast< char * >(data_),
+         size_);
+   }
+#endif // _WIN32
+}
+
+bool MappedFile::IsOpen( ) const noexcept
+{
+   return
+      open_;
+}
+
+const char * MappedFile::Data( ) const noexcept
+{
+   return
+      data_;
+}
+
+size_t MappedFile::Size( ) const noexcept
+{
+   return
+      size_;
+}
+
+std::string_view MappedFile::View( ) const noexcept
+{
+   return {
+      data_,
+      size_
+   };
+}
@@ -0,0 +1,42 @@
+#ifndef _MAPPED_FILE_HPP_
+#define _MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+// read only view of a whole file mapped into memory.  the pages are
+// loaded by the operating system as they are touched, so nothing is
+// copied into user space buffers.
+class MappedFile
+{
+public:
+   MappedFile(
+      const std::filesystem::path & path ) noexcept;
+   ~MappedFile( ) noexcept;
+
+   MappedFile(
+      const MappedFile & ) = delete;
+   MappedFile & operator = (
+      const MappedFile & ) = delete;
+
+   // an empty file is open but has no data
+   bool IsOpen( ) const noexcept;
+
+   const char * Data( ) const noexcept;
+   size_t Size( ) const noexcept;
+
+   std::string_view View( ) const noexcept;
+
+private:
+   bool open_;
+   const char * data_;
+   size_t size_;
+
+#if _WIN32
+   void * mapping_;
+#endif // _WIN32
+
+};
+
+#endif // _MAPPED_FILE_HPP_
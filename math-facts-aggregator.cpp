@@ -0,0 +1,195 @@
+#include "classroom-aggregator.hpp"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <ostream>
+#include <string_view>
+
+// collects the answers of every practice session on this host, e.g. a
+// terminal server or a multi-seat classroom computer, so a teacher can
+// follow the whole class from one screen:
+//
+//    math-facts-aggregator [options]
+//
+//    --interval <ms>    time between summaries; defaults to 5000
+//
+// sessions find the aggregator on their own, so it may be started before
+// or after the students start practicing.  statistics are only kept in
+// memory and are gone once the aggregator stops.
+
+static void PrintUsage( )
+{
+   std::cerr
+      << "usage: math-facts-aggregator [--interval <ms>]\n";
+}
+
+static void PrintSummary(
+   const ClassroomAggregator & aggregator,
+   const std::chrono::duration< double > elapsed,
+   const uint64_t answers_in_interval )
+{
+   const uint64_t now_unix_ms =
+      static_cast< uint64_t >(
+         std::chrono::duration_cast<
+            std::chrono::milliseconds >(
+               std::chrono::system_clock::now().time_since_epoch()).count());
+
+   auto & output =
+      std::cout;
+
+   output
+      << "students = "
+      << aggregator.Students().size()
+      << "; sessions = "
+      << aggregator.SessionCount()
+      << "; answers = "
+      << aggregator.AnswerCount()
+      << "; answers per second = "
+      << (elapsed.count() > 0.0 ?
+            answers_in_interval / elapsed.count() :
+            0.0)
+      << "; rejected sessions = "
+      << aggregator.RejectedSessionCount()
+      << "\n";
+
+   for (const auto & [username, student] : aggregator.Students())
+   {
+      output
+         << "   student = "
+         << username.toStdString()
+         << "; sessions = "
+         << student.sessions
+         << "; answers = "
+         << student.answers
+         << "; retried = "
+         << student.retried_answers;
+
+      for (size_t operation { }; operation < FACT_OPERATION_COUNT; ++operation)
+      {
+         if (student.answers_by_operation[operation])
+         {
+            output
+               << "; "
+               << FactOperationName(static_cast< FactOperation >(operation))
+               << " = "
+               << student.answers_by_operation[operation];
+         }
+      }
+
+      output
+         << "; recent mean ms = "
+         << student.RecentMeanResponseTimeMs()
+         << "; recent retry rate = "
+         << student.RecentRetryRate()
+         << "; dropped = "
+         << student.dropped_answers
+         << "; idle s = "
+         << (now_unix_ms > student.last_answered_unix_ms &&
+             student.last_answered_unix_ms ?
+               (now_unix_ms - student.last_answered_unix_ms) / 1000 :
+               0)
+         << "\n";
+   }
+
+   output.flush();
+}
+
+int main(
+   int argc,
+   char ** argv )
+{
+   QCoreApplication application {
+      argc,
+      argv
+   };
+
+   std::chrono::milliseconds interval { 5000 };
+
+   for (int i { 1 }; i < argc; ++i)
+   {
+      const std::string_view argument {
+         argv[i]
+      };
+
+      bool valid { i + 1 < argc };
+
+      if (!valid)
+      {
+      }
+      else if (argument == "--interval")
+      {
+         interval =
+            std::chrono::milliseconds {
+               std::strtoull(argv[i + 1], nullptr, 10)
+            };
+
+         valid = interval.count() > 0;
+      }
+      else
+      {
+         valid = false;
+      }
+
+      if (!valid)
+      {
+         PrintUsage();
+
+         return
+            EXIT_FAILURE;
+      }
+
+      ++i;
+   }
+
+   ClassroomAggregator aggregator;
+
+   if (!aggregator.Listen())
+   {
+      std::cerr
+         << "error: cannot listen for sessions: "
+         << aggregator.ErrorString().toStdString()
+         << "\n";
+
+      return
+         EXIT_FAILURE;
+   }
+
+   std::ios_base::sync_with_stdio(false);
+
+   auto previous_time =
+      std::chrono::steady_clock::now();
+   uint64_t previous_answers { };
+
+   QTimer summary_timer;
+
+   QObject::connect(
+      &summary_timer,
+      &QTimer::timeout,
+      &summary_timer,
+      [ & ] ( )
+      {
+         const auto now =
+            std::chrono::steady_clock::now();
+
+         PrintSummary(
+            aggregator,
+            now - previous_time,
+            aggregator.AnswerCount() - previous_answers);
+
+         previous_time = now;
+         previous_answers = aggregator.AnswerCount();
+      });
+
+   summary_timer.start(
+      interval);
+
+   return
+      application.exec();
+}
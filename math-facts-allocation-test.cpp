@@ -0,0 +1,301 @@
+#include "allocation-counter.hpp"
+#include "fact-profile.hpp"
+#include "live-metrics.hpp"
+#include "math-facts-widget.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEvent>
+#include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/Qt>
+#include <QtCore/QtGlobal>
+#include <QtGui/QKeyEvent>
+#include <QtWidgets/QApplication>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+// practices on the offscreen platform, typing into the problem and
+// painting it over and over, and fails if a paint that changes nothing
+// or a key press that only types allocates on the heap:
+//
+//    math-facts-allocation-test
+//
+// it is always built with the allocation counting operators, whatever
+// MATH_FACTS_TRACK_ALLOCATIONS says for the application.  the first paint
+// after a key press draws the changed problem again, which may allocate,
+// so only the paints after it are checked.  the answer is never entered,
+// so the problem stays the same throughout.
+//
+// the practice runs as allocation-test-<pid>, with settings written next
+// to the test for this run only: the report and the journal go to a
+// temporary directory, and nothing is sent to a classroom aggregator.
+// the settings and the profile are removed again at the end.
+
+namespace
+{
+
+// paints checked after every change
+constexpr uint64_t STEADY_PAINTS { 20 };
+// times the keys are typed and erased again
+constexpr int TYPING_ROUNDS { 4 };
+
+void SendKey(
+   MathFactsWidget & widget,
+   const int key,
+   const QString & text )
+{
+   QKeyEvent event {
+      QEvent::Type::KeyPress,
+      key,
+      Qt::KeyboardModifier::NoModifier,
+      text
+   };
+
+   QCoreApplication::sendEvent(
+      &widget,
+      &event);
+}
+
+// the paints after the one that draws the last change
+bool CheckSteadyPaints(
+   MathFactsWidget & widget,
+   const std::string_view step )
+{
+   widget.repaint();
+
+   const LiveMetricsData before =
+      widget.GetLiveMetrics();
+
+   for (uint64_t i { }; i < STEADY_PAINTS; ++i)
+   {
+      widget.repaint();
+   }
+
+   const LiveMetricsData & after =
+      widget.GetLiveMetrics();
+
+   const uint64_t paints =
+      after.frames_painted -
+      before.frames_painted;
+   const uint64_t allocating_paints =
+      after.allocating_paints -
+      before.allocating_paints;
+
+   const bool passed =
+      paints == STEADY_PAINTS &&
+      allocating_paints == 0;
+
+   if (!passed)
+   {
+      std::cerr
+         << "step = "
+         << step
+         << "; paints = "
+         << paints
+         << "; allocating paints = "
+         << allocating_paints
+         << "; paint allocations = "
+         << after.paint_allocations - before.paint_allocations
+         << "\n";
+   }
+
+   return
+      passed;
+}
+
+// the widget is gone once this returns, and with it every file it holds
+bool RunPractice( )
+{
+   MathFactsWidget math_facts_widget {
+      nullptr
+   };
+
+   math_facts_widget.resize(
+      800,
+      600);
+   math_facts_widget.show();
+
+   // lets the warm up finish and the window be exposed
+   QCoreApplication::processEvents();
+
+   math_facts_widget.StartPractice();
+
+   if (!math_facts_widget.IsPracticing())
+   {
+      std::cerr
+         << "the practice did not start\n";
+
+      return
+         false;
+   }
+
+   bool passed =
+      CheckSteadyPaints(
+         math_facts_widget,
+         "problem shown");
+
+   const LiveMetricsData typing_before =
+      math_facts_widget.GetLiveMetrics();
+
+   for (int round { }; round < TYPING_ROUNDS; ++round)
+   {
+      // more digits than any response takes, so some are turned away
+      for (const char digit : std::string_view { "123456" })
+      {
+         SendKey(
+            math_facts_widget,
+            Qt::Key::Key_0 + (digit - '0'),
+            QString { QChar { digit } });
+
+         passed &=
+            CheckSteadyPaints(
+               math_facts_widget,
+               "digit typed");
+      }
+
+      for (int i { }; i < 6; ++i)
+      {
+         SendKey(
+            math_facts_widget,
+            Qt::Key::Key_Backspace,
+            QString { });
+
+         passed &=
+            CheckSteadyPaints(
+               math_facts_widget,
+               "digit erased");
+      }
+   }
+
+   const LiveMetricsData & typing_after =
+      math_facts_widget.GetLiveMetrics();
+
+   const uint64_t allocating_key_presses =
+      typing_after.allocating_key_presses -
+      typing_before.allocating_key_presses;
+
+   if (allocating_key_presses != 0)
+   {
+      std::cerr
+         << "step = typing; allocating key presses = "
+         << allocating_key_presses
+         << "; key press allocations = "
+         << typing_after.key_press_allocations -
+            typing_before.key_press_allocations
+         << "\n";
+
+      passed = false;
+   }
+
+   math_facts_widget.FinishPractice();
+
+   // the report is written on the thread pool and reported back through
+   // the event loop
+   while (math_facts_widget.IsWritingReport())
+   {
+      QCoreApplication::processEvents();
+
+      std::this_thread::sleep_for(
+         std::chrono::milliseconds { 1 });
+   }
+
+   return
+      passed;
+}
+
+} // namespace
+
+int main(
+   int argc,
+   char ** argv )
+{
+   const std::string username =
+      "allocation-test-" +
+      std::to_string(QCoreApplication::applicationPid());
+
+   // both have to be in place before the application starts
+#if _WIN32
+   qputenv("USERNAME", QByteArray::fromStdString(username));
+#else
+   qputenv("USER", QByteArray::fromStdString(username));
+#endif // _WIN32
+
+   if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+   {
+      qputenv("QT_QPA_PLATFORM", "offscreen");
+   }
+
+   QApplication application {
+      argc,
+      argv
+   };
+
+   if (!IsAllocationTrackingEnabled())
+   {
+      std::cerr
+         << "built without counting allocations\n";
+
+      return
+         EXIT_FAILURE;
+   }
+
+   const QTemporaryDir reports_directory;
+
+   if (!reports_directory.isValid())
+   {
+      std::cerr
+         << "cannot create a reports directory\n";
+
+      return
+         EXIT_FAILURE;
+   }
+
+   // settings and profiles are only looked for next to the application
+   const std::filesystem::path application_directory =
+      QCoreApplication::applicationDirPath().toStdString();
+   const std::filesystem::path settings_path =
+      application_directory /
+      (username + "-math-facts.ini");
+
+   std::ofstream {
+      settings_path
+   }
+      << "reports_directory = "
+      << reports_directory.path().toStdString()
+      << "\narchive_reports_after_days = 0"
+         "\nclassroom_feed = false\n";
+
+   const bool passed =
+      RunPractice();
+
+   std::error_code error;
+
+   std::filesystem::remove(
+      settings_path,
+      error);
+   std::filesystem::remove(
+      application_directory /
+      (username + "-math-facts" + FactProfile::EXTENSION),
+      error);
+
+   std::cout
+      << "passed = "
+      << (passed ? "yes" : "no")
+      << "\n";
+
+   return
+      passed ?
+         EXIT_SUCCESS :
+         EXIT_FAILURE;
+}
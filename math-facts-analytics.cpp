@@ -0,0 +1,277 @@
+#include "fact-id.hpp"
+#include "fact-operation.hpp"
+#include "mapped-file.hpp"
+#include "report-analytics.hpp"
+#include "report-parser.hpp"
+#include "work-stealing-pool.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// summarizes every text report below a reports directory:
+//
+//    math-facts-analytics <reports directory> [--threads <count>]
+//
+// each report is memory mapped and parsed by one task of a work stealing
+// pool.  every worker folds its reports into its own aggregate, and the
+// aggregates are merged once all reports have been parsed.
+
+static void PrintUsage( )
+{
+   std::cerr
+      << "usage: math-facts-analytics <reports directory> [--threads <count>]\n";
+}
+
+static void PrintLatency(
+   std::ostream & output,
+   const LatencyAggregate & latency )
+{
+   const auto & histogram =
+      latency.ResponseTimeHistogram();
+
+   output
+      << "answers = "
+      << latency.Count()
+      << "; mean ms = "
+      << std::llround(latency.MeanResponseTime())
+      << "; p50 ms = "
+      << histogram.Percentile(50.0)
+      << "; p90 ms = "
+      << histogram.Percentile(90.0)
+      << "; p99 ms = "
+      << histogram.Percentile(99.0)
+      << "; retry rate = "
+      << latency.RetryRate()
+      << "; retries per answer = "
+      << latency.RetriesPerAnswer();
+}
+
+int main(
+   int argc,
+   char ** argv )
+{
+   std::filesystem::path reports_directory;
+   size_t threads { };
+
+   for (int i { 1 }; i < argc; ++i)
+   {
+      const std::string_view argument {
+         argv[i]
+      };
+
+      if (argument == "--threads" && i + 1 < argc)
+      {
+         threads =
+            std::strtoul(
+               argv[++i],
+               nullptr,
+               10);
+      }
+      else if (reports_directory.empty() && !argument.starts_with("--"))
+      {
+         reports_directory = argument;
+      }
+      else
+      {
+         PrintUsage();
+
+         return
+            EXIT_FAILURE;
+      }
+   }
+
+   std::error_code error;
+
+   if (reports_directory.empty() ||
+       !std::filesystem::is_directory(reports_directory, error))
+   {
+      PrintUsage();
+
+      return
+         EXIT_FAILURE;
+   }
+
+   const auto scan_start =
+      std::chrono::steady_clock::now();
+
+   std::vector< ReportAggregate > aggregates;
+   size_t report_files { };
+
+   {
+      WorkStealingPool pool {
+         threads
+      };
+
+      aggregates.resize(
+         pool.WorkerCount());
+
+      for (std::filesystem::recursive_directory_iterator entry {
+              reports_directory,
+              std::filesystem::directory_options::skip_permission_denied,
+              error };
+           !error && entry != std::filesystem::recursive_directory_iterator { };
+           entry.increment(error))
+      {
+         std::error_code status_error;
+
+         if (!entry->is_regular_file(status_error) ||
+             entry->path().extension() != ".txt")
+         {
+            continue;
+         }
+
+         ++report_files;
+
+         pool.Submit(
+            [ &aggregates, path = entry->path() ] (
+               const size_t worker_index )
+            {
+               // reused by every report the worker parses
+               thread_local std::vector< ParsedAnswer > answers;
+
+               answers.clear();
+
+               const MappedFile report {
+                  path
+               };
+
+               const std::string report_name =
+                  path.stem().string();
+
+               std::string_view username;
+               std::string_view date_time;
+
+               const bool parsed =
+                  report.IsOpen() &&
+                  ParseReportName(report_name, username, date_time) &&
+                  ParseReport(report.View(), answers);
+
+               if (parsed)
+               {
+                  aggregates[worker_index].AddReport(
+                     username,
+                     date_time,
+                     answers);
+               }
+               else
+               {
+                  aggregates[worker_index].AddSkippedReport();
+               }
+            });
+      }
+
+      pool.Wait();
+   }
+
+   ReportAggregate total;
+
+   for (auto & aggregate : aggregates)
+   {
+      total.Merge(
+         std::move(aggregate));
+   }
+
+   const auto scan_time =
+      std::chrono::duration_cast<
+         std::chrono::milliseconds >(
+            std::chrono::steady_clock::now() -
+            scan_start);
+
+   std::ios_base::sync_with_stdio(false);
+
+   auto & output =
+      std::cout;
+
+   output
+      << "report files = "
+      << report_files
+      << "; parsed = "
+      << total.Reports()
+      << "; skipped = "
+      << total.SkippedReports()
+      << "; answers = "
+      << total.Answers()
+      << "; scan time ms = "
+      << scan_time.count()
+      << "\n";
+
+   output
+      << "\nper operation\n";
+
+   for (size_t operation { }; operation < FACT_OPERATION_COUNT; ++operation)
+   {
+      const auto & latency =
+         total.Operation(
+            static_cast< FactOperation >(operation));
+
+      if (latency.Count())
+      {
+         output
+            << FactOperationName(static_cast< FactOperation >(operation))
+            << "; ";
+
+         PrintLatency(
+            output,
+            latency);
+
+         output << "\n";
+      }
+   }
+
+   output
+      << "\nper student\n";
+
+   for (const auto & [username, student] : total.GetStudents())
+   {
+      output
+         << username
+         << "; sessions = "
+         << student.sessions.size()
+         << "; ";
+
+      PrintLatency(
+         output,
+         student.latency);
+
+      output
+         << "; trend ms per session = "
+         << std::llround(SessionTrend(student.sessions))
+         << "\n";
+   }
+
+   output
+      << "\nper fact\n";
+
+   for (uint16_t fact_id { }; fact_id < FACT_ID_COUNT; ++fact_id)
+   {
+      const auto latency =
+         total.Fact(
+            fact_id);
+
+      if (latency)
+      {
+         output
+            << FormatFact(fact_id)
+            << "; ";
+
+         PrintLatency(
+            output,
+            *latency);
+
+         output << "\n";
+      }
+   }
+
+   output.flush();
+
+   return
+      EXIT_SUCCESS;
+}
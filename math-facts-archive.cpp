@@ -0,0 +1,197 @@
+#include "report-archive.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// lists and extracts the reports and session files of a monthly bundle
+// written by the report archiving:
+//
+//    math-facts-archive <bundle> [--extract <name>] [--output <directory>]
+//
+//    --extract <name>        file of the bundle to extract, or * for every
+//                            file; without it, the files are listed
+//    --output <directory>    where extracted files are written; defaults
+//                            to the current directory
+//
+// the analytics, the history and the dashboard do not look into bundles;
+// extracting a bundle into the reports directory makes its sessions seen
+// by them again.  the bundle itself is left as it is, and files that
+// already exist are never overwritten.
+
+static void PrintUsage( )
+{
+   std::cerr
+      << "usage: math-facts-archive <bundle> [--extract <name>]\n"
+         "          [--output <directory>]\n";
+}
+
+static bool WriteExtractedFile(
+   const std::filesystem::path & path,
+   const QByteArray & data )
+{
+   std::error_code error;
+
+   if (std::filesystem::exists(path, error))
+      return false;
+
+   std::ofstream file {
+      path,
+      std::ios_base::out | std::ios_base::binary
+   };
+
+   file.write(
+      data.constData(),
+      data.size());
+
+   return
+      static_cast< bool >(file.flush());
+}
+
+int main(
+   int argc,
+   char ** argv )
+{
+   std::filesystem::path bundle_path;
+   std::string extract_name;
+   std::filesystem::path output_directory { "." };
+
+   for (int i { 1 }; i < argc; ++i)
+   {
+      const std::string_view argument {
+         argv[i]
+      };
+
+      if (argument == "--extract" && i + 1 < argc)
+      {
+         extract_name = argv[++i];
+      }
+      else if (argument == "--output" && i + 1 < argc)
+      {
+         output_directory = argv[++i];
+      }
+      else if (bundle_path.empty() && !argument.starts_with("--"))
+      {
+         bundle_path = argument;
+      }
+      else
+      {
+         PrintUsage();
+
+         return
+            EXIT_FAILURE;
+      }
+   }
+
+   if (bundle_path.empty())
+   {
+      PrintUsage();
+
+      return
+         EXIT_FAILURE;
+   }
+
+   std::vector< ArchiveEntry > entries;
+
+   if (!ReadArchiveIndex(bundle_path, entries))
+   {
+      std::cerr
+         << "cannot read the bundle '"
+         << bundle_path.string()
+         << "'\n";
+
+      return
+         EXIT_FAILURE;
+   }
+
+   std::ios_base::sync_with_stdio(false);
+
+   auto & output =
+      std::cout;
+
+   if (extract_name.empty())
+   {
+      for (const auto & entry : entries)
+      {
+         output
+            << "name = "
+            << entry.name.toStdString()
+            << "; size = "
+            << entry.size
+            << "; compressed size = "
+            << entry.compressed_size
+            << "; modified unix ms = "
+            << entry.modified_unix_ms
+            << "\n";
+      }
+
+      return
+         EXIT_SUCCESS;
+   }
+
+   std::error_code error;
+
+   std::filesystem::create_directories(
+      output_directory,
+      error);
+
+   size_t extracted { };
+   size_t failed { };
+
+   for (const auto & entry : entries)
+   {
+      const std::string name =
+         entry.name.toStdString();
+
+      if (extract_name != "*" && extract_name != name)
+         continue;
+
+      QByteArray data;
+
+      // only a plain file name is ever written, whatever the index holds
+      const std::filesystem::path file_name =
+         std::filesystem::path { name }.filename();
+
+      const bool written =
+         !file_name.empty() &&
+         file_name == std::filesystem::path { name } &&
+         ExtractArchiveEntry(bundle_path, entry, data) &&
+         WriteExtractedFile(output_directory / file_name, data);
+
+      if (written)
+      {
+         ++extracted;
+      }
+      else
+      {
+         ++failed;
+
+         std::cerr
+            << "cannot extract '"
+            << name
+            << "'\n";
+      }
+   }
+
+   output
+      << "extracted = "
+      << extracted
+      << "; failed = "
+      << failed
+      << "\n";
+
+   return
+      extracted && !failed ?
+         EXIT_SUCCESS :
+         EXIT_FAILURE;
+}
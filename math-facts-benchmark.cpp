@@ -0,0 +1,779 @@
+#include "answer-record.hpp"
+#include "fact-id.hpp"
+#include "fact-operation.hpp"
+#include "fact-sampler.hpp"
+#include "fact-table.hpp"
+#include "math-facts-settings.hpp"
+#include "session-report.hpp"
+#include "session-statistics.hpp"
+
+#include <QtCore/QCoreApplication>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// times the hot paths of a practice that do not paint:
+//
+//    math-facts-benchmark [options]
+//
+//    --baseline <file>        compare against the times in this file
+//    --write-baseline <file>  store the times measured in this file
+//    --tolerance <percent>    slowdown over the baseline that is still
+//                             accepted; defaults to 25
+//    --filter <text>          only run benchmarks whose name contains it
+//    --min-time <ms>          time each repetition runs at least;
+//                             defaults to 100
+//
+// every benchmark is repeated five times and the fastest repetition is
+// kept, as the slower ones only measure interference.  the exit status
+// is a failure once any benchmark is slower than its baseline allows.
+// baselines only compare runs on the same machine and build type.
+
+static void PrintUsage( )
+{
+   std::cerr
+      << "usage: math-facts-benchmark [--baseline <file>] [--write-baseline <file>]\n"
+         "          [--tolerance <percent>] [--filter <text>] [--min-time <ms>]\n";
+}
+
+namespace
+{
+
+constexpr size_t REPETITIONS { 5 };
+
+// keeps the compiler from dropping the work of a benchmark
+volatile uint64_t sink;
+
+struct Benchmark
+{
+   std::string name;
+   // operations done by one run
+   size_t operations;
+   std::function< uint64_t ( ) > run;
+};
+
+// the fastest repetition, in nanoseconds per operation
+double Measure(
+   const Benchmark & benchmark,
+   const std::chrono::milliseconds min_time )
+{
+   double fastest { };
+
+   for (size_t repetition { }; repetition < REPETITIONS; ++repetition)
+   {
+      const auto start =
+         std::chrono::steady_clock::now();
+
+      uint64_t runs { };
+      std::chrono::steady_clock::duration elapsed { };
+
+      do
+      {
+         sink = sink + benchmark.run();
+
+         ++runs;
+
+         elapsed =
+            std::chrono::steady_clock::now() - start;
+      }
+      while (elapsed < min_time);
+
+      const double nanoseconds =
+         std::chrono::duration< double, std::nano > { elapsed }.count() /
+         static_cast< double >(runs * benchmark.operations);
+
+      fastest =
+         repetition == 0 ?
+            nanoseconds :
+            std::min(
+               fastest,
+               nanoseconds);
+   }
+
+   return
+      fastest;
+}
+
+// a flat json object of benchmark names and nanoseconds per operation
+bool ReadBaseline(
+   const std::filesystem::path & path,
+   std::map< std::string, double > & baseline )
+{
+   std::ifstream file {
+      path
+   };
+
+   if (!file)
+      return false;
+
+   const std::string text {
+      std::istreambuf_iterator< char > { file },
+      std::istreambuf_iterator< char > { }
+   };
+
+   size_t position { };
+
+   const auto SkipSpace =
+      [ & ] ( )
+      {
+         while (position < text.size() &&
+                std::string_view { " \t\r\n" }.find(text[position]) != std::string_view::npos)
+         {
+            ++position;
+         }
+      };
+
+   const auto Expect =
+      [ & ] (
+         const char character )
+      {
+         SkipSpace();
+
+         if (position >= text.size() || text[position] != character)
+            return false;
+
+         ++position;
+
+         return true;
+      };
+
+   if (!Expect('{'))
+      return false;
+
+   SkipSpace();
+
+   if (position < text.size() && text[position] == '}')
+      return true;
+
+   do
+   {
+      if (!Expect('"'))
+         return false;
+
+      const size_t name_end =
+         text.find(
+            '"',
+            position);
+
+      if (name_end == std::string::npos)
+         return false;
+
+      std::string name =
+         text.substr(
+            position,
+            name_end - position);
+
+      position = name_end + 1;
+
+      if (!Expect(':'))
+         return false;
+
+      SkipSpace();
+
+      const char * const number_begin =
+         text.c_str() + position;
+      char * number_end { };
+
+      const double nanoseconds =
+         std::strtod(
+            number_begin,
+            &number_end);
+
+      if (number_end == number_begin)
+         return false;
+
+      position += number_end - number_begin;
+
+      baseline[std::move(name)] = nanoseconds;
+   }
+   while (Expect(','));
+
+   return
+      Expect('}');
+}
+
+bool WriteBaseline(
+   const std::filesystem::path & path,
+   const std::vector< std::pair< std::string, double > > & results )
+{
+   std::ostringstream json;
+
+   json
+      << std::fixed
+      << std::setprecision(1)
+      << "{";
+
+   for (size_t i { }; i < results.size(); ++i)
+   {
+      json
+         << (i ? ",\n" : "\n")
+         << "   \""
+         << results[i].first
+         << "\": "
+         << results[i].second;
+   }
+
+   json
+      << "\n}\n";
+
+   const std::string text =
+      json.str();
+
+   return
+      WriteFileAtomically(
+         path,
+         text.data(),
+         text.size());
+}
+
+// answers cycling through every fact, with the response times of a
+// student and every fourth fact answered wrong first
+std::vector< AnswerRecord > MakeAnswers(
+   const size_t count )
+{
+   std::vector< uint16_t > fact_ids;
+
+   for (size_t operation { }; operation < FACT_OPERATION_COUNT; ++operation)
+   {
+      const auto table =
+         GetFactTable(
+            static_cast< FactOperation >(operation));
+
+      fact_ids.insert(
+         fact_ids.end(),
+         table.cbegin(),
+         table.cend());
+   }
+
+   std::default_random_engine random_engine { 7 };
+   std::uniform_int_distribution< uint32_t > response_time_distribution {
+      800, 9000
+   };
+
+   std::vector< AnswerRecord > answers;
+   answers.reserve(count);
+
+   uint64_t answered_at_ms { };
+
+   for (size_t i { }; i < count; ++i)
+   {
+      const uint16_t fact_id =
+         fact_ids[i % fact_ids.size()];
+      const FactOperation operation =
+         FactIdOperation(
+            fact_id);
+
+      const uint32_t response_time_ms =
+         response_time_distribution(
+            random_engine);
+
+      answered_at_ms += response_time_ms;
+
+      const int32_t answer =
+         operation == FactOperation::TIME ?
+            EncodeTimeResponse(GetTimeAnswer(fact_id)) :
+            GetArithmeticAnswer(fact_id);
+
+      AnswerRecord record {
+         fact_id,
+         operation,
+         answered_at_ms,
+         response_time_ms,
+         response_time_ms * 2 / 3,
+         response_time_ms / 3,
+         5,
+         { },
+         FormatFact(fact_id)
+      };
+
+      if (i % 4 == 0)
+      {
+         record.responses.push_back(
+            answer + 1);
+      }
+
+      record.responses.push_back(
+         answer);
+
+      answers.push_back(
+         std::move(record));
+   }
+
+   return
+      answers;
+}
+
+void AddStatistics(
+   SessionStatistics & statistics,
+   const AnswerRecord & answer ) noexcept
+{
+   statistics.Add(
+      SessionStatistics::Answer {
+         answer.operation,
+         std::chrono::milliseconds { answer.response_time_ms },
+         std::chrono::milliseconds { answer.think_time_ms },
+         std::chrono::milliseconds { answer.typing_time_ms },
+         std::chrono::milliseconds { answer.ui_latency_ms },
+         answer.responses.size()
+      });
+}
+
+SessionSnapshot MakeSnapshot(
+   std::vector< AnswerRecord > answers,
+   const std::filesystem::path & reports_directory )
+{
+   SessionSnapshot snapshot { };
+
+   snapshot.username = "benchmark";
+   snapshot.end_time = std::chrono::system_clock::time_point { std::chrono::hours { 480000 } };
+   snapshot.reports_directory = reports_directory;
+   snapshot.header.practice_duration_ms = 300000;
+   snapshot.header.minimum_amount_to_practice = 50;
+   snapshot.header.enabled_math_facts = 0x1F;
+   snapshot.header.chosen_problems = 5;
+
+   for (const auto & answer : answers)
+   {
+      AddStatistics(
+         snapshot.statistics,
+         answer);
+   }
+
+   snapshot.answers =
+      std::move(answers);
+
+   return
+      snapshot;
+}
+
+} // namespace
+
+int main(
+   int argc,
+   char ** argv )
+{
+   // the settings are found next to the application
+   QCoreApplication application {
+      argc,
+      argv
+   };
+
+   std::filesystem::path baseline_path;
+   std::filesystem::path write_baseline_path;
+   double tolerance_percent { 25.0 };
+   std::string filter;
+   std::chrono::milliseconds min_time { 100 };
+
+   for (int i { 1 }; i < argc; ++i)
+   {
+      const std::string_view argument {
+         argv[i]
+      };
+
+      bool valid { i + 1 < argc };
+
+      if (!valid)
+      {
+      }
+      else if (argument == "--baseline")
+      {
+         baseline_path = argv[i + 1];
+      }
+      else if (argument == "--write-baseline")
+      {
+         write_baseline_path = argv[i + 1];
+      }
+      else if (argument == "--tolerance")
+      {
+         tolerance_percent =
+            std::strtod(
+               argv[i + 1],
+               nullptr);
+
+         valid = tolerance_percent >= 0.0;
+      }
+      else if (argument == "--filter")
+      {
+         filter = argv[i + 1];
+      }
+      else if (argument == "--min-time")
+      {
+         min_time =
+            std::chrono::milliseconds {
+               std::strtoull(argv[i + 1], nullptr, 10)
+            };
+
+         valid = min_time.count() > 0;
+      }
+      else
+      {
+         valid = false;
+      }
+
+      if (!valid)
+      {
+         PrintUsage();
+
+         return
+            EXIT_FAILURE;
+      }
+
+      ++i;
+   }
+
+   std::map< std::string, double > baseline;
+
+   if (!baseline_path.empty() &&
+       !ReadBaseline(baseline_path, baseline))
+   {
+      std::cerr
+         << "cannot read the baseline '"
+         << baseline_path.string()
+         << "'\n";
+
+      return
+         EXIT_FAILURE;
+   }
+
+   std::error_code error;
+
+   // one per process, so that runs at the same time keep to their own
+   const auto work_directory =
+      std::filesystem::temp_directory_path(error) /
+      ("math-facts-benchmark-" +
+       std::to_string(QCoreApplication::applicationPid()));
+
+   std::filesystem::create_directories(
+      work_directory,
+      error);
+
+   const auto settings_path =
+      work_directory /
+      "math-facts.ini";
+
+   std::ofstream {
+      settings_path
+   }
+      << "enabled_math_facts=1f\n"
+         "reports_directory=../math-facts-reports/\n"
+         "math_practice_duration_ms=300000\n"
+         "minimum_amount_to_practice=50\n"
+         "archive_reports_after_days=30\n"
+         "export_formats=0\n";
+
+   std::vector< Benchmark > benchmarks;
+
+   for (size_t operation { }; operation < FACT_OPERATION_COUNT; ++operation)
+   {
+      const auto fact_operation =
+         static_cast< FactOperation >(operation);
+
+      // filling a pool is what every Generate*Problem did for its operation
+      benchmarks.push_back(
+         Benchmark {
+            std::string { "pool/" } +
+               FactOperationName(fact_operation),
+            1,
+            [ fact_operation, sampler = std::make_shared< FactSampler >(1u) ] ( )
+            {
+               sampler->SetOperations(
+                  1u << static_cast< uint32_t >(fact_operation));
+
+               return
+                  sampler->Remaining(
+                     fact_operation);
+            }
+         });
+   }
+
+   const auto sampler =
+      std::make_shared< FactSampler >(
+         1u);
+
+   sampler->SetOperations(
+      0x1F);
+
+   // includes refilling the pools whenever every fact was drawn
+   benchmarks.push_back(
+      Benchmark {
+         "sample/next",
+         1000,
+         [ sampler ] ( )
+         {
+            uint64_t sum { };
+
+            for (size_t i { }; i < 1000; ++i)
+            {
+               sum += sampler->Next();
+            }
+
+            return
+               sum;
+         }
+      });
+
+   std::vector< uint16_t > arithmetic_facts;
+   std::vector< int32_t > arithmetic_responses;
+   std::vector< uint16_t > time_facts;
+   std::vector< std::string > time_responses;
+
+   for (size_t operation { }; operation < FACT_OPERATION_COUNT; ++operation)
+   {
+      for (const uint16_t fact_id :
+              GetFactTable(static_cast< FactOperation >(operation)))
+      {
+         if (static_cast< FactOperation >(operation) == FactOperation::TIME)
+         {
+            time_facts.push_back(fact_id);
+            time_responses.push_back(GetTimeAnswer(fact_id));
+         }
+         else
+         {
+            arithmetic_facts.push_back(fact_id);
+            arithmetic_responses.push_back(GetArithmeticAnswer(fact_id) + (fact_id & 1));
+         }
+      }
+   }
+
+   benchmarks.push_back(
+      Benchmark {
+         "grade/arithmetic",
+         arithmetic_facts.size(),
+         [ & ] ( )
+         {
+            uint64_t correct { };
+
+            for (size_t i { }; i < arithmetic_facts.size(); ++i)
+            {
+               correct +=
+                  GradeArithmeticResponse(
+                     arithmetic_facts[i],
+                     arithmetic_responses[i]);
+            }
+
+            return
+               correct;
+         }
+      });
+
+   benchmarks.push_back(
+      Benchmark {
+         "grade/time",
+         time_facts.size(),
+         [ & ] ( )
+         {
+            uint64_t correct { };
+
+            for (size_t i { }; i < time_facts.size(); ++i)
+            {
+               correct +=
+                  GradeTimeResponse(
+                     time_facts[i],
+                     time_responses[i]);
+            }
+
+            return
+               correct;
+         }
+      });
+
+   // the snapshots outlive the benchmarks that use them
+   std::vector< std::shared_ptr< const SessionSnapshot > > snapshots;
+
+   for (size_t answer_count { 100 }; answer_count <= 1000000; answer_count *= 10)
+   {
+      const auto snapshot =
+         std::make_shared< const SessionSnapshot >(
+            MakeSnapshot(
+               MakeAnswers(answer_count),
+               work_directory / "reports"));
+
+      snapshots.push_back(
+         snapshot);
+
+      const std::string size =
+         std::to_string(
+            answer_count);
+
+      // the statistics are kept as answers come in, so the standard
+      // deviation costs the adding of every answer
+      benchmarks.push_back(
+         Benchmark {
+            "statistics/standard-deviation/" + size,
+            answer_count,
+            [ snapshot ] ( )
+            {
+               SessionStatistics statistics;
+
+               for (const auto & answer : snapshot->answers)
+               {
+                  AddStatistics(
+                     statistics,
+                     answer);
+               }
+
+               return
+                  static_cast< uint64_t >(
+                     statistics.StandardDeviationResponseTime().count());
+            }
+         });
+
+      benchmarks.push_back(
+         Benchmark {
+            "report/format/" + size,
+            answer_count,
+            [ snapshot ] ( )
+            {
+               return
+                  FormatSessionReport(
+                     *snapshot).size();
+            }
+         });
+
+      benchmarks.push_back(
+         Benchmark {
+            "report/write/" + size,
+            answer_count,
+            [ snapshot ] ( )
+            {
+               return
+                  WriteSessionReport(
+                     *snapshot).written;
+            }
+         });
+   }
+
+   benchmarks.push_back(
+      Benchmark {
+         "settings/find",
+         1,
+         [ ] ( )
+         {
+            return
+               FindSettingsFile(
+                  "benchmark").native().size();
+         }
+      });
+
+   benchmarks.push_back(
+      Benchmark {
+         "settings/load",
+         1,
+         [ settings_path ] ( )
+         {
+            const auto settings =
+               LoadSettings(
+                  settings_path);
+
+            return
+               settings ?
+                  settings->enabled_math_facts :
+                  0u;
+         }
+      });
+
+   std::ios_base::sync_with_stdio(false);
+
+   auto & output =
+      std::cout;
+
+   output
+      << std::fixed
+      << std::setprecision(1);
+
+   std::vector< std::pair< std::string, double > > results;
+   size_t regressions { };
+
+   for (const auto & benchmark : benchmarks)
+   {
+      if (benchmark.name.find(filter) == std::string::npos)
+         continue;
+
+      const double nanoseconds =
+         Measure(
+            benchmark,
+            min_time);
+
+      results.emplace_back(
+         benchmark.name,
+         nanoseconds);
+
+      output
+         << "benchmark = "
+         << benchmark.name
+         << "; ns per operation = "
+         << nanoseconds;
+
+      if (const auto expected = baseline.find(benchmark.name);
+          expected != baseline.end() && expected->second > 0.0)
+      {
+         const double change_percent =
+            (nanoseconds / expected->second - 1.0) * 100.0;
+
+         const bool regressed =
+            change_percent > tolerance_percent;
+
+         regressions += regressed;
+
+         output
+            << "; baseline = "
+            << expected->second
+            << "; change = "
+            << std::showpos
+            << change_percent
+            << std::noshowpos
+            << "%"
+            << (regressed ? "; regressed" : "");
+      }
+
+      output
+         << std::endl;
+   }
+
+   output
+      << "benchmarks = "
+      << results.size()
+      << "; regressions = "
+      << regressions
+      << "\n";
+
+   std::filesystem::remove_all(
+      work_directory,
+      error);
+
+   if (!write_baseline_path.empty() &&
+       !WriteBaseline(write_baseline_path, results))
+   {
+      std::cerr
+         << "cannot write the baseline '"
+         << write_baseline_path.string()
+         << "'\n";
+
+      return
+         EXIT_FAILURE;
+   }
+
+   return
+      regressions ?
+         EXIT_FAILURE :
+         EXIT_SUCCESS;
+}
@@ -0,0 +1,373 @@
+#include "fact-id.hpp"
+#include "fact-operation.hpp"
+#include "practice-history.hpp"
+#include "report-parser.hpp"
+#include "roaring-bitmap.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+// answers questions about every answer ever given in a reports directory:
+//
+//    math-facts-history <reports directory> [options]
+//
+//    --index <path>         index file; defaults to practice-history.mfx
+//                           in the reports directory
+//    --fact <fact>          such as "7 * 8", "clock 3:05" or "military 15:05"
+//    --operation <name>     addition, subtraction, multiplication,
+//                           division or time
+//    --student <name>
+//    --from <YYYY-MM-DD>    first day, inclusive
+//    --to <YYYY-MM-DD>      last day, inclusive
+//    --month <YYYY-MM>
+//    --missed               answers that needed more than one response
+//    --first-try            answers that were right on the first response
+//    --min-ms <ms>          response time range, inclusive
+//    --max-ms <ms>
+//    --by student|fact|day  count the selected answers per group
+//    --more-than <count>    only groups with more answers than count
+//
+// e.g. the students that missed 7 * 8 more than twice this month:
+//
+//    math-facts-history reports --fact "7 * 8" --missed --month 2026-10
+//       --by student --more-than 2
+//
+// the index is brought up to date with the reports directory before
+// every query, reading only the sessions that were not indexed yet.
+
+static void PrintUsage( )
+{
+   std::cerr
+      << "usage: math-facts-history <reports directory> [--index <path>]\n"
+         "          [--fact <fact>] [--operation <name>] [--student <name>]\n"
+         "          [--from <YYYY-MM-DD>] [--to <YYYY-MM-DD>] [--month <YYYY-MM>]\n"
+         "          [--missed | --first-try] [--min-ms <ms>] [--max-ms <ms>]\n"
+         "          [--by student|fact|day] [--more-than <count>]\n";
+}
+
+static bool ParseFactArgument(
+   const std::string_view argument,
+   uint16_t & fact_id )
+{
+   // the same spelling as FormatFact, mapped onto the report questions
+   std::string question;
+
+   if (argument.starts_with("clock "))
+   {
+      question = "What time is it? It is ";
+      question += argument.substr(6);
+   }
+   else if (argument.starts_with("military "))
+   {
+      question = "What military time is it? It is ";
+      question += argument.substr(9);
+   }
+   else
+   {
+      question = argument;
+   }
+
+   FactOperation operation { };
+
+   return
+      ParseFact(
+         question,
+         fact_id,
+         operation);
+}
+
+static bool ParseOperationArgument(
+   const std::string_view argument,
+   FactOperation & operation ) noexcept
+{
+   for (size_t i { }; i < FACT_OPERATION_COUNT; ++i)
+   {
+      if (argument == FactOperationName(static_cast< FactOperation >(i)))
+      {
+         operation = static_cast< FactOperation >(i);
+
+         return true;
+      }
+   }
+
+   return false;
+}
+
+static std::string FormatDay(
+   const int32_t day )
+{
+   const std::chrono::year_month_day date {
+      std::chrono::sys_days { std::chrono::days { day } }
+   };
+
+   char text[16] { };
+
+   std::snprintf(
+      text,
+      sizeof(text),
+      "%04d-%02u-%02u",
+      static_cast< int >(date.year()),
+      static_cast< unsigned >(date.month()),
+      static_cast< unsigned >(date.day()));
+
+   return
+      text;
+}
+
+int main(
+   int argc,
+   char ** argv )
+{
+   std::filesystem::path reports_directory;
+   std::filesystem::path index_path;
+   HistoryQuery query;
+   std::string_view group_by;
+   uint64_t more_than { };
+
+   for (int i { 1 }; i < argc; ++i)
+   {
+      const std::string_view argument {
+         argv[i]
+      };
+
+      const std::string_view value {
+         i + 1 < argc ? argv[i + 1] : ""
+      };
+
+      bool valid { true };
+
+      if (argument == "--missed")
+      {
+         query.outcome = AnswerOutcome::RETRIED;
+
+         continue;
+      }
+      else if (argument == "--first-try")
+      {
+         query.outcome = AnswerOutcome::FIRST_TRY;
+
+         continue;
+      }
+      else if (!argument.starts_with("--"))
+      {
+         valid = reports_directory.empty();
+         reports_directory = argument;
+
+         if (valid)
+            continue;
+      }
+      else if (i + 1 >= argc)
+      {
+         valid = false;
+      }
+      else if (argument == "--index")
+      {
+         index_path = value;
+      }
+      else if (argument == "--fact")
+      {
+         uint16_t fact_id { };
+
+         valid = ParseFactArgument(value, fact_id);
+         query.fact_id = fact_id;
+      }
+      else if (argument == "--operation")
+      {
+         FactOperation operation { };
+
+         valid = ParseOperationArgument(value, operation);
+         query.operation = operation;
+      }
+      else if (argument == "--student")
+      {
+         query.student = std::string { value };
+      }
+      else if (argument == "--from" || argument == "--to")
+      {
+         int32_t day { };
+
+         valid = PracticeHistory::ParseReportDay(value, day);
+         (argument == "--from" ? query.first_day : query.last_day) = day;
+      }
+      else if (argument == "--month")
+      {
+         int32_t first_day { };
+
+         valid =
+            PracticeHistory::ParseReportDay(
+               std::string { value } + "-01",
+               first_day);
+
+         if (valid)
+         {
+            const std::chrono::year_month_day first {
+               std::chrono::sys_days { std::chrono::days { first_day } }
+            };
+            const std::chrono::year_month_day_last last {
+               first.year(),
+               std::chrono::month_day_last { first.month() }
+            };
+
+            query.first_day = first_day;
+            query.last_day =
+               static_cast< int32_t >(
+                  std::chrono::sys_days { last }.time_since_epoch().count());
+         }
+      }
+      else if (argument == "--min-ms" || argument == "--max-ms")
+      {
+         (argument == "--min-ms" ?
+            query.min_response_time_ms :
+            query.max_response_time_ms) =
+            static_cast< uint32_t >(
+               std::strtoul(
+                  argv[i + 1],
+                  nullptr,
+                  10));
+      }
+      else if (argument == "--by")
+      {
+         group_by = value;
+         valid = value == "student" || value == "fact" || value == "day";
+      }
+      else if (argument == "--more-than")
+      {
+         more_than =
+            std::strtoull(
+               argv[i + 1],
+               nullptr,
+               10);
+      }
+      else
+      {
+         valid = false;
+      }
+
+      if (!valid)
+      {
+         PrintUsage();
+
+         return
+            EXIT_FAILURE;
+      }
+
+      ++i;
+   }
+
+   std::error_code error;
+
+   if (reports_directory.empty() ||
+       !std::filesystem::is_directory(reports_directory, error))
+   {
+      PrintUsage();
+
+      return
+         EXIT_FAILURE;
+   }
+
+   if (index_path.empty())
+   {
+      index_path =
+         reports_directory /
+         PracticeHistory::INDEX_FILE_NAME;
+   }
+
+   const auto update_start =
+      std::chrono::steady_clock::now();
+
+   PracticeHistory history;
+
+   // a missing or damaged index is rebuilt from the reports
+   history.Load(
+      index_path);
+
+   if (history.Update(reports_directory) &&
+       !history.Save(index_path))
+   {
+      std::cerr
+         << "could not write the index "
+         << index_path.string()
+         << "\n";
+   }
+
+   const auto query_start =
+      std::chrono::steady_clock::now();
+
+   const RoaringBitmap answers =
+      history.Select(
+         query);
+
+   std::ios_base::sync_with_stdio(false);
+
+   auto & output =
+      std::cout;
+
+   const auto PrintGroup =
+      [ & ] (
+         const std::string & group,
+         const uint64_t count )
+      {
+         if (count > more_than)
+         {
+            output
+               << group
+               << "; answers = "
+               << count
+               << "\n";
+         }
+      };
+
+   if (group_by == "student")
+   {
+      for (const auto & [username, count] : history.CountByStudent(answers))
+      {
+         PrintGroup(username, count);
+      }
+   }
+   else if (group_by == "fact")
+   {
+      for (const auto & [fact_id, count] : history.CountByFact(answers))
+      {
+         PrintGroup(FormatFact(fact_id), count);
+      }
+   }
+   else if (group_by == "day")
+   {
+      for (const auto & [day, count] : history.CountByDay(answers))
+      {
+         PrintGroup(FormatDay(day), count);
+      }
+   }
+
+   const auto query_end =
+      std::chrono::steady_clock::now();
+
+   output
+      << "matching answers = "
+      << answers.Cardinality()
+      << "; indexed answers = "
+      << history.Answers()
+      << "; index bytes = "
+      << history.SizeInBytes()
+      << "; update ms = "
+      << std::chrono::duration_cast< std::chrono::milliseconds >(
+            query_start - update_start).count()
+      << "; query us = "
+      << std::chrono::duration_cast< std::chrono::microseconds >(
+            query_end - query_start).count()
+      << "\n";
+
+   output.flush();
+
+   return
+      EXIT_SUCCESS;
+}
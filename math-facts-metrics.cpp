@@ -0,0 +1,285 @@
+#include "live-metrics.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// samples the live metrics of every practice running on this host:
+//
+//    math-facts-metrics [options]
+//
+//    --interval <ms>    time between samples; defaults to 1000
+//    --count <samples>  stop after this many samples; 0, the default,
+//                       samples until interrupted
+//    --rescan <ms>      how often to look for practices that started or
+//                       ended; defaults to 1000
+//
+// the segments stay mapped between samples, so a sample only copies
+// memory and never waits for, or wakes up, the practices themselves.
+
+static void PrintUsage( )
+{
+   std::cerr
+      << "usage: math-facts-metrics [--interval <ms>] [--count <samples>]\n"
+         "          [--rescan <ms>]\n";
+}
+
+// in the order of the stages of the practice widget
+static std::string_view StageName(
+   const uint64_t stage ) noexcept
+{
+   constexpr std::string_view names[] {
+      "title",
+      "practice",
+      "overtime",
+      "session end",
+      "results"
+   };
+
+   return
+      stage < std::size(names) ?
+         names[stage] :
+         "unknown";
+}
+
+// upper bound of the bucket that holds the given fraction of the paints
+static uint64_t PaintTimePercentile(
+   const LiveMetricsData & data,
+   const double fraction ) noexcept
+{
+   if (!data.frames_painted)
+      return 0;
+
+   const uint64_t rank =
+      static_cast< uint64_t >(fraction * static_cast< double >(data.frames_painted));
+
+   uint64_t count { };
+
+   for (size_t bucket { }; bucket < LiveMetricsData::PAINT_TIME_BUCKETS; ++bucket)
+   {
+      count += data.paint_time_histogram[bucket];
+
+      if (count > rank)
+         return uint64_t { 1 } << bucket;
+   }
+
+   return
+      uint64_t { 1 } << LiveMetricsData::PAINT_TIME_BUCKETS;
+}
+
+int main(
+   int argc,
+   char ** argv )
+{
+   std::chrono::milliseconds interval { 1000 };
+   std::chrono::milliseconds rescan_interval { 1000 };
+   uint64_t count { };
+
+   for (int i { 1 }; i < argc; ++i)
+   {
+      const std::string_view argument {
+         argv[i]
+      };
+
+      bool valid { i + 1 < argc };
+
+      if (!valid)
+      {
+      }
+      else if (argument == "--interval")
+      {
+         interval =
+            std::chrono::milliseconds {
+               std::strtoull(argv[i + 1], nullptr, 10)
+            };
+
+         valid = interval.count() > 0;
+      }
+      else if (argument == "--count")
+      {
+         count =
+            std::strtoull(
+               argv[i + 1],
+               nullptr,
+               10);
+      }
+      else if (argument == "--rescan")
+      {
+         rescan_interval =
+            std::chrono::milliseconds {
+               std::strtoull(argv[i + 1], nullptr, 10)
+            };
+      }
+      else
+      {
+         valid = false;
+      }
+
+      if (!valid)
+      {
+         PrintUsage();
+
+         return
+            EXIT_FAILURE;
+      }
+
+      ++i;
+   }
+
+   struct Instance
+   {
+      std::unique_ptr< LiveMetricsReader > reader;
+      LiveMetricsData previous_data;
+      std::chrono::steady_clock::time_point previous_time;
+   };
+
+   std::map< uint32_t, Instance > instances;
+   std::chrono::steady_clock::time_point last_rescan;
+
+   std::ios_base::sync_with_stdio(false);
+
+   auto & output =
+      std::cout;
+
+   auto next_sample =
+      std::chrono::steady_clock::now();
+
+   for (uint64_t sample { }; count == 0 || sample < count; ++sample)
+   {
+      const auto now =
+         std::chrono::steady_clock::now();
+
+      if (sample == 0 || now - last_rescan >= rescan_interval)
+      {
+         last_rescan = now;
+
+         std::map< uint32_t, Instance > found;
+
+         for (const uint32_t process_id : FindLiveMetrics())
+         {
+            if (const auto instance = instances.find(process_id);
+                instance != instances.end())
+            {
+               found.emplace(
+                  process_id,
+                  std::move(instance->second));
+            }
+            else if (auto reader = std::make_unique< LiveMetricsReader >(process_id);
+                     reader->IsOpen())
+            {
+               found.emplace(
+                  process_id,
+                  Instance { std::move(reader), { }, { } });
+            }
+         }
+
+         instances =
+            std::move(found);
+      }
+
+      const uint64_t now_unix_ms =
+         static_cast< uint64_t >(
+            std::chrono::duration_cast<
+               std::chrono::milliseconds >(
+                  std::chrono::system_clock::now().time_since_epoch()).count());
+
+      output
+         << "sample = "
+         << sample
+         << "; instances = "
+         << instances.size()
+         << "\n";
+
+      for (auto & [process_id, instance] : instances)
+      {
+         LiveMetricsData data { };
+
+         if (!instance.reader->Read(data))
+         {
+            output
+               << "   pid = "
+               << process_id
+               << "; busy\n";
+
+            continue;
+         }
+
+         const auto elapsed =
+            std::chrono::duration< double > {
+               now - instance.previous_time
+            };
+
+         const double frames_per_second =
+            instance.previous_time.time_since_epoch().count() != 0 &&
+            elapsed.count() > 0.0 ?
+               static_cast< double >(
+                  data.frames_painted -
+                  instance.previous_data.frames_painted) / elapsed.count() :
+               0.0;
+
+         output
+            << "   pid = "
+            << process_id
+            << "; user = "
+            << instance.reader->Username()
+            << "; stage = "
+            << StageName(data.stage)
+            << "; frames = "
+            << data.frames_painted
+            << "; fps = "
+            << frames_per_second
+            << "; paint p50 us <= "
+            << PaintTimePercentile(data, 0.5)
+            << "; paint p99 us <= "
+            << PaintTimePercentile(data, 0.99)
+            << "; answered = "
+            << data.problems_answered
+            << "; retried = "
+            << data.retried_answers
+            << "; paint allocations = "
+            << data.paint_allocations
+            << "; allocating paints = "
+            << data.allocating_paints
+            << "; key press allocations = "
+            << data.key_press_allocations
+            << "; allocating key presses = "
+            << data.allocating_key_presses
+            << "; cache bytes = "
+            << data.cache_bytes
+            << "; journal queue = "
+            << data.journal_queue_depth
+            << "; journal dropped = "
+            << data.journal_dropped_records
+            << "; background tasks = "
+            << data.background_tasks
+            << "; age ms = "
+            << (now_unix_ms > data.updated_unix_ms ?
+                  now_unix_ms - data.updated_unix_ms :
+                  0)
+            << "\n";
+
+         instance.previous_data = data;
+         instance.previous_time = now;
+      }
+
+      output.flush();
+
+      if (count != 0 && sample + 1 >= count)
+         break;
+
+      next_sample += interval;
+
+      std::this_thread::sleep_until(
+         next_sample);
+   }
+
+   return
+      EXIT_SUCCESS;
+}
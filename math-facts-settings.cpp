@@ -0,0 +1,360 @@
+#include "math-facts-settings.hpp"
+#include "session-export.hpp"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QObject>
+#include <QtCore/QSettings>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <system_error>
+#include <utility>
+
+namespace
+{
+
+// addition, subtraction, multiplication, division and time
+constexpr uint32_t ALL_MATH_FACTS { 0x1F };
+
+constexpr int32_t DEFAULT_MATH_PRACTICE_DURATION_MS { 300000 };
+constexpr int32_t DEFAULT_MINIMUM_AMOUNT_TO_PRACTICE { 50 };
+constexpr const char * DEFAULT_REPORTS_DIRECTORY { "../math-facts-reports/" };
+
+// a hex bit pattern restricted to the known bits
+uint32_t ReadBits(
+   const QSettings & settings,
+   const char * const key,
+   const uint32_t default_bits,
+   const uint32_t known_bits ) noexcept
+{
+   bool valid { };
+
+   const uint32_t bits =
+      settings.value(
+         key,
+         QString::number(default_bits, 16)).toString().toUInt(
+            &valid,
+            16);
+
+   return
+      valid ?
+         bits & known_bits :
+         default_bits;
+}
+
+int32_t ReadInt(
+   const QSettings & settings,
+   const char * const key,
+   const int32_t default_value ) noexcept
+{
+   bool valid { };
+
+   const int32_t value =
+      settings.value(
+         key,
+         default_value).toInt(
+            &valid);
+
+   return
+      valid ?
+         value :
+         default_value;
+}
+
+} // namespace
+
+MathFactsSettings DefaultSettings(
+   const std::filesystem::path & path ) noexcept
+{
+   return
+      MathFactsSettings {
+         path,
+         ALL_MATH_FACTS,
+         DEFAULT_REPORTS_DIRECTORY,
+         std::chrono::milliseconds { DEFAULT_MATH_PRACTICE_DURATION_MS },
+         DEFAULT_MINIMUM_AMOUNT_TO_PRACTICE,
+         std::chrono::days { },
+         0,
+         false,
+         true
+      };
+}
+
+std::vector< std::filesystem::path > GetSettingsDirectories( ) noexcept
+{
+   std::vector< std::filesystem::path > directories;
+
+#if _MSC_VER
+   // started from visual studio, the working directory is the source tree
+   directories.push_back(
+      std::filesystem::current_path());
+#endif // _MSC_VER
+
+   directories.push_back(
+      QCoreApplication::applicationDirPath().toStdString());
+
+   return
+      directories;
+}
+
+std::filesystem::path FindSettingsFile(
+   const std::string & username ) noexcept
+{
+   const std::filesystem::path file_names[] {
+      username + "-math-facts.ini",
+      "math-facts.ini"
+   };
+
+   for (const auto & directory : GetSettingsDirectories())
+   {
+      for (const auto & file_name : file_names)
+      {
+         std::error_code error;
+
+         if (const auto settings_path = directory / file_name;
+             std::filesystem::is_regular_file(settings_path, error))
+         {
+            return
+               settings_path;
+         }
+      }
+   }
+
+   std::error_code error;
+
+   return
+      std::filesystem::absolute(
+         file_names[1],
+         error);
+}
+
+std::shared_ptr< const MathFactsSettings > LoadSettings(
+   const std::filesystem::path & path ) noexcept
+{
+   const QSettings settings {
+      QString::fromStdString(
+         path.string()),
+      QSettings::Format::IniFormat
+   };
+
+   if (settings.status() != QSettings::Status::NoError)
+      return nullptr;
+
+   auto loaded =
+      std::make_shared< MathFactsSettings >(
+         DefaultSettings(path));
+
+   loaded->enabled_math_facts =
+      ReadBits(
+         settings,
+         "enabled_math_facts",
+         loaded->enabled_math_facts,
+         ALL_MATH_FACTS);
+
+   const std::string reports_directory =
+      settings.value(
+         "reports_directory",
+         DEFAULT_REPORTS_DIRECTORY).toString().toStdString();
+
+   if (!reports_directory.empty())
+   {
+      loaded->reports_directory =
+         reports_directory;
+   }
+
+   const int32_t duration_ms =
+      ReadInt(
+         settings,
+         "math_practice_duration_ms",
+         DEFAULT_MATH_PRACTICE_DURATION_MS);
+
+   loaded->math_practice_duration =
+      std::chrono::milliseconds {
+         duration_ms > 0 ?
+            duration_ms :
+            DEFAULT_MATH_PRACTICE_DURATION_MS
+      };
+
+   const int32_t minimum =
+      ReadInt(
+         settings,
+         "minimum_amount_to_practice",
+         DEFAULT_MINIMUM_AMOUNT_TO_PRACTICE);
+
+   loaded->minimum_amount_to_practice =
+      static_cast< uint32_t >(
+         minimum > 0 ?
+            minimum :
+            DEFAULT_MINIMUM_AMOUNT_TO_PRACTICE);
+
+   const int32_t days =
+      ReadInt(
+         settings,
+         "archive_reports_after_days",
+         0);
+
+   loaded->archive_reports_after =
+      std::chrono::days {
+         days > 0 ?
+            days :
+            0
+      };
+
+   loaded->export_formats =
+      ReadBits(
+         settings,
+         "export_formats",
+         0,
+         ExportFormatBits::CSV | ExportFormatBits::JSON);
+
+   loaded->pause_practice_when_hidden =
+      settings.value(
+         "pause_practice_when_hidden",
+         false).toBool();
+
+   loaded->classroom_feed =
+      settings.value(
+         "classroom_feed",
+         true).toBool();
+
+   return
+      loaded;
+}
+
+SettingsWatcher::SettingsWatcher(
+   const std::string & username ) noexcept :
+username_ { username }
+{
+   const auto settings_path =
+      FindSettingsFile(
+         username_);
+
+   auto settings =
+      LoadSettings(
+         settings_path);
+
+   if (!settings)
+   {
+      // an unreadable file at startup behaves like a missing one
+      settings =
+         std::make_shared< const MathFactsSettings >(
+            DefaultSettings(settings_path));
+   }
+
+   settings_.store(
+      std::move(settings));
+
+   reload_timer_.setSingleShot(
+      true);
+   reload_timer_.setInterval(
+      std::chrono::milliseconds { 250 });
+
+   QObject::connect(
+      &reload_timer_,
+      &QTimer::timeout,
+      &reload_timer_,
+      [ this ] ( )
+      {
+         Reload();
+      });
+
+   QObject::connect(
+      &watcher_,
+      &QFileSystemWatcher::fileChanged,
+      &reload_timer_,
+      qOverload< >(&QTimer::start));
+
+   // a settings file that is created, or replaced by renaming a new one
+   // over it, only shows up as a change of its directory
+   QObject::connect(
+      &watcher_,
+      &QFileSystemWatcher::directoryChanged,
+      &reload_timer_,
+      qOverload< >(&QTimer::start));
+
+   WatchPaths();
+}
+
+std::shared_ptr< const MathFactsSettings > SettingsWatcher::Get( ) const noexcept
+{
+   return
+      settings_.load();
+}
+
+void SettingsWatcher::SetChangedCallback(
+   ChangedCallback callback ) noexcept
+{
+   changed_callback_ =
+      std::move(callback);
+}
+
+void SettingsWatcher::Reload( ) noexcept
+{
+   // the file may be a different one now, e.g. once a user file appears
+   auto settings =
+      LoadSettings(
+         FindSettingsFile(username_));
+
+   WatchPaths();
+
+   // keep the current settings until the file can be read again
+   if (!settings)
+      return;
+
+   const auto current =
+      settings_.load();
+
+   if (*settings == *current)
+      return;
+
+   settings_.store(
+      settings);
+
+   if (changed_callback_)
+   {
+      changed_callback_(
+         settings);
+   }
+}
+
+void SettingsWatcher::WatchPaths( ) noexcept
+{
+   QStringList paths;
+
+   for (const auto & directory : GetSettingsDirectories())
+   {
+      paths.append(
+         QString::fromStdString(directory.string()));
+   }
+
+   const auto settings_path =
+      FindSettingsFile(
+         username_);
+
+   paths.append(
+      QString::fromStdString(settings_path.parent_path().string()));
+
+   std::error_code error;
+
+   if (std::filesystem::is_regular_file(settings_path, error))
+   {
+      paths.append(
+         QString::fromStdString(settings_path.string()));
+   }
+
+   // a replaced file drops out of the watcher; paths already watched
+   // are left alone
+   paths.removeDuplicates();
+
+   const QStringList watched =
+      watcher_.files() + watcher_.directories();
+
+   for (const auto & path : paths)
+   {
+      if (!watched.contains(path))
+      {
+         watcher_.addPath(
+            path);
+      }
+   }
+}
@@ -0,0 +1,95 @@
+#ifndef _MATH_FACTS_SETTINGS_HPP_
+#define _MATH_FACTS_SETTINGS_HPP_
+
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QTimer>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// every value of math-facts.ini, parsed and validated once.  a snapshot is
+// never modified; a change to the file produces a new snapshot instead.
+struct MathFactsSettings
+{
+   // the file the values were read from, which may not exist
+   std::filesystem::path path;
+
+   uint32_t enabled_math_facts;
+   std::filesystem::path reports_directory;
+   std::chrono::milliseconds math_practice_duration;
+   uint32_t minimum_amount_to_practice;
+   std::chrono::days archive_reports_after;
+   uint32_t export_formats;
+   bool pause_practice_when_hidden;
+   bool classroom_feed;
+
+   bool operator == (
+      const MathFactsSettings & ) const = default;
+};
+
+// every value at its default, as for a settings file at path that does
+// not exist
+MathFactsSettings DefaultSettings(
+   const std::filesystem::path & path ) noexcept;
+
+// the directories a settings file is looked for in, in order
+std::vector< std::filesystem::path > GetSettingsDirectories( ) noexcept;
+
+// <user>-math-facts.ini or math-facts.ini from the settings directories;
+// math-facts.ini in the working directory if neither exists
+std::filesystem::path FindSettingsFile(
+   const std::string & username ) noexcept;
+
+// values that are missing or out of range fall back to their defaults.
+// returns nullptr if the file exists but cannot be read, as happens while
+// it is being replaced.
+std::shared_ptr< const MathFactsSettings > LoadSettings(
+   const std::filesystem::path & path ) noexcept;
+
+// keeps the settings of a user current.  the settings file and the
+// directories it may appear in are watched, and a change replaces the
+// whole snapshot at once, so a reader on any thread sees either the old
+// or the new settings and never a mix of both.
+class SettingsWatcher
+{
+public:
+   using ChangedCallback =
+      std::function< void (
+         const std::shared_ptr< const MathFactsSettings > & ) >;
+
+   explicit SettingsWatcher(
+      const std::string & username ) noexcept;
+
+   SettingsWatcher(
+      const SettingsWatcher & ) = delete;
+   SettingsWatcher & operator = (
+      const SettingsWatcher & ) = delete;
+
+   std::shared_ptr< const MathFactsSettings > Get( ) const noexcept;
+
+   // called on the gui thread after the settings changed
+   void SetChangedCallback(
+      ChangedCallback callback ) noexcept;
+
+private:
+   void Reload( ) noexcept;
+   void WatchPaths( ) noexcept;
+
+   std::string username_;
+
+   std::atomic< std::shared_ptr< const MathFactsSettings > > settings_;
+   ChangedCallback changed_callback_;
+
+   QFileSystemWatcher watcher_;
+   // coalesces the notifications of a file being rewritten
+   QTimer reload_timer_;
+
+};
+
+#endif // _MATH_FACTS_SETTINGS_HPP_
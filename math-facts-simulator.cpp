@@ -0,0 +1,486 @@
+#include "fact-id.hpp"
+#include "fact-table.hpp"
+#include "math-facts-widget.hpp"
+#include "session-performance.hpp"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEvent>
+#include <QtCore/QString>
+#include <QtCore/Qt>
+#include <QtCore/QtGlobal>
+#include <QtGui/QKeyEvent>
+#include <QtWidgets/QApplication>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// practices like a student, only much faster, to find out how a session
+// behaves after more answers than a person could ever give:
+//
+//    math-facts-simulator [options]
+//
+//    --answers <count>       answers to give before the session is ended;
+//                            defaults to 1000000
+//    --student <name>        user the session is practiced as; defaults
+//                            to simulated-student
+//    --median <ms>           median response time of an average fact;
+//                            defaults to 3000
+//    --spread <sigma>        log-normal spread of the response times, and
+//                            of how much harder one fact is than another;
+//                            defaults to 0.5
+//    --error-rate <fraction> chance of answering an average fact wrong
+//                            before answering it right; defaults to 0.1
+//    --time-scale <factor>   how much of each response time is actually
+//                            waited; defaults to 0, as fast as possible
+//    --sample <count>        answers between samples; defaults to 100000
+//    --seed <number>         seed of the student; defaults to 1
+//
+// the widget is created on the offscreen platform and never shown, and
+// every answer is typed into it one key press at a time, so an answer
+// takes the same path as one given at the keyboard, minus the painting.
+// the session is practiced as the given student, so its profile, journal
+// and report are that student's and come from <student>-math-facts.ini
+// if there is one.  as the widget measures response times with the real
+// clock, they only follow the latency model with a time scale above 0.
+
+static void PrintUsage( )
+{
+   std::cerr
+      << "usage: math-facts-simulator [--answers <count>] [--student <name>]\n"
+         "          [--median <ms>] [--spread <sigma>] [--error-rate <fraction>]\n"
+         "          [--time-scale <factor>] [--sample <count>] [--seed <number>]\n";
+}
+
+namespace
+{
+
+// how a simulated student answers: every fact is harder or easier by a
+// factor drawn once, which scales both its median response time and its
+// chance of being answered wrong first
+class StudentModel
+{
+public:
+   struct Attempt
+   {
+      std::chrono::milliseconds response_time;
+      bool wrong_first;
+   };
+
+   StudentModel(
+      const uint32_t seed,
+      const double median_ms,
+      const double spread,
+      const double error_rate ) noexcept :
+   random_engine_ { seed },
+   spread_ { spread }
+   {
+      std::lognormal_distribution< double > difficulty_distribution {
+         0.0, spread
+      };
+
+      for (size_t fact_id { }; fact_id < FACT_ID_COUNT; ++fact_id)
+      {
+         const double difficulty =
+            difficulty_distribution(
+               random_engine_);
+
+         log_medians_[fact_id] =
+            std::log(
+               median_ms * difficulty);
+         error_rates_[fact_id] =
+            std::min(
+               error_rate * difficulty,
+               0.95);
+      }
+   }
+
+   Attempt Answer(
+      const uint16_t fact_id ) noexcept
+   {
+      std::lognormal_distribution< double > response_time_distribution {
+         log_medians_[fact_id], spread_
+      };
+      std::bernoulli_distribution error_distribution {
+         error_rates_[fact_id]
+      };
+
+      return
+         Attempt {
+            std::chrono::milliseconds {
+               static_cast< int64_t >(
+                  response_time_distribution(random_engine_))
+            },
+            error_distribution(random_engine_)
+         };
+   }
+
+private:
+   std::default_random_engine random_engine_;
+   double spread_;
+
+   std::array< double, FACT_ID_COUNT > log_medians_;
+   std::array< double, FACT_ID_COUNT > error_rates_;
+
+};
+
+std::string CorrectResponse(
+   const uint16_t fact_id )
+{
+   return
+      FactIdOperation(fact_id) == FactOperation::TIME ?
+         GetTimeAnswer(fact_id) :
+         std::to_string(GetArithmeticAnswer(fact_id));
+}
+
+// never graded as correct, and as long as a correct response can be
+std::string WrongResponse(
+   const uint16_t fact_id )
+{
+   if (FactIdOperation(fact_id) != FactOperation::TIME)
+   {
+      const int32_t answer =
+         GetArithmeticAnswer(
+            fact_id);
+
+      return
+         std::to_string(
+            answer == 0 ?
+               1 :
+               answer - 1);
+   }
+
+   // the same minute of the next hour
+   const FactOperands operands =
+      GetFactOperands(
+         fact_id);
+
+   return
+      GetTimeAnswer(
+         TimeFactId(
+            operands.time_kind,
+            static_cast< uint8_t >(operands.hour % 12 + 1),
+            operands.minute));
+}
+
+void SendKey(
+   MathFactsWidget & widget,
+   const int key,
+   const QString & text )
+{
+   QKeyEvent event {
+      QEvent::Type::KeyPress,
+      key,
+      Qt::KeyboardModifier::NoModifier,
+      text
+   };
+
+   QCoreApplication::sendEvent(
+      &widget,
+      &event);
+}
+
+void Type(
+   MathFactsWidget & widget,
+   const std::string_view response )
+{
+   for (const char character : response)
+   {
+      SendKey(
+         widget,
+         character == ':' ?
+            Qt::Key::Key_Colon :
+            Qt::Key::Key_0 + (character - '0'),
+         QString { QChar { character } });
+   }
+
+   SendKey(
+      widget,
+      Qt::Key::Key_Return,
+      QString { QChar { '\r' } });
+}
+
+} // namespace
+
+int main(
+   int argc,
+   char ** argv )
+{
+   uint64_t answer_count { 1000000 };
+   std::string student { "simulated-student" };
+   double median_ms { 3000.0 };
+   double spread { 0.5 };
+   double error_rate { 0.1 };
+   double time_scale { };
+   uint64_t sample_interval { 100000 };
+   uint32_t seed { 1 };
+
+   for (int i { 1 }; i < argc; ++i)
+   {
+      const std::string_view argument {
+         argv[i]
+      };
+
+      bool valid { i + 1 < argc };
+
+      if (!valid)
+      {
+      }
+      else if (argument == "--answers")
+      {
+         answer_count =
+            std::strtoull(
+               argv[i + 1],
+               nullptr,
+               10);
+
+         valid = answer_count > 0;
+      }
+      else if (argument == "--student")
+      {
+         student = argv[i + 1];
+
+         valid = !student.empty();
+      }
+      else if (argument == "--median")
+      {
+         median_ms =
+            std::strtod(
+               argv[i + 1],
+               nullptr);
+
+         valid = median_ms > 0.0;
+      }
+      else if (argument == "--spread")
+      {
+         spread =
+            std::strtod(
+               argv[i + 1],
+               nullptr);
+
+         valid = spread > 0.0;
+      }
+      else if (argument == "--error-rate")
+      {
+         error_rate =
+            std::strtod(
+               argv[i + 1],
+               nullptr);
+
+         valid = error_rate >= 0.0 && error_rate <= 1.0;
+      }
+      else if (argument == "--time-scale")
+      {
+         time_scale =
+            std::strtod(
+               argv[i + 1],
+               nullptr);
+
+         valid = time_scale >= 0.0;
+      }
+      else if (argument == "--sample")
+      {
+         sample_interval =
+            std::strtoull(
+               argv[i + 1],
+               nullptr,
+               10);
+
+         valid = sample_interval > 0;
+      }
+      else if (argument == "--seed")
+      {
+         seed =
+            static_cast< uint32_t >(
+               std::strtoul(argv[i + 1], nullptr, 10));
+      }
+      else
+      {
+         valid = false;
+      }
+
+      if (!valid)
+      {
+         PrintUsage();
+
+         return
+            EXIT_FAILURE;
+      }
+
+      ++i;
+   }
+
+   // both have to be in place before the application starts
+#if _WIN32
+   qputenv("USERNAME", QByteArray::fromStdString(student));
+#else
+   qputenv("USER", QByteArray::fromStdString(student));
+#endif // _WIN32
+
+   if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+   {
+      qputenv("QT_QPA_PLATFORM", "offscreen");
+   }
+
+   QApplication application {
+      argc,
+      argv
+   };
+
+   StudentModel student_model {
+      seed,
+      median_ms,
+      spread,
+      error_rate
+   };
+
+   MathFactsWidget math_facts_widget {
+      nullptr
+   };
+
+   // lets the warm up finish, as it would while the title is shown
+   QCoreApplication::processEvents();
+
+   std::ios_base::sync_with_stdio(false);
+
+   auto & output =
+      std::cout;
+
+   const uint64_t start_heap_bytes =
+      GetHeapBytes();
+
+   const auto start_time =
+      std::chrono::steady_clock::now();
+
+   auto sample_time =
+      start_time;
+
+   math_facts_widget.StartPractice();
+
+   uint64_t answers { };
+   uint64_t wrong_first_answers { };
+
+   while (answers < answer_count && math_facts_widget.IsPracticing())
+   {
+      const uint16_t fact_id =
+         math_facts_widget.GetCurrentFactId();
+
+      if (fact_id >= FACT_ID_COUNT)
+         break;
+
+      const auto attempt =
+         student_model.Answer(
+            fact_id);
+
+      if (time_scale > 0.0)
+      {
+         std::this_thread::sleep_for(
+            std::chrono::duration< double, std::milli > {
+               attempt.response_time.count() * time_scale
+            });
+      }
+
+      if (attempt.wrong_first)
+      {
+         Type(
+            math_facts_widget,
+            WrongResponse(fact_id));
+
+         ++wrong_first_answers;
+      }
+
+      Type(
+         math_facts_widget,
+         CorrectResponse(fact_id));
+
+      ++answers;
+
+      // timers and the journal's notifications are handled as they
+      // would be between the key presses of a person
+      if (answers % 256 == 0)
+      {
+         QCoreApplication::processEvents();
+      }
+
+      if (answers % sample_interval == 0)
+      {
+         const auto now =
+            std::chrono::steady_clock::now();
+
+         output
+            << "answers = "
+            << answers
+            << "; ns per answer = "
+            << std::chrono::duration_cast<
+                  std::chrono::nanoseconds >(
+                     now - sample_time).count() / sample_interval
+            << "; heap bytes = "
+            << GetHeapBytes()
+            << "; peak resident bytes = "
+            << GetPeakResidentBytes()
+            << std::endl;
+
+         sample_time = now;
+      }
+   }
+
+   const auto practice_end_time =
+      std::chrono::steady_clock::now();
+
+   math_facts_widget.FinishPractice();
+
+   // the report is written on the thread pool and reported back through
+   // the event loop
+   while (math_facts_widget.IsWritingReport())
+   {
+      QCoreApplication::processEvents();
+
+      std::this_thread::sleep_for(
+         std::chrono::milliseconds { 1 });
+   }
+
+   const auto report_end_time =
+      std::chrono::steady_clock::now();
+
+   const uint64_t end_heap_bytes =
+      GetHeapBytes();
+
+   output
+      << "answers = "
+      << answers
+      << "; wrong first answers = "
+      << wrong_first_answers
+      << "; practice ms = "
+      << std::chrono::duration_cast<
+            std::chrono::milliseconds >(
+               practice_end_time - start_time).count()
+      << "; ns per answer = "
+      << (answers ?
+            std::chrono::duration_cast<
+               std::chrono::nanoseconds >(
+                  practice_end_time - start_time).count() / answers :
+            0)
+      << "; end of session ms = "
+      << std::chrono::duration_cast<
+            std::chrono::milliseconds >(
+               report_end_time - practice_end_time).count()
+      << "; heap growth bytes = "
+      << static_cast< int64_t >(end_heap_bytes - start_heap_bytes)
+      << "; peak resident bytes = "
+      << GetPeakResidentBytes()
+      << "\n";
+
+   return
+      EXIT_SUCCESS;
+}
@@ -1,19 +1,28 @@
 #include "math-facts-widget.hpp"
+#include "allocation-counter.hpp"
 #include "arithmetic-problem.hpp"
+#include "fact-id.hpp"
+#include "fact-table.hpp"
+#include "power-policy.hpp"
 #include "problem.hpp"
+#include "report-archive.hpp"
+#include "session-format.hpp"
+#include "session-report.hpp"
 #include "time-problem.hpp"
+#include "title-button.hpp"
+#include "ui_title-stage-buttons.h"
 
-#include <QtCore/QFile>
+#include <QtCore/QMetaObject>
 #include <QtCore/QObject>
-#include <QtCore/QOverload>
 #include <QtCore/QPointF>
 #include <QtCore/QRect>
 #include <QtCore/QRectF>
-#include <QtCore/QSettings>
 #include <QtCore/QSize>
 #include <QtCore/QString>
 #include <QtCore/Qt>
+#include <QtCore/QThreadPool>
 #include <QtCore/QtTypes>
+#include <QtCore/QVariant>
 #include <QtCore/QVector>
 #include <QtGui/QBrush>
 #include <QtGui/QFont>
@@ -21,46 +30,94 @@
 #include <QtGui/QPainter>
 #include <QtGui/QPen>
 #include <QtGui/QTextOption>
-#include <QtUiTools/QUiLoader>
-#include <QtWidgets/QApplication>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QPushButton>
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cstdlib>
-#include <fstream>
 #include <functional>
-#include <ios>
 #include <iterator>
 #include <system_error>
 #include <utility>
 
-#if __has_include(<format>)
-#  include <format>
-#else
-#  include <ctime>
-#  include <time.h>
-#endif // __has_include(<format>)
-
 MathFactsWidget::MathFactsWidget(
    QWidget * const parent ) noexcept :
 QWidget { parent },
 current_stage_ { Stage::TITLE },
+report_state_ { ReportState::WRITING },
+settings_watcher_ { GetCurrentUserName() },
+settings_ { settings_watcher_.Get() },
 chosen_problems_ { },
 title_stage_buttons_ { nullptr },
 current_colors_ { nullptr },
+background_colors_ { nullptr },
+live_metrics_data_ { },
+classroom_feed_ {
+   QString::fromStdString(GetCurrentUserName()),
+   settings_->classroom_feed
+},
 answer_image_ { nullptr },
-minimum_amount_to_practice_ { 50 }
+power_policy_ { *this },
+minimum_amount_to_practice_ { 50 },
+archive_stop_requested_ { false },
+active_tasks_ { 0 }
 {
    SetupColors();
    SetupAnswerImages();
    SetupStopwatchImages();
    SetupTitleStage();
+   StartReportArchiving();
+   StartWarmUp();
+
+   // only maps the file; records are paged in as facts are answered
+   fact_profile_.Open(
+      GetProfilePath());
+
+   // monitoring tools on this host read the metrics without asking
+   live_metrics_.Open(
+      GetCurrentUserName());
+
+   // keeps the gauges current while nothing is painted; it only runs
+   // while the widget can be seen
+   QObject::connect(
+      &live_metrics_timer_,
+      &QTimer::timeout,
+      this,
+      &MathFactsWidget::PublishLiveMetrics);
+
+   PublishLiveMetrics();
+
+   power_policy_.SetChangedCallback(
+      [ this ] ( const PowerPolicy::Mode )
+      {
+         OnPowerModeChanged();
+      });
+
+   settings_watcher_.SetChangedCallback(
+      std::bind(
+         &MathFactsWidget::OnSettingsChanged,
+         this,
+         std::placeholders::_1));
+
+   QObject::connect(
+      &results_animation_timer_,
+      &QTimer::timeout,
+      this,
+      &MathFactsWidget::OnResultsAnimationTimeout);
 }
 
 MathFactsWidget::~MathFactsWidget( ) noexcept
 {
+   // a month of reports can take a while to compress; what the archiver
+   // did not finish is archived on the next launch
+   archive_stop_requested_ = true;
+
+   // the tasks must not outlive the widget they report back to
+   task_pool_.waitForDone();
+
+   Problem::ReleaseCanvases();
 }
 
 void MathFactsWidget::OnAnswerImageTimeout( ) noexcept
@@ -70,6 +127,153 @@ void MathFactsWidget::OnAnswerImageTimeout( ) noexcept
    update();
 }
 
+void MathFactsWidget::OnResultsAnimationTimeout( ) noexcept
+{
+   if (std::chrono::steady_clock::now() - results_start_time_ >=
+       RESULTS_ANIMATION_DURATION)
+   {
+      results_animation_timer_.stop();
+   }
+
+   update();
+}
+
+void MathFactsWidget::OnStopwatchTimeout( ) noexcept
+{
+   if (Stage::MATH_PRACTICE != current_stage_)
+      return;
+
+   const auto now =
+      std::chrono::steady_clock::now();
+
+   // the timer is slowed while unfocused, so only its regular ticks
+   // tell about the event loop
+   if (power_policy_.GetMode() == PowerPolicy::Mode::ACTIVE)
+   {
+      session_performance_.RecordTick(
+         now);
+   }
+
+   session_performance_.SampleMemory(
+      fact_heatmap_.CacheBytes() +
+      Problem::CanvasBytes());
+
+   practice_stopwatch_.UpdateHandRotation(
+      now);
+
+   update();
+}
+
+void MathFactsWidget::OnPowerModeChanged( ) noexcept
+{
+   const PowerPolicy::Mode mode =
+      power_policy_.GetMode();
+
+   if (PowerPolicy::Mode::HIDDEN == mode)
+   {
+      live_metrics_timer_.stop();
+   }
+   else if (!live_metrics_timer_.isActive())
+   {
+      live_metrics_timer_.start(
+         std::chrono::seconds { 1 });
+   }
+
+   classroom_feed_.SetHidden(
+      PowerPolicy::Mode::HIDDEN == mode);
+
+   PublishLiveMetrics();
+
+   if (Stage::MATH_PRACTICE != current_stage_)
+      return;
+
+   const auto now =
+      std::chrono::steady_clock::now();
+
+   session_performance_.SkipTicks();
+
+   if (PowerPolicy::Mode::HIDDEN == mode)
+   {
+      practice_stopwatch_.periodic_update_timer.stop();
+
+      if (settings_->pause_practice_when_hidden)
+      {
+         practice_stopwatch_.Pause(
+            now);
+      }
+
+      return;
+   }
+
+   practice_stopwatch_.Resume(
+      now);
+   practice_stopwatch_.UpdateHandRotation(
+      now);
+
+   // an unfocused window is still seen, just not watched closely
+   practice_stopwatch_.periodic_update_timer.setTimerType(
+      PowerPolicy::Mode::ACTIVE == mode ?
+         Qt::TimerType::CoarseTimer :
+         Qt::TimerType::VeryCoarseTimer);
+   practice_stopwatch_.periodic_update_timer.start(
+      PowerPolicy::Mode::ACTIVE == mode ?
+         std::chrono::milliseconds { 500 } :
+         std::chrono::milliseconds { 2000 });
+
+   update();
+}
+
+void MathFactsWidget::OnPracticeDeadline( ) noexcept
+{
+   if (Stage::MATH_PRACTICE != current_stage_)
+      return;
+
+   // the hand stays down from here on, so nothing needs a timer
+   practice_stopwatch_.periodic_update_timer.stop();
+   practice_stopwatch_.hand_rotation = 0.0;
+
+   current_stage_ =
+      Stage::OVERTIME;
+
+   if (IsSessionComplete())
+   {
+      EndSession();
+   }
+   else
+   {
+      update();
+   }
+}
+
+void MathFactsWidget::OnReportWritten(
+   const SessionReportResult & result ) noexcept
+{
+   report_state_ =
+      result.written ?
+         ReportState::WRITTEN :
+         ReportState::FAILED;
+
+   current_stage_ =
+      Stage::RESULTS;
+   results_start_time_ =
+      std::chrono::steady_clock::now();
+
+   // about one frame at 60 hz while the results slide in
+   results_animation_timer_.start(
+      std::chrono::milliseconds { 16 });
+
+   update();
+
+   if (!result.written)
+   {
+      QMessageBox::critical(
+         this,
+         "Write Report Error",
+         QString::fromStdString(result.error_message),
+         QMessageBox::StandardButton::Ok);
+   }
+}
+
 void MathFactsWidget::OnTitleButtonPressed(
    const TitleButtonID title_button_id ) noexcept
 {
@@ -81,6 +285,8 @@ void MathFactsWidget::OnTitleButtonPressed(
    current_stage_ =
       Stage::MATH_PRACTICE;
 
+   DiscardUnchosenProblems();
+
    current_problem_ =
       GenerateProblem();
 
@@ -93,47 +299,198 @@ void MathFactsWidget::OnTitleButtonPressed(
       &practice_stopwatch_.periodic_update_timer,
       &QTimer::timeout,
       this,
-      qOverload< >(&MathFactsWidget::update));
+      &MathFactsWidget::OnStopwatchTimeout);
 
-   practice_stopwatch_.periodic_update_timer.start(
-      std::chrono::milliseconds { 500 });
+   QObject::connect(
+      &practice_stopwatch_.deadline_timer,
+      &QTimer::timeout,
+      this,
+      &MathFactsWidget::OnPracticeDeadline);
+
+   // the deadline is met to the millisecond, not at the next tick
+   practice_stopwatch_.deadline_timer.setSingleShot(
+      true);
+   practice_stopwatch_.deadline_timer.setTimerType(
+      Qt::TimerType::PreciseTimer);
+   practice_stopwatch_.deadline_timer.start(
+      GetMathPracticeDuration());
 
    minimum_amount_to_practice_ =
       GetMinimumAmountToPractice();
 
    practice_stopwatch_.start_time =
       std::chrono::steady_clock::now();
+
+   session_performance_.Start(
+      practice_stopwatch_.start_time,
+      std::chrono::milliseconds { 500 });
+   practice_stopwatch_.start_system_time =
+      std::chrono::system_clock::now();
    practice_stopwatch_.end_time =
       practice_stopwatch_.start_time +
       GetMathPracticeDuration();
+   practice_stopwatch_.paused_duration = { };
+   practice_stopwatch_.paused_time.reset();
+   practice_stopwatch_.UpdateHandRotation(
+      practice_stopwatch_.start_time);
+
+   // starts the stopwatch at the pace the window is seen at
+   OnPowerModeChanged();
+
+   // answers are journaled as they happen so that a crash or power cut
+   // loses at most the last flush interval of the session
+   answer_journal_.Start(
+      settings_->reports_directory /
+      (GenerateReportName() +
+       AnswerJournal::EXTENSION),
+      std::chrono::duration_cast<
+         std::chrono::milliseconds >(
+            practice_stopwatch_.start_system_time.time_since_epoch()).count(),
+      std::chrono::seconds { 1 });
 }
 
 void MathFactsWidget::paintEvent(
    QPaintEvent * paint_event )
 {
+   const auto paint_start_time =
+      std::chrono::steady_clock::now();
+
    QWidget::paintEvent(
       paint_event);
 
-   if (Stage::TITLE == current_stage_)
+   QPainter painter {
+      this
+   };
+
+   // qt allocates the state of a painter whenever it begins, whatever is
+   // drawn with it, so only the drawing itself is counted
+   const AllocationScope paint_allocations;
+
+   switch (current_stage_)
    {
+   case Stage::TITLE:
       PaintTitleStage(
-         paint_event);
+         painter);
+      break;
+
+   case Stage::MATH_PRACTICE: [[fallthrough]];
+   case Stage::OVERTIME:
+      PaintProblem(
+         paint_event,
+         painter);
+      break;
+
+   case Stage::SESSION_END:
+      PaintSessionEndStage(
+         painter);
+      break;
+
+   case Stage::RESULTS:
+      PaintResultsStage(
+         painter);
+      break;
    }
-   else
+
+   const uint64_t allocations =
+      paint_allocations.Counts().allocations;
+
+   painter.end();
+
+   const auto paint_end_time =
+      std::chrono::steady_clock::now();
+   const uint64_t paint_time_us =
+      static_cast< uint64_t >(
+         std::chrono::duration_cast<
+            std::chrono::microseconds >(
+               paint_end_time - paint_start_time).count());
+
+   if (current_stage_ == Stage::MATH_PRACTICE ||
+       current_stage_ == Stage::OVERTIME)
    {
-      PaintProblem(
-         paint_event);
+      session_performance_.RecordFrame(
+         paint_start_time,
+         paint_end_time);
    }
+
+   ++live_metrics_data_.frames_painted;
+
+   live_metrics_data_.paint_time_us +=
+      paint_time_us;
+   ++live_metrics_data_.paint_time_histogram[
+      std::min< size_t >(
+         std::bit_width(paint_time_us),
+         LiveMetricsData::PAINT_TIME_BUCKETS - 1)];
+
+   live_metrics_data_.paint_allocations +=
+      allocations;
+   live_metrics_data_.allocating_paints +=
+      allocations != 0;
+
+   PublishLiveMetrics();
 }
 
-void MathFactsWidget::keyReleaseEvent(
+void MathFactsWidget::keyPressEvent(
    QKeyEvent * event )
 {
+   if (event->isAutoRepeat())
+      return;
+
+   if (Stage::SESSION_END == current_stage_ ||
+       Stage::RESULTS == current_stage_)
+   {
+      const bool exit_key =
+         event->key() == Qt::Key::Key_Enter ||
+         event->key() == Qt::Key::Key_Return ||
+         event->key() == Qt::Key::Key_Escape;
+
+      // closing the last window quits, unless the process is resident
+      if (exit_key && report_state_ != ReportState::WRITING)
+      {
+         close();
+      }
+
+      return;
+   }
+
    if (current_problem_)
    {
-      current_problem_->OnKeyReleaseEvent(
+      const auto handled_time =
+         std::chrono::steady_clock::now();
+      const AllocationScope key_allocations;
+
+      const auto event_time =
+         input_clock_.ToSteadyTime(
+            event->timestamp(),
+            handled_time);
+
+      current_problem_->RecordKeyPress(
+         event_time,
+         handled_time);
+
+      session_performance_.RecordInput(
+         event_time);
+
+      current_problem_->OnKeyPressEvent(
          event,
          *this);
+
+      // grading records the response, and a correct answer the whole
+      // answer and the next problem; only typing is expected to get by
+      // without allocating
+      const bool grading_key =
+         event->key() == Qt::Key::Key_Enter ||
+         event->key() == Qt::Key::Key_Return;
+
+      if (!grading_key)
+      {
+         const uint64_t allocations =
+            key_allocations.Counts().allocations;
+
+         live_metrics_data_.key_press_allocations +=
+            allocations;
+         live_metrics_data_.allocating_key_presses +=
+            allocations != 0;
+      }
    }
 
    update();
@@ -205,322 +562,424 @@ void MathFactsWidget::SetupStopwatchImages( ) noexcept
 
 void MathFactsWidget::SetupTitleStage( ) noexcept
 {
-   QFile title_stage_buttons_file {
-      ":/title-stage-buttons-ui"
-   };
+   title_stage_buttons_ =
+      std::make_unique< QWidget >();
 
-   // assume it will always open
-   title_stage_buttons_file.open(
-      QFile::OpenModeFlag::ReadOnly);
+   // generated from title-stage-buttons.ui at build time
+   Ui::TitleStageButtons title_stage_buttons_ui;
 
-   title_stage_buttons_.reset(
-      QUiLoader { }.load(
-         &title_stage_buttons_file,
-         nullptr)); // ownership via smart pointer
+   title_stage_buttons_ui.setupUi(
+      title_stage_buttons_.get());
 
-   if (title_stage_buttons_)
+   title_stage_buttons_->setParent(
+      this);
+
+   struct ButtonSetup
    {
-      const uint32_t enabled_math_facts =
-         GetEnabledMathFacts();
+      TitleButton * const push_button;
+      const char * const resource_id;
+      TitleButtonID id;
+      EnabledMathFactBits enabled_math_fact_bit;
+   };
 
-      title_stage_buttons_->setParent(
-         this);
+   const ButtonSetup button_setup[] {
+      { title_stage_buttons_ui.pushButtonAdd, ":/math-button-image-add", TitleButtonID::ADD, EnabledMathFactBits::ADD },
+      { title_stage_buttons_ui.pushButtonSub, ":/math-button-image-sub", TitleButtonID::SUB, EnabledMathFactBits::SUB },
+      { title_stage_buttons_ui.pushButtonMul, ":/math-button-image-mul", TitleButtonID::MUL, EnabledMathFactBits::MUL },
+      { title_stage_buttons_ui.pushButtonDiv, ":/math-button-image-div", TitleButtonID::DIV, EnabledMathFactBits::DIV },
+      { title_stage_buttons_ui.pushButtonClock, ":/math-button-image-clock", TitleButtonID::TIME, EnabledMathFactBits::TIME },
+      { title_stage_buttons_ui.pushButtonAll, ":/math-buttons-image-sheet", TitleButtonID::ALL, EnabledMathFactBits::ALL }
+   };
 
-      struct ButtonSetup
-      {
-         const char * const object_name;
-         const char * const resource_id;
-         TitleButtonID id;
-         EnabledMathFactBits enabled_math_fact_bit;
-      };
+   for (const auto & button : button_setup)
+   {
+      TitleButton * const push_button =
+         button.push_button;
 
-      const ButtonSetup button_setup[] {
-         { "pushButtonAdd", ":/math-button-image-add", TitleButtonID::ADD, EnabledMathFactBits::ADD },
-         { "pushButtonSub", ":/math-button-image-sub", TitleButtonID::SUB, EnabledMathFactBits::SUB },
-         { "pushButtonMul", ":/math-button-image-mul", TitleButtonID::MUL, EnabledMathFactBits::MUL },
-         { "pushButtonDiv", ":/math-button-image-div", TitleButtonID::DIV, EnabledMathFactBits::DIV },
-         { "pushButtonClock", ":/math-button-image-clock", TitleButtonID::TIME, EnabledMathFactBits::TIME },
-         { "pushButtonAll", ":/math-buttons-image-sheet", TitleButtonID::ALL, EnabledMathFactBits::ALL }
-      };
+      push_button->SetImage(
+         button.resource_id);
 
-      for (const auto & button : button_setup)
-      {
-         QPushButton * push_button =
-            title_stage_buttons_->findChild< QPushButton * >(
-               button.object_name,
-               Qt::FindChildOption::FindChildrenRecursively);
-
-         push_button->setStyleSheet(
-            QString {
-               "QPushButton { \
-                  background-color: rgba(0,0,0,0); \
-                  border-style: outset; \
-                  border-width: 2px; \
-                  border-radius: 10px; \
-                  border-color: beige; \
-                  padding: 1px; \
-                  image: url(%1); \
-               } \
-               QPushButton:hover:!pressed { \
-                  background-color: rgba(172,255,126,255); \
-               }"
-            }.arg(button.resource_id));
-
-         QObject::connect(
-            push_button,
-            &QPushButton::pressed,
-            std::bind(
-               &MathFactsWidget::OnTitleButtonPressed,
-               this,
-               button.id));
-
-         if (button.id == TitleButtonID::ALL)
-         {
-            push_button->setEnabled(
-               enabled_math_facts != 0u);
-         }
-         else
-         {
-            push_button->setEnabled(
-               enabled_math_facts & button.enabled_math_fact_bit);
-         }
-      }
+      QObject::connect(
+         push_button,
+         &QPushButton::pressed,
+         std::bind(
+            &MathFactsWidget::OnTitleButtonPressed,
+            this,
+            button.id));
+
+      push_button->setProperty(
+         ENABLED_MATH_FACT_BIT_PROPERTY,
+         static_cast< uint32_t >(button.enabled_math_fact_bit));
    }
+
+   UpdateTitleButtons();
 }
 
-std::unique_ptr< Problem > MathFactsWidget::GenerateProblem( ) noexcept
+void MathFactsWidget::UpdateTitleButtons( ) noexcept
 {
-   if (randomizers_.addition_problems.empty() &&
-       randomizers_.subtraction_problems.empty() &&
-       randomizers_.multiplication_problems.empty() &&
-       randomizers_.division_problems.empty() &&
-       randomizers_.time_problems.empty())
-   {
-      const uint32_t enabled_math_facts =
-         GetEnabledMathFacts();
-
-      if (enabled_math_facts & EnabledMathFactBits::ADD &&
-         (TitleButtonID::ADD == chosen_problems_ ||
-          TitleButtonID::ALL == chosen_problems_))
-      {
-         GenerateAdditionProblem();
-      }
+   if (!title_stage_buttons_)
+      return;
 
-      if (enabled_math_facts & EnabledMathFactBits::SUB &&
-         (TitleButtonID::SUB == chosen_problems_ ||
-          TitleButtonID::ALL == chosen_problems_))
-      {
-         GenerateSubtractionProblem();
-      }
+   const uint32_t enabled_math_facts =
+      GetEnabledMathFacts();
 
-      if (enabled_math_facts & EnabledMathFactBits::MUL &&
-         (TitleButtonID::MUL == chosen_problems_ ||
-          TitleButtonID::ALL == chosen_problems_))
-      {
-         GenerateMultiplicationProblem();
-      }
+   const auto push_buttons =
+      title_stage_buttons_->findChildren< QPushButton * >(
+         QString { },
+         Qt::FindChildOption::FindChildrenRecursively);
 
-      if (enabled_math_facts & EnabledMathFactBits::DIV &&
-         (TitleButtonID::DIV == chosen_problems_ ||
-          TitleButtonID::ALL == chosen_problems_))
-      {
-         GenerateDivisionProblem();
-      }
+   // the all button covers every bit, so it is enabled with any fact
+   for (const auto push_button : push_buttons)
+   {
+      push_button->setEnabled(
+         enabled_math_facts &
+         push_button->property(ENABLED_MATH_FACT_BIT_PROPERTY).toUInt());
+   }
+}
 
-      if (enabled_math_facts & EnabledMathFactBits::TIME &&
-         (TitleButtonID::TIME == chosen_problems_ ||
-          TitleButtonID::ALL == chosen_problems_))
+void MathFactsWidget::StartWarmUp( ) noexcept
+{
+   const QVector< QString > resource_ids =
+      GetEnabledMathFacts() & EnabledMathFactBits::TIME ?
+         TimeProblem::GetImageResourceIds() :
+         QVector< QString > { };
+
+   // decoding the images is the slow part and is safe off the gui thread;
+   // pixmaps, glyphs and problems have to be made on it
+   StartTask(
+      [ this, resource_ids ] ( )
       {
-         GenerateTimeProblem();
-      }
-   }
+         std::vector< std::pair< QString, QImage > > images;
 
-   std::vector< std::unique_ptr< Problem > > * const problems[] {
-      &randomizers_.addition_problems,
-      &randomizers_.subtraction_problems,
-      &randomizers_.multiplication_problems,
-      &randomizers_.division_problems,
-      &randomizers_.time_problems
-   };
+         for (const auto & resource_id : resource_ids)
+         {
+            images.emplace_back(
+               resource_id,
+               QImage { resource_id });
+         }
 
-   uint32_t problem_type =
-      randomizers_.problem_distribution(
-         randomizers_.random_engine);
+         QMetaObject::invokeMethod(
+            this,
+            [ this, images = std::move(images) ] ( )
+            {
+               OnAssetsDecoded(
+                  images);
+            },
+            Qt::ConnectionType::QueuedConnection);
+      });
+}
 
-   while (problems[problem_type]->empty())
+void MathFactsWidget::OnAssetsDecoded(
+   const std::vector< std::pair< QString, QImage > > & images ) noexcept
+{
+   for (const auto & [ resource_id, image ] : images)
    {
-      problem_type =
-         randomizers_.problem_distribution(
-            randomizers_.random_engine);
+      Problem::AddImage(
+         resource_id,
+         image);
    }
 
-   std::unique_ptr< Problem > problem {
-      std::move(problems[problem_type]->back())
+   // the first use of the font looks it up in the font database and
+   // loads its glyphs; drawing every character once does both now
+   QPixmap glyph_pixmap {
+      512, 512
    };
 
-   problems[problem_type]->pop_back();
+   glyph_pixmap.fill(
+      Qt::transparent);
 
-   problem->SetStartTime(
-      std::chrono::steady_clock::now());
+   QPainter glyph_painter {
+      &glyph_pixmap
+   };
 
-   return
-      problem;
-}
+   glyph_painter.setRenderHint(
+      QPainter::RenderHint::Antialiasing,
+      true);
+   glyph_painter.setRenderHint(
+      QPainter::RenderHint::TextAntialiasing,
+      true);
+   glyph_painter.setFont(
+      Problem::GetFont());
 
-void MathFactsWidget::GenerateAdditionProblem( ) noexcept
-{
-   for (int32_t top { }; top <= 12; ++top)
+   const QFontMetrics font_metrics {
+      glyph_painter.font()
+   };
+
+   for (const QChar character : Problem::GetCharacters())
    {
-      for (int32_t bottom { }; bottom <= 12; ++bottom)
-      {
-         randomizers_.addition_problems.emplace_back(
-            std::make_unique< ArithmeticProblem >(
-               top,
-               bottom,
-               ArithmeticProblem::Operation::ADD));
-
-         QObject::connect(
-            randomizers_.addition_problems.back().get(),
-            &Problem::Answered,
-            this,
-            &MathFactsWidget::OnProblemAnswered);
-      }
+      glyph_painter.drawText(
+         0,
+         font_metrics.ascent(),
+         QString { character });
    }
 
-   std::shuffle(
-      randomizers_.addition_problems.begin(),
-      randomizers_.addition_problems.end(),
-      std::default_random_engine {
-         randomizers_.random_engine });
+   // a session that already started built its own pools
+   if (Stage::TITLE == current_stage_)
+   {
+      BuildProblemPools();
+   }
 }
 
-void MathFactsWidget::GenerateSubtractionProblem( ) noexcept
+void MathFactsWidget::BuildProblemPools( ) noexcept
 {
-   for (int32_t top { }; top <= 12; ++top)
+   const uint32_t enabled_math_facts =
+      GetEnabledMathFacts();
+
+   // the bits of the enabled math facts follow the order of the operations
+   randomizers_.fact_sampler.SetOperations(
+      enabled_math_facts);
+
+   randomizers_.problems.clear();
+   randomizers_.problems.resize(
+      FACT_ID_COUNT);
+
+   for (size_t operation { }; operation < FACT_OPERATION_COUNT; ++operation)
    {
-      for (int32_t bottom { }; bottom <= 12; ++bottom)
+      if (enabled_math_facts & (1u << operation))
       {
-         if (top >= bottom)
+         for (const uint16_t fact_id :
+                 GetFactTable(static_cast< FactOperation >(operation)))
          {
-            randomizers_.subtraction_problems.emplace_back(
-               std::make_unique< ArithmeticProblem >(
-                  top,
-                  bottom,
-                  ArithmeticProblem::Operation::ADD));
-
-            QObject::connect(
-               randomizers_.subtraction_problems.back().get(),
-               &Problem::Answered,
-               this,
-               &MathFactsWidget::OnProblemAnswered);
+            randomizers_.problems[fact_id] =
+               MakeProblem(
+                  fact_id);
          }
       }
    }
-
-   std::shuffle(
-      randomizers_.subtraction_problems.begin(),
-      randomizers_.subtraction_problems.end(),
-      std::default_random_engine {
-         randomizers_.random_engine });
 }
 
-void MathFactsWidget::GenerateMultiplicationProblem( ) noexcept
+void MathFactsWidget::DiscardUnchosenProblems( ) noexcept
 {
-   for (int32_t top { }; top <= 12; ++top)
+   const uint32_t chosen_operations =
+      TitleButtonID::ALL == chosen_problems_ ?
+         EnabledMathFactBits::ALL :
+         1u << static_cast< uint32_t >(chosen_problems_);
+
+   randomizers_.fact_sampler.RestrictOperations(
+      GetEnabledMathFacts() & chosen_operations);
+
+   for (auto & problem : randomizers_.problems)
    {
-      for (int32_t bottom { }; bottom <= 12; ++bottom)
+      if (problem &&
+          !(chosen_operations &
+            (1u << static_cast< uint32_t >(problem->GetOperation()))))
       {
-         randomizers_.multiplication_problems.emplace_back(
-            std::make_unique< ArithmeticProblem >(
-               top,
-               bottom,
-               ArithmeticProblem::Operation::MUL));
-
-         QObject::connect(
-            randomizers_.multiplication_problems.back().get(),
-            &Problem::Answered,
-            this,
-            &MathFactsWidget::OnProblemAnswered);
+         problem.reset();
       }
    }
+}
 
-   std::shuffle(
-      randomizers_.multiplication_problems.begin(),
-      randomizers_.multiplication_problems.end(),
-      std::default_random_engine {
-         randomizers_.random_engine });
+void MathFactsWidget::StartTask(
+   std::function< void ( ) > task ) noexcept
+{
+   active_tasks_.fetch_add(
+      1,
+      std::memory_order_relaxed);
+
+   task_pool_.start(
+      [ this, task = std::move(task) ] ( )
+      {
+         task();
+
+         active_tasks_.fetch_sub(
+            1,
+            std::memory_order_relaxed);
+      });
+}
+
+void MathFactsWidget::PublishLiveMetrics( ) noexcept
+{
+   live_metrics_data_.updated_unix_ms =
+      static_cast< uint64_t >(
+         std::chrono::duration_cast<
+            std::chrono::milliseconds >(
+               std::chrono::system_clock::now().time_since_epoch()).count());
+   live_metrics_data_.stage =
+      static_cast< uint64_t >(current_stage_);
+   live_metrics_data_.cache_bytes =
+      fact_heatmap_.CacheBytes() +
+      fact_profile_.SizeInBytes();
+   live_metrics_data_.journal_queue_depth =
+      answer_journal_.QueueDepth();
+   live_metrics_data_.journal_dropped_records =
+      answer_journal_.DroppedRecords();
+   live_metrics_data_.background_tasks =
+      active_tasks_.load(
+         std::memory_order_relaxed);
+
+   live_metrics_.Publish(
+      live_metrics_data_);
 }
 
-void MathFactsWidget::GenerateDivisionProblem () noexcept
+std::unique_ptr< Problem > MathFactsWidget::GenerateProblem( ) noexcept
 {
-   for (int32_t denominator { 1 }; denominator <= 12; ++denominator)
+   const uint16_t fact_id =
+      randomizers_.fact_sampler.Next();
+
+   assert(fact_id != FactSampler::NO_FACT);
+
+   std::unique_ptr< Problem > problem;
+
+   if (fact_id < randomizers_.problems.size())
    {
-      for (int32_t answer { }; answer <= 12; ++answer)
-      {
-         randomizers_.division_problems.emplace_back(
-            std::make_unique< ArithmeticProblem >(
-               denominator * answer,
-               denominator,
-               ArithmeticProblem::Operation::DIV));
-
-         QObject::connect(
-            randomizers_.division_problems.back().get(),
-            &Problem::Answered,
-            this,
-            &MathFactsWidget::OnProblemAnswered);
-      }
+      problem =
+         std::move(
+            randomizers_.problems[fact_id]);
    }
 
-   std::shuffle(
-      randomizers_.division_problems.begin(),
-      randomizers_.division_problems.end(),
-      std::default_random_engine {
-         randomizers_.random_engine });
+   if (!problem)
+   {
+      problem =
+         MakeProblem(
+            fact_id);
+   }
+
+   problem->SetStartTime(
+      std::chrono::steady_clock::now());
+
+   return
+      problem;
 }
 
-void MathFactsWidget::GenerateTimeProblem( ) noexcept
+std::unique_ptr< Problem > MathFactsWidget::MakeProblem(
+   const uint16_t fact_id ) noexcept
 {
-   for (uint8_t hour { 1 }; hour <= 12; ++hour)
+   const FactOperands operands =
+      GetFactOperands(
+         fact_id);
+
+   std::unique_ptr< Problem > problem;
+
+   switch (operands.operation)
    {
-      for (uint8_t minute { }; minute < 60; minute += 5)
+   case FactOperation::ADD: [[fallthrough]];
+   case FactOperation::SUB: [[fallthrough]];
+   case FactOperation::MUL: [[fallthrough]];
+   case FactOperation::DIV:
+      problem =
+         std::make_unique< ArithmeticProblem >(
+            operands.top,
+            operands.bottom,
+            static_cast< ArithmeticProblem::Operation >(operands.operation));
+
+      break;
+
+   case FactOperation::TIME:
+      if (operands.time_kind == TimeFactKind::CLOCK)
       {
-         randomizers_.time_problems.emplace_back(
+         problem =
             std::make_unique< TimeProblem >(
-               TimeProblem::Time { hour, minute }));
-
-         randomizers_.time_problems.emplace_back(
-            std::make_unique< TimeProblem >(
-               TimeProblem::MilitaryTime { hour, minute, false }));
-
-         randomizers_.time_problems.emplace_back(
+               TimeProblem::Time { operands.hour, operands.minute });
+      }
+      else
+      {
+         problem =
             std::make_unique< TimeProblem >(
-               TimeProblem::MilitaryTime { hour, minute, true }));
+               TimeProblem::MilitaryTime {
+                  operands.hour,
+                  operands.minute,
+                  operands.time_kind == TimeFactKind::MILITARY_AFTERNOON });
       }
-   }
 
-   for (const auto & time_problem : randomizers_.time_problems)
-   {
-      QObject::connect(
-         time_problem.get(),
-         &Problem::Answered,
-         this,
-         &MathFactsWidget::OnProblemAnswered);
+      break;
    }
 
-   std::shuffle(
-      randomizers_.time_problems.begin(),
-      randomizers_.time_problems.end(),
-      std::default_random_engine {
-         randomizers_.random_engine });
+   QObject::connect(
+      problem.get(),
+      &Problem::Answered,
+      this,
+      &MathFactsWidget::OnProblemAnswered);
+
+   return
+      problem;
 }
 
-void MathFactsWidget::OnProblemAnswered(
-   const AnswerResult result ) noexcept
-{
-   if (result == AnswerResult::CORRECT)
-   {
-      current_problem_->SetEndTime(
-         std::chrono::steady_clock::now());
+void MathFactsWidget::OnProblemAnswered(
+   const AnswerResult result ) noexcept
+{
+   if (result == AnswerResult::CORRECT)
+   {
+      // the answer was given when the enter key went down,
+      // not when the event loop got around to processing it
+      current_problem_->SetEndTime(
+         current_problem_->GetLastKeyPressTime());
+
+      fact_heatmap_.Add(
+         current_problem_->GetFactId(),
+         std::chrono::duration_cast<
+            std::chrono::milliseconds >(
+               current_problem_->GetResponseTime()),
+         current_problem_->GetNumberOfResponses());
+
+      const uint64_t answered_unix_ms =
+         static_cast< uint64_t >(
+            std::chrono::duration_cast<
+               std::chrono::milliseconds >(
+                  std::chrono::system_clock::now().time_since_epoch()).count());
+
+      fact_profile_.Record(
+         current_problem_->GetFactId(),
+         static_cast< uint32_t >(
+            std::chrono::duration_cast<
+               std::chrono::milliseconds >(
+                  current_problem_->GetResponseTime()).count()),
+         current_problem_->GetNumberOfResponses(),
+         answered_unix_ms);
+
+      session_statistics_.Add(
+         SessionStatistics::Answer {
+            current_problem_->GetOperation(),
+            current_problem_->GetResponseTime(),
+            current_problem_->GetThinkTime(),
+            current_problem_->GetTypingTime(),
+            current_problem_->GetUiLatency(),
+            current_problem_->GetNumberOfResponses() });
+
+      const auto ToMilliseconds =
+         [ ] (
+            const std::chrono::steady_clock::duration duration )
+         {
+            return
+               static_cast< uint32_t >(
+                  std::chrono::duration_cast<
+                     std::chrono::milliseconds >(
+                        duration).count());
+         };
+
+      answer_records_.push_back(
+         AnswerRecord {
+            current_problem_->GetFactId(),
+            current_problem_->GetOperation(),
+            static_cast< uint64_t >(
+               std::chrono::duration_cast<
+                  std::chrono::milliseconds >(
+                     current_problem_->GetEndTime() -
+                     practice_stopwatch_.start_time).count()),
+            ToMilliseconds(current_problem_->GetResponseTime()),
+            ToMilliseconds(current_problem_->GetThinkTime()),
+            ToMilliseconds(current_problem_->GetTypingTime()),
+            ToMilliseconds(current_problem_->GetUiLatency()),
+            current_problem_->GetResponseValues(),
+            current_problem_->GetQuestionWithAnswer().toStdString() });
+
+      answer_journal_.Append(
+         answer_records_.back());
+
+      classroom_feed_.Append(
+         ClassroomAnswer {
+            answer_records_.back().fact_id,
+            answer_records_.back().operation,
+            static_cast< uint8_t >(
+               std::min< size_t >(
+                  current_problem_->GetNumberOfResponses(),
+                  UINT8_MAX)),
+            answer_records_.back().response_time_ms,
+            answered_unix_ms });
+
+      ++live_metrics_data_.problems_answered;
+
+      live_metrics_data_.retried_answers +=
+         current_problem_->GetNumberOfResponses() > 1;
 
       answered_problems_.emplace_back(
          std::move(current_problem_));
@@ -550,228 +1009,101 @@ void MathFactsWidget::OnProblemAnswered(
       std::chrono::seconds { 1 },
       this,
       &MathFactsWidget::OnAnswerImageTimeout);
-}
-
-void MathFactsWidget::WriteReport( ) const noexcept
-{
-   auto report_directory =
-      GetReportsDirectory();
-
-   const bool can_write_report =
-      !std::filesystem::exists(report_directory) ||
-      std::filesystem::is_directory(report_directory);
 
-   if (!can_write_report)
+   if (result == AnswerResult::CORRECT &&
+       IsSessionComplete())
    {
-      QMessageBox::critical(
-         nullptr,
-         "Write Report Error",
-         QString {
-            "Cannot write to report directory.  The directory "
-            "'{}' already exists and is not a directory." }
-               .arg(QString::fromStdString(report_directory.string())),
-         QMessageBox::StandardButton::Ok);
+      EndSession();
    }
-   else
-   {
-      if (!std::filesystem::exists(report_directory))
-      {
-         std::error_code create_dir_error { };
-         
-         const bool directory_created =
-            std::filesystem::create_directory(
-               report_directory,
-               create_dir_error);
-
-         if (!directory_created)
-         {
-            QMessageBox::critical(
-               nullptr,
-               "Write Report Error",
-               QString {
-                  "Cannot write to report directory.  The directory "
-                  "'{}' could not be created (EC: {})." }
-                     .arg(QString::fromStdString(report_directory.string()))
-                     .arg(QString::fromStdString(create_dir_error.message())),
-               QMessageBox::StandardButton::Ok);
-         }
-      }
+}
 
-      const auto report_filepath =
-         report_directory /
-         (GenerateReportName() +
-          ".txt");
+bool MathFactsWidget::IsSessionComplete( ) const noexcept
+{
+   return
+      Stage::OVERTIME == current_stage_ &&
+      answered_problems_.size() >= minimum_amount_to_practice_;
+}
 
-      std::ofstream report_file {
-         report_filepath,
-         std::ios_base::out
-      };
+void MathFactsWidget::EndSession( ) noexcept
+{
+   current_stage_ =
+      Stage::SESSION_END;
+   report_state_ =
+      ReportState::WRITING;
 
-      if (!report_file.is_open())
-      {
-         QMessageBox::critical(
-            nullptr,
-            "Write Report Error",
-            QString {
-               "Cannot write to report file.  The file "
-               "'{}' could not be opened for writing." }
-                  .arg(QString::fromStdString(report_filepath.string())),
-            QMessageBox::StandardButton::Ok);
-      }
-      else
-      {
-         std::vector< const Problem * > answered_problems_for_sort;
+   practice_stopwatch_.periodic_update_timer.stop();
+   practice_stopwatch_.deadline_timer.stop();
 
-         answered_problems_for_sort.reserve(
-            answered_problems_.size());
+   fact_profile_.Flush();
 
-         qreal percentage_answers_correct { };
-         std::chrono::milliseconds average_response_time { };
+   session_performance_.SampleMemory(
+      fact_heatmap_.CacheBytes() +
+      Problem::CanvasBytes());
 
-         for (const auto & answer : answered_problems_)
-         {
-            average_response_time +=
-               std::chrono::duration_cast<
-                  std::chrono::milliseconds >(
-                     answer->GetResponseTime());
+   current_problem_.reset();
+   answer_image_ = nullptr;
 
-            answered_problems_for_sort.push_back(
-               answer.get());
+   // the results are not drawn from them
+   Problem::ReleaseCanvases();
 
-            if (answer->GetNumberOfResponses() == 1)
-            {
-               ++percentage_answers_correct;
-            }
-         }
+   update();
 
-         if (!answered_problems_.empty())
-         {
-            average_response_time /= answered_problems_.size();
-            percentage_answers_correct /= answered_problems_.size();
-         }
+   auto snapshot =
+      std::make_shared< SessionSnapshot >();
 
-         report_file
-            << "duration = "
-            << GetMathPracticeDuration()
-            << "\n";
-
-         report_file
-            << "total problems answered = "
-            << answered_problems_.size()
-            << "\n";
-
-         report_file
-            << "average response time = "
-            << average_response_time
-            << "\n";
-
-         report_file
-            << "standard deviation response time = "
-            << CalculateStandardDeviationResponseTime()
-            << "\n";
-
-         report_file
-            << "percentage correct = "
-            << percentage_answers_correct
-            << "\n";
-
-         const auto PrintAnswer =
-            [ & ] (
-               const Problem & answer )
-            {
-               const auto response_time =
-                  std::chrono::duration_cast<
-                     std::chrono::milliseconds >(
-                        answer.GetResponseTime());
-
-               report_file
-                  << answer.GetQuestionWithAnswer().toStdString()
-                  << "; response time ms = "
-                  << response_time
-                  << "; responses = ";
-
-               for (const auto & response : answer.GetResponses())
-               {
-                  report_file
-                     << response.toStdString()
-                     << "   ";
-               }
-
-               report_file << "\n";
-            };
-
-         report_file
-            << "\ntop ten most responses\n";
-
-         std::sort(
-            answered_problems_for_sort.begin(),
-            answered_problems_for_sort.end(),
-            [ ] (
-               const Problem * const l,
-               const Problem * const r )
-            {
-               return
-                  r->GetNumberOfResponses() <
-                  l->GetNumberOfResponses();
-            });
-
-         std::for_each(
-            answered_problems_for_sort.begin(),
-            answered_problems_for_sort.size() >= 10 ?
-               answered_problems_for_sort.begin() + 10 :
-               answered_problems_for_sort.end(),
-            [ & ] (
-               const Problem * const problem )
-            {
-               PrintAnswer(
-                  *problem);
-            });
-
-         report_file
-            << "\ntop ten longest responses\n";
-
-         std::sort(
-            answered_problems_for_sort.begin(),
-            answered_problems_for_sort.end(),
-            [ ] (
-               const Problem * const l,
-               const Problem * const r )
-            {
-               const auto response_time_l =
-                  l->GetResponseTime();
-               const auto response_time_r =
-                  r->GetResponseTime();
-
-               return
-                  response_time_r <
-                  response_time_l;
-            });
-
-         std::for_each(
-            answered_problems_for_sort.begin(),
-            answered_problems_for_sort.size() >= 10 ?
-               answered_problems_for_sort.begin() + 10 :
-               answered_problems_for_sort.end(),
-            [ & ] (
-               const Problem * const problem )
-            {
-               PrintAnswer(
-                  *problem);
-            });
+   snapshot->username =
+      GetCurrentUserName();
+   snapshot->end_time =
+      std::chrono::system_clock::now();
+   snapshot->reports_directory =
+      settings_->reports_directory;
+   snapshot->journal_path =
+      answer_journal_.GetPath();
+   snapshot->header =
+      SessionHeader {
+         static_cast< uint64_t >(
+            std::chrono::duration_cast<
+               std::chrono::milliseconds >(
+                  practice_stopwatch_.start_system_time.time_since_epoch()).count()),
+         static_cast< uint32_t >(
+            GetMathPracticeDuration().count()),
+         minimum_amount_to_practice_,
+         GetEnabledMathFacts(),
+         static_cast< uint32_t >(chosen_problems_)
+      };
+   snapshot->export_formats =
+      GetExportFormats();
+   snapshot->statistics =
+      session_statistics_;
+   snapshot->answers =
+      std::move(answer_records_);
+   snapshot->performance =
+      session_performance_;
+
+   // formatting and writing the reports, as well as flushing the journal,
+   // happens off the gui thread on a snapshot that is never modified again
+   StartTask(
+      [ this,
+        snapshot = std::shared_ptr< const SessionSnapshot > { std::move(snapshot) } ] ( )
+      {
+         answer_journal_.Stop();
 
-         report_file
-            << "\nall answers\n";
+         const SessionReportResult result =
+            WriteSessionReport(
+               *snapshot);
 
-         for (const auto & answer : answered_problems_)
-         {
-            PrintAnswer(
-               *answer);
-         }
-      }
-   }
+         QMetaObject::invokeMethod(
+            this,
+            [ this, result ] ( )
+            {
+               OnReportWritten(
+                  result);
+            },
+            Qt::ConnectionType::QueuedConnection);
+      });
 }
 
-std::string MathFactsWidget::GetCurrentUserName( ) const noexcept
+std::string MathFactsWidget::GetCurrentUserName( ) noexcept
 {
 #if _WIN32
    return
@@ -784,300 +1116,237 @@ std::string MathFactsWidget::GetCurrentUserName( ) const noexcept
 #endif
 }
 
-std::string MathFactsWidget::GenerateReportName( ) const noexcept
+void MathFactsWidget::StartPractice( ) noexcept
 {
-   const std::string username =
-      GetCurrentUserName();
+   if (Stage::TITLE == current_stage_)
+   {
+      OnTitleButtonPressed(
+         TitleButtonID::ALL);
+   }
+}
 
-#if __has_include(<format>)
-   // may throw but lets assume not
-   const std::string date_time =
-      std::format(
-         "{:%F-%H.%M.%OS}",
-         std::chrono::current_zone()->to_local(
-            std::chrono::system_clock::now()));
-#else
-   const auto sys_time_now =
-      std::chrono::system_clock::to_time_t(
-         std::chrono::system_clock::now());
+void MathFactsWidget::FinishPractice( ) noexcept
+{
+   if (IsPracticing())
+   {
+      EndSession();
+   }
+}
 
-   std::string date_time;
-   date_time.resize(512);
+bool MathFactsWidget::IsPracticing( ) const noexcept
+{
+   return
+      Stage::MATH_PRACTICE == current_stage_ ||
+      Stage::OVERTIME == current_stage_;
+}
 
-   std::tm local_time_now;
+bool MathFactsWidget::IsWritingReport( ) const noexcept
+{
+   return
+      (Stage::SESSION_END == current_stage_ ||
+       Stage::RESULTS == current_stage_) &&
+      ReportState::WRITING == report_state_;
+}
 
-   // assume no failures for both
-#ifdef _WIN32
-   localtime_s(
-      &local_time_now,
-      &sys_time_now);
-#else
-   localtime_r(
-      &sys_time_now,
-      &local_time_now);
-#endif // _WIN32
-
-   const size_t bytes_written =
-      std::strftime(
-         date_time.data(),
-         date_time.size(),
-         "%F-%H.%M.%S",
-         &local_time_now);
-
-   date_time.resize(
-      bytes_written);
-#endif // __has_include(<format>)
+uint16_t MathFactsWidget::GetCurrentFactId( ) const noexcept
+{
+   return
+      current_problem_ ?
+         current_problem_->GetFactId() :
+         FACT_ID_COUNT;
+}
+
+const LiveMetricsData & MathFactsWidget::GetLiveMetrics( ) const noexcept
+{
+   return
+      live_metrics_data_;
+}
 
+std::string MathFactsWidget::GenerateReportName( ) const noexcept
+{
    return
-      username +
-      "-" +
-      date_time;
+      FormatReportName(
+         GetCurrentUserName(),
+         std::chrono::system_clock::now());
 }
 
-std::unique_ptr< QSettings > MathFactsWidget::GetSettings( ) const noexcept
+void MathFactsWidget::OnSettingsChanged(
+   const std::shared_ptr< const MathFactsSettings > & settings ) noexcept
 {
-   std::unique_ptr< QSettings > settings;
+   if (Stage::TITLE != current_stage_)
+      return;
+
+   settings_ =
+      settings;
 
+   UpdateTitleButtons();
+
+   // the enabled facts may have changed
+   StartWarmUp();
+}
+
+std::filesystem::path MathFactsWidget::GetProfilePath( ) noexcept
+{
    const std::string username =
       GetCurrentUserName();
 
-   const std::filesystem::path application_dir_path =
-      QApplication::applicationDirPath().toStdString();
+   const std::string profile_name =
+      username + "-math-facts" + FactProfile::EXTENSION;
 
-#if _MSC_VER
+   // the profile lives next to the user's settings, looked for in the
+   // same directories and order
+   const auto directories =
+      GetSettingsDirectories();
 
-   const std::filesystem::path current_working_dir_path =
-      std::filesystem::current_path();
-
-   if (const auto settings_path =
-          current_working_dir_path / (username + "-math-facts.ini");
-       std::filesystem::is_regular_file(settings_path))
-   {
-      settings =
-         std::make_unique< QSettings >(
-            QString::fromStdString(
-               settings_path.string()),
-            QSettings::Format::IniFormat);
-   }
-   else if (const auto settings_path =
-               current_working_dir_path / ("math-facts.ini");
-            std::filesystem::is_regular_file(settings_path))
+   for (const auto & directory : directories)
    {
-      settings =
-         std::make_unique< QSettings >(
-            QString::fromStdString(
-               settings_path.string()),
-            QSettings::Format::IniFormat);
-   }
-   else
-   
-#endif // _MSC_VER
+      std::error_code error;
 
-   if (const auto settings_path =
-          application_dir_path / (username + "-math-facts.ini");
-      std::filesystem::is_regular_file(settings_path))
-   {
-      settings =
-         std::make_unique< QSettings >(
-            QString::fromStdString(
-               settings_path.string()),
-            QSettings::Format::IniFormat);
-   }
-   else if (const auto settings_path =
-               application_dir_path / (username + "-math-facts.ini");
-            std::filesystem::is_regular_file(settings_path))
-   {
-      settings =
-         std::make_unique< QSettings >(
-            QString::fromStdString(
-               settings_path.string()),
-            QSettings::Format::IniFormat);
-   }
-   else
-   {
-      settings =
-         std::make_unique< QSettings >(
-            "math-facts.ini",
-            QSettings::Format::IniFormat);
+      if (std::filesystem::is_regular_file(directory / profile_name, error) ||
+          std::filesystem::is_regular_file(directory / (username + "-math-facts.ini"), error))
+      {
+         return
+            directory / profile_name;
+      }
    }
 
    return
-      settings;
+      directories.back() / profile_name;
 }
 
 uint32_t MathFactsWidget::GetEnabledMathFacts( ) const noexcept
 {
-   uint32_t enabled_math_facts {
-      EnabledMathFactBits::ADD |
-      EnabledMathFactBits::SUB |
-      EnabledMathFactBits::MUL |
-      EnabledMathFactBits::DIV |
-      EnabledMathFactBits::TIME
-   };
-
-   const auto settings =
-      GetSettings();
-
-   enabled_math_facts =
-      settings->value(
-         "enabled_math_facts",
-         enabled_math_facts).toString().toInt(
-            nullptr,
-            16);
-
    return
-      enabled_math_facts;
+      settings_->enabled_math_facts;
 }
 
-std::filesystem::path MathFactsWidget::GetReportsDirectory( ) const noexcept
+std::filesystem::path MathFactsWidget::GetReportsDirectory( ) noexcept
 {
-   std::string directory { "../math-facts-reports/" };
-
+   const auto settings_path =
+      FindSettingsFile(
+         GetCurrentUserName());
    const auto settings =
-      GetSettings();
-
-   directory =
-      settings->value(
-         "reports_directory",
-         QString::fromStdString(directory))
-            .toString()
-            .toStdString();
+      LoadSettings(
+         settings_path);
 
+   // an unreadable file behaves like a missing one, as it does at startup
    return
-      directory;
+      settings ?
+         settings->reports_directory :
+         DefaultSettings(settings_path).reports_directory;
 }
 
 std::chrono::milliseconds MathFactsWidget::GetMathPracticeDuration( ) const noexcept
 {
-   int32_t duration { 300000 };
-
-   const auto settings =
-      GetSettings();
-
-   duration =
-      settings->value(
-         "math_practice_duration_ms",
-         duration).toInt();
-
-   if (duration <= 0)
-   {
-      duration = 300000;
-   }
-
    return
-      std::chrono::milliseconds {
-         duration
-      };
+      settings_->math_practice_duration;
 }
 
 std::chrono::milliseconds MathFactsWidget::CalculateStandardDeviationResponseTime( ) const noexcept
 {
-   std::chrono::milliseconds standard_deviation { };
-
-   if (answered_problems_.size() > 1)
-   {
-      std::chrono::milliseconds average_response_time { };
-
-      for (const auto & answer : answered_problems_)
-      {
-         average_response_time +=
-            std::chrono::duration_cast<
-               std::chrono::milliseconds >(
-                  answer->GetResponseTime());
-      }
-      
-      average_response_time /= answered_problems_.size();
-
-      std::chrono::milliseconds::rep sum_of_squares { };
+   // maintained incrementally as each problem is answered
+   return
+      session_statistics_.StandardDeviationResponseTime();
+}
 
-      for (const auto & answer : answered_problems_)
+void MathFactsWidget::StartReportArchiving( ) noexcept
+{
+   const auto archive_reports_after =
+      GetArchiveReportsAfter();
+
+   if (archive_reports_after.count() <= 0)
+      return;
+
+   // runs while the title stage is shown; reports that could not be
+   // archived are simply tried again on the next launch
+   StartTask(
+      [ this,
+        reports_directory = settings_->reports_directory,
+        archive_reports_after ] ( )
       {
-         const auto deviation_from_mean =
-            (std::chrono::duration_cast<
-               std::chrono::milliseconds >(
-                  answer->GetResponseTime()) -
-             average_response_time).count();
-
-         const auto deviation_from_mean_squared =
-            deviation_from_mean * deviation_from_mean;
-
-         sum_of_squares +=
-            deviation_from_mean_squared;
-      }
-
-      const auto variance =
-         sum_of_squares /
-         (answered_problems_.size() - 1.0);
+         ArchiveReports(
+            reports_directory,
+            archive_reports_after,
+            archive_stop_requested_);
+      });
+}
 
-      standard_deviation =
-         std::chrono::milliseconds {
-            static_cast< std::chrono::milliseconds::rep >(
-               std::sqrt(variance))
-         };
-   }
+std::chrono::days MathFactsWidget::GetArchiveReportsAfter( ) const noexcept
+{
+   return
+      settings_->archive_reports_after;
+}
 
+uint32_t MathFactsWidget::GetExportFormats( ) const noexcept
+{
    return
-      standard_deviation;
+      settings_->export_formats;
 }
 
 uint32_t MathFactsWidget::GetMinimumAmountToPractice( ) const noexcept
 {
-   int32_t minimum { 50 };
-
-   const auto settings =
-      GetSettings();
-
-   minimum =
-      settings->value(
-         "minimum_amount_to_practice",
-         minimum).toInt();
-
-   if (minimum <= 0)
-   {
-      minimum = 50;
-   }
-
    return
-      minimum;
+      settings_->minimum_amount_to_practice;
 }
 
 void MathFactsWidget::PaintProblem(
-   QPaintEvent * paint_event ) noexcept
+   QPaintEvent * paint_event,
+   QPainter & painter ) noexcept
 {
-   if (!practice_stopwatch_.PracticeTimeExceeded() ||
-       answered_problems_.size() < minimum_amount_to_practice_)
-   {
-      PaintBackground(
-         paint_event);
+   PaintBackground(
+      painter);
 
-      PaintProblemText(
-         paint_event);
+   PaintProblemText(
+      paint_event,
+      painter);
 
-      PaintAnswerImage(
-         paint_event);
+   PaintAnswerImage(
+      painter);
 
-      PaintStopwatch(
-         paint_event);
-   }
-   else
-   {
-      QMessageBox::information(
-         this,
-         "Time Expired",
-         "The time allotted has expired.",
-         QMessageBox::StandardButton::Ok);
+   // moves the painter, so it comes last
+   PaintStopwatch(
+      painter);
+}
 
-      WriteReport();
+void MathFactsWidget::PaintBackground(
+   QPainter & painter ) noexcept
+{
+   const qreal pixel_ratio =
+      devicePixelRatioF();
 
-      QApplication::exit(0);
+   if (background_colors_ != current_colors_ ||
+       background_.size() != size() * pixel_ratio)
+   {
+      RenderBackground();
    }
+
+   painter.drawPixmap(
+      0, 0,
+      background_);
 }
 
-void MathFactsWidget::PaintBackground(
-   QPaintEvent * paint_event ) noexcept
+void MathFactsWidget::RenderBackground( ) noexcept
 {
+   const qreal pixel_ratio =
+      devicePixelRatioF();
+
+   // drawn at the pixel ratio of the screen, so that it is copied
+   // without scaling
+   background_ =
+      QPixmap {
+         size() * pixel_ratio
+      };
+
+   background_.setDevicePixelRatio(
+      pixel_ratio);
+   background_.fill(
+      current_colors_->background);
+
+   background_colors_ =
+      current_colors_;
+
    QPainter painter {
-      this
+      &background_
    };
 
    painter.setRenderHint(
@@ -1106,18 +1375,26 @@ void MathFactsWidget::PaintBackground(
 }
 
 void MathFactsWidget::PaintProblemText(
-   QPaintEvent * paint_event ) noexcept
+   QPaintEvent * paint_event,
+   QPainter & painter ) noexcept
 {
    if (current_problem_)
    {
       current_problem_->OnPaintEvent(
          paint_event,
+         painter,
          *this);
+
+      if (!current_problem_->IsPresented())
+      {
+         current_problem_->SetPresentedTime(
+            std::chrono::steady_clock::now());
+      }
    }
 }
 
 void MathFactsWidget::PaintAnswerImage(
-   QPaintEvent * paint_event ) noexcept
+   QPainter & painter ) noexcept
 {
    if (answer_image_)
    {
@@ -1126,8 +1403,6 @@ void MathFactsWidget::PaintAnswerImage(
             width() * 0.3,
             height() * 0.3);
 
-      QPainter painter { this };
-
       painter.setRenderHint(
          QPainter::RenderHint::SmoothPixmapTransform,
          true);
@@ -1140,7 +1415,7 @@ void MathFactsWidget::PaintAnswerImage(
 }
 
 void MathFactsWidget::PaintStopwatch(
-   QPaintEvent * paint_event) noexcept
+   QPainter & painter ) noexcept
 {
    assert(
       practice_stopwatch_.base_image.size() ==
@@ -1149,77 +1424,61 @@ void MathFactsWidget::PaintStopwatch(
       practice_stopwatch_.hand_image.size() ==
       (QSize { 42, 152 }));
 
-   QPixmap stopwatch_pixmap {
-      practice_stopwatch_.base_image };
+   const qreal window_length =
+      std::min(
+         width() * 0.3,
+         height() * 0.3);
 
-   QPainter stopwatch_painter {
-      &stopwatch_pixmap };
+   painter.setRenderHint(
+      QPainter::RenderHint::SmoothPixmapTransform,
+      true);
 
-   const auto total_time =
-      practice_stopwatch_.end_time -
-      practice_stopwatch_.start_time;
-   const auto remaining_time =
-      practice_stopwatch_.end_time -
-      std::chrono::steady_clock::now();
+   // both images are drawn straight onto the widget, in the coordinates
+   // of the base image, rather than onto a copy of the base image
+   painter.translate(
+      30.0,
+      height() - window_length - 30.0);
+   painter.scale(
+      window_length / practice_stopwatch_.base_image.width(),
+      window_length / practice_stopwatch_.base_image.height());
 
-   const qreal hand_rotation =
-      remaining_time.count() >= 0 ?
-         remaining_time.count() * 360.0 / total_time.count() :
-         0.0;
+   painter.drawPixmap(
+      0, 0,
+      practice_stopwatch_.base_image);
 
-   stopwatch_painter.translate(
+   painter.translate(
       256.0,
       284.0);
-   stopwatch_painter.rotate(
-      hand_rotation);
+   painter.rotate(
+      practice_stopwatch_.hand_rotation);
 
-   stopwatch_painter.drawPixmap(
+   painter.drawPixmap(
       QRect {
          -21, -131,
          practice_stopwatch_.hand_image.width(),
          practice_stopwatch_.hand_image.height() },
       practice_stopwatch_.hand_image);
-
-   const qreal window_length =
-      std::min(
-         width() * 0.3,
-         height() * 0.3);
-
-   QPainter painter { this };
-
-   painter.setRenderHint(
-      QPainter::RenderHint::SmoothPixmapTransform,
-      true);
-
-   painter.drawPixmap(
-      QRectF {
-         30.0, height() - window_length - 30.0,
-         window_length, window_length },
-      stopwatch_pixmap,
-      stopwatch_pixmap.rect());
 }
 
 void MathFactsWidget::PaintTitleStage(
-   QPaintEvent * paint_event ) noexcept
+   QPainter & painter ) noexcept
 {
    PaintBackground(
-      paint_event);
+      painter);
 
    const auto title_pixmap =
       QPixmap { ":/math-facts-title-image" }.scaledToWidth(
          width() - 60,
          Qt::TransformationMode::SmoothTransformation);
 
-   QPainter title_painter { this };
-
-   title_painter.setRenderHint(
+   painter.setRenderHint(
       QPainter::RenderHint::Antialiasing,
       true);
-   title_painter.setRenderHint(
+   painter.setRenderHint(
       QPainter::RenderHint::SmoothPixmapTransform,
       true);
 
-   title_painter.drawPixmap(
+   painter.drawPixmap(
       QRect { 30, 30, width() - 60, title_pixmap.height() },
       title_pixmap);
 
@@ -1232,4 +1491,127 @@ void MathFactsWidget::PaintTitleStage(
             width(),
             height() - title_pixmap.height() - 70 });
    }
-}
\ No newline at end of file
+}
+
+void MathFactsWidget::PaintSessionEndStage(
+   QPainter & painter ) noexcept
+{
+   PaintBackground(
+      painter);
+
+   QString status;
+
+   switch (report_state_)
+   {
+   case ReportState::WRITING:
+      status = "Saving the report...";
+      break;
+
+   case ReportState::WRITTEN:
+      status = "The report has been saved.\nPress Enter to exit.";
+      break;
+
+   case ReportState::FAILED:
+      status = "The report could not be saved.\nPress Enter to exit.";
+      break;
+   }
+
+   painter.setRenderHint(
+      QPainter::RenderHint::TextAntialiasing,
+      true);
+
+   QFont font {
+      painter.font()
+   };
+
+   font.setPixelSize(
+      std::max(12, height() / 16));
+
+   painter.setFont(
+      font);
+   painter.setPen(
+      current_colors_->text);
+
+   QTextOption text_option {
+      Qt::AlignmentFlag::AlignCenter
+   };
+
+   text_option.setWrapMode(
+      QTextOption::WrapMode::WordWrap);
+
+   painter.drawText(
+      QRectF { 30.0, 30.0, width() - 60.0, height() - 60.0 },
+      "The time allotted has expired.\n\n" +
+      status,
+      text_option);
+}
+
+void MathFactsWidget::PaintResultsStage(
+   QPainter & painter ) noexcept
+{
+   PaintBackground(
+      painter);
+
+   const QString status =
+      report_state_ == ReportState::WRITTEN ?
+         "The report has been saved.  Press Enter to exit." :
+         "The report could not be saved.  Press Enter to exit.";
+
+   // the results fade and slide in once the report is written
+   const double progress =
+      std::min(
+         1.0,
+         std::chrono::duration< double > {
+            std::chrono::steady_clock::now() - results_start_time_ } /
+         RESULTS_ANIMATION_DURATION);
+   const double eased =
+      1.0 - (1.0 - progress) * (1.0 - progress);
+
+   painter.setRenderHint(
+      QPainter::RenderHint::TextAntialiasing,
+      true);
+
+   QFont font {
+      painter.font()
+   };
+
+   font.setPixelSize(
+      std::max(12, height() / 28));
+
+   painter.setFont(
+      font);
+   painter.setPen(
+      current_colors_->text);
+
+   const qreal text_height =
+      QFontMetrics { font }.height() * 2.5;
+
+   QTextOption text_option {
+      Qt::AlignmentFlag::AlignCenter
+   };
+
+   text_option.setWrapMode(
+      QTextOption::WrapMode::WordWrap);
+
+   painter.drawText(
+      QRectF { 45.0, 40.0, width() - 90.0, text_height },
+      status +
+      "\nEach square is a fact; green was quick, red was slow, "
+      "and a corner mark means it took more than one try.",
+      text_option);
+
+   painter.setOpacity(
+      eased);
+   painter.translate(
+      0.0,
+      (1.0 - eased) * height() / 10.0);
+
+   fact_heatmap_.Paint(
+      painter,
+      QRectF {
+         45.0,
+         40.0 + text_height + 10.0,
+         width() - 90.0,
+         height() - text_height - 100.0 },
+      current_colors_->text);
+}
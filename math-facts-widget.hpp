@@ -1,25 +1,45 @@
 #ifndef _MATH_FACTS_WIDGET_HPP_
 #define _MATH_FACTS_WIDGET_HPP_
 
+#include "answer-journal.hpp"
+#include "answer-record.hpp"
+#include "classroom-feed.hpp"
+#include "fact-heatmap.hpp"
+#include "fact-profile.hpp"
+#include "fact-sampler.hpp"
+#include "live-metrics.hpp"
+#include "math-facts-settings.hpp"
+#include "power-policy.hpp"
+#include "session-performance.hpp"
+#include "session-report.hpp"
+#include "session-statistics.hpp"
+
 //#include <QtCore/QString>
+#include <QtCore/QThreadPool>
 #include <QtCore/QTimer>
+#include <QtCore/QString>
 #include <QtGui/QColor>
+#include <QtGui/QImage>
 #include <QtGui/QKeyEvent>
 #include <QtGui/QPaintEvent>
+#include <QtGui/QPainter>
 #include <QtGui/QPixmap>
 #include <QtWidgets/QWidget>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
-class QSettings;
-
 class Problem;
 
 enum class AnswerResult : uint8_t;
@@ -32,10 +52,25 @@ public:
       QWidget * const parent ) noexcept;
    virtual ~MathFactsWidget( ) noexcept;
 
+   // reads the settings once, for use where no widget exists
+   static std::filesystem::path GetReportsDirectory( ) noexcept;
+   static std::string GetCurrentUserName( ) noexcept;
+
+   // drive a session without a person at the keyboard, as the simulator
+   // does; the answers themselves still arrive as key presses
+   void StartPractice( ) noexcept;
+   void FinishPractice( ) noexcept;
+   bool IsPracticing( ) const noexcept;
+   bool IsWritingReport( ) const noexcept;
+   // FACT_ID_COUNT while no problem is shown
+   uint16_t GetCurrentFactId( ) const noexcept;
+   // as last published
+   const LiveMetricsData & GetLiveMetrics( ) const noexcept;
+
 protected:
    virtual void paintEvent(
       QPaintEvent * paint_event ) override;
-   virtual void keyReleaseEvent(
+   virtual void keyPressEvent(
       QKeyEvent * event ) override;
 
 private slots:
@@ -50,6 +85,13 @@ private slots:
    };
 
    void OnAnswerImageTimeout( ) noexcept;
+   void OnResultsAnimationTimeout( ) noexcept;
+   void OnStopwatchTimeout( ) noexcept;
+   void OnPracticeDeadline( ) noexcept;
+   // starts and stops the timers of the stage for what can be seen
+   void OnPowerModeChanged( ) noexcept;
+   void OnReportWritten(
+      const SessionReportResult & result ) noexcept;
    void OnTitleButtonPressed(
       const TitleButtonID title_button_id ) noexcept;
 
@@ -63,19 +105,13 @@ private:
 
    struct Randomizers
    {
-      std::default_random_engine random_engine {
+      FactSampler fact_sampler {
          std::random_device { } ()
       };
 
-      std::uniform_int_distribution< uint32_t > problem_distribution {
-         0, 4
-      };
-
-      std::vector< std::unique_ptr< Problem > > addition_problems;
-      std::vector< std::unique_ptr< Problem > > subtraction_problems;
-      std::vector< std::unique_ptr< Problem > > multiplication_problems;
-      std::vector< std::unique_ptr< Problem > > division_problems;
-      std::vector< std::unique_ptr< Problem > > time_problems;
+      // problems built ahead of the session, by fact id; a fact drawn
+      // without one gets its problem built when drawn
+      std::vector< std::unique_ptr< Problem > > problems;
    };
 
    struct Stopwatch
@@ -83,25 +119,130 @@ private:
       QPixmap base_image;
       QPixmap hand_image;
 
+      // moves the hand while practicing
       QTimer periodic_update_timer;
+      // fires once, at the end time
+      QTimer deadline_timer;
 
       std::chrono::steady_clock::time_point start_time;
       std::chrono::steady_clock::time_point end_time;
+      std::chrono::system_clock::time_point start_system_time;
+
+      // time the stopwatch was paused for, already added to the end time
+      std::chrono::steady_clock::duration paused_duration { };
+      std::optional< std::chrono::steady_clock::time_point > paused_time;
+
+      // set by the timers, so a paint only draws it
+      qreal hand_rotation { };
+
+      void Pause(
+         const std::chrono::steady_clock::time_point now ) noexcept
+      {
+         if (paused_time || !deadline_timer.isActive())
+            return;
 
-      bool PracticeTimeExceeded( ) const noexcept
+         paused_time = now;
+
+         deadline_timer.stop();
+      }
+
+      // the remaining time is exactly what it was when paused
+      void Resume(
+         const std::chrono::steady_clock::time_point now ) noexcept
+      {
+         if (!paused_time)
+            return;
+
+         const auto paused_for =
+            now - *paused_time;
+
+         paused_duration += paused_for;
+         end_time += paused_for;
+         paused_time.reset();
+
+         deadline_timer.start(
+            std::chrono::ceil<
+               std::chrono::milliseconds >(
+                  end_time - now));
+      }
+
+      void UpdateHandRotation(
+         const std::chrono::steady_clock::time_point now ) noexcept
       {
+         const auto total_time = end_time - start_time - paused_duration;
+         const auto remaining_time = end_time - now;
+
+         hand_rotation =
+            remaining_time.count() > 0 && total_time.count() > 0 ?
+               remaining_time.count() * 360.0 / total_time.count() :
+               0.0;
+      }
+   };
+
+   struct InputClock
+   {
+      // offset from the input event clock to the steady clock
+      std::optional< std::chrono::steady_clock::duration > offset;
+
+      std::chrono::steady_clock::time_point ToSteadyTime(
+         const uint64_t event_timestamp_ms,
+         const std::chrono::steady_clock::time_point handled_time ) noexcept
+      {
+         if (event_timestamp_ms == 0)
+         {
+            // synthesized events do not carry a timestamp
+            return
+               handled_time;
+         }
+
+         const std::chrono::milliseconds event_time {
+            event_timestamp_ms
+         };
+
+         // the smallest offset observed belongs to the event that was
+         // delivered with the least delay, so it is the best estimate
+         const std::chrono::steady_clock::duration event_offset =
+            handled_time.time_since_epoch() -
+            event_time;
+
+         if (!offset || event_offset < *offset)
+         {
+            offset = event_offset;
+         }
+
          return
-            std::chrono::steady_clock::now() >=
-            end_time;
+            std::min(
+               handled_time,
+               std::chrono::steady_clock::time_point {
+                  *offset + event_time });
       }
    };
 
+   // a session moves through the stages in order.  only the practice
+   // deadline, answers and the report task move it along; nothing polls.
    enum class Stage : uint8_t
    {
       TITLE,
-      MATH_PRACTICE
+      // until the practice deadline
+      MATH_PRACTICE,
+      // past the deadline, until the minimum amount was answered
+      OVERTIME,
+      // while the report is written
+      SESSION_END,
+      RESULTS
    };
 
+   static constexpr std::chrono::milliseconds RESULTS_ANIMATION_DURATION { 400 };
+
+   enum class ReportState : uint8_t
+   {
+      WRITING,
+      WRITTEN,
+      FAILED
+   };
+
+   static constexpr const char * ENABLED_MATH_FACT_BIT_PROPERTY { "enabled_math_fact_bit" };
+
    enum EnabledMathFactBits : uint32_t
    {
       ADD = 0x01,
@@ -116,59 +257,118 @@ private:
    void SetupAnswerImages( ) noexcept;
    void SetupStopwatchImages( ) noexcept;
    void SetupTitleStage( ) noexcept;
+   void UpdateTitleButtons( ) noexcept;
+   void StartReportArchiving( ) noexcept;
+   // runs a task on the widget's own pool, counted until it finishes
+   void StartTask(
+      std::function< void ( ) > task ) noexcept;
+   void PublishLiveMetrics( ) noexcept;
+
+   // readies everything the first problem needs while the title is shown
+   void StartWarmUp( ) noexcept;
+   void OnAssetsDecoded(
+      const std::vector< std::pair< QString, QImage > > & images ) noexcept;
+   void BuildProblemPools( ) noexcept;
+   void DiscardUnchosenProblems( ) noexcept;
 
    std::unique_ptr< Problem > GenerateProblem( ) noexcept;
-   void GenerateAdditionProblem( ) noexcept;
-   void GenerateSubtractionProblem( ) noexcept;
-   void GenerateMultiplicationProblem( ) noexcept;
-   void GenerateDivisionProblem( ) noexcept;
-   void GenerateTimeProblem( ) noexcept;
+   std::unique_ptr< Problem > MakeProblem(
+      const uint16_t fact_id ) noexcept;
+
+   void OnSettingsChanged(
+      const std::shared_ptr< const MathFactsSettings > & settings ) noexcept;
 
    void OnProblemAnswered(
       const AnswerResult result ) noexcept;
-   void WriteReport( ) const noexcept;
+   bool IsSessionComplete( ) const noexcept;
+   void EndSession( ) noexcept;
 
-   std::string GetCurrentUserName( ) const noexcept;
    std::string GenerateReportName( ) const noexcept;
-   std::unique_ptr< QSettings > GetSettings( ) const noexcept;
+   static std::filesystem::path GetProfilePath( ) noexcept;
    uint32_t GetEnabledMathFacts( ) const noexcept;
-   std::filesystem::path GetReportsDirectory( ) const noexcept;
    std::chrono::milliseconds GetMathPracticeDuration( ) const noexcept;
    std::chrono::milliseconds CalculateStandardDeviationResponseTime( ) const noexcept;
    uint32_t GetMinimumAmountToPractice( ) const noexcept;
+   std::chrono::days GetArchiveReportsAfter( ) const noexcept;
+   uint32_t GetExportFormats( ) const noexcept;
 
+   // every stage is drawn with the one painter of the paint event
    void PaintProblem(
-      QPaintEvent * paint_event ) noexcept;
+      QPaintEvent * paint_event,
+      QPainter & painter ) noexcept;
    void PaintBackground(
-      QPaintEvent * paint_event ) noexcept;
+      QPainter & painter ) noexcept;
+   void RenderBackground( ) noexcept;
    void PaintProblemText(
-      QPaintEvent * paint_event ) noexcept;
+      QPaintEvent * paint_event,
+      QPainter & painter ) noexcept;
    void PaintAnswerImage(
-      QPaintEvent * paint_event ) noexcept;
+      QPainter & painter ) noexcept;
    void PaintStopwatch(
-      QPaintEvent * paint_event ) noexcept;
+      QPainter & painter ) noexcept;
    void PaintTitleStage(
-      QPaintEvent * paint_event ) noexcept;
+      QPainter & painter ) noexcept;
+   void PaintSessionEndStage(
+      QPainter & painter ) noexcept;
+   void PaintResultsStage(
+      QPainter & painter ) noexcept;
 
    Stage current_stage_;
+   ReportState report_state_;
+
+   SettingsWatcher settings_watcher_;
+   // replaced while the title is shown; a session keeps the settings it
+   // started with, so that its report describes how it was practiced
+   std::shared_ptr< const MathFactsSettings > settings_;
 
    TitleButtonID chosen_problems_;
    std::unique_ptr< QWidget > title_stage_buttons_;
 
    const Colors * current_colors_;
    std::array< Colors, 6 > colors_;
+   // the background and border of every stage, drawn again only when
+   // the size or the colors change, so a paint just copies it
+   QPixmap background_;
+   const Colors * background_colors_;
 
    Randomizers randomizers_;
    std::unique_ptr< Problem > current_problem_;
    std::vector< std::unique_ptr< Problem > > answered_problems_;
+   std::vector< AnswerRecord > answer_records_;
+   SessionStatistics session_statistics_;
+   SessionPerformance session_performance_;
+   // kept up to date while practicing, so the results appear at once
+   FactHeatmap fact_heatmap_;
+   // every answer the user ever gave, across sessions
+   FactProfile fact_profile_;
+   QTimer results_animation_timer_;
+   std::chrono::steady_clock::time_point results_start_time_;
+   AnswerJournal answer_journal_;
+   // published after every paint, and once a second while seen
+   LiveMetrics live_metrics_;
+   LiveMetricsData live_metrics_data_;
+   QTimer live_metrics_timer_;
+   // answers for the teacher, if a classroom aggregator is running
+   ClassroomFeed classroom_feed_;
    
    const QPixmap * answer_image_;
    QPixmap wrong_answer_image_;
    QPixmap correct_answer_image_;
 
    Stopwatch practice_stopwatch_;
+   PowerPolicy power_policy_;
+   InputClock input_clock_;
    uint32_t minimum_amount_to_practice_;
 
+   // runs the warm up, report and archiving tasks of this widget only,
+   // so that destroying it waits for nothing else
+   QThreadPool task_pool_;
+   // the archiver gives up once this is set
+   std::atomic< bool > archive_stop_requested_;
+   // queued or running on the task pool; published with the live metrics
+   // without taking the pool's lock on every paint
+   std::atomic< uint32_t > active_tasks_;
+
 };
 
 #endif // _MATH_FACTS_WIDGET_HPP_
@@ -0,0 +1,127 @@
+#include "power-policy.hpp"
+
+#include <QtCore/QEvent>
+#include <QtCore/QMetaObject>
+#include <QtCore/Qt>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QWindow>
+#include <QtWidgets/QWidget>
+
+#include <utility>
+
+PowerPolicy::PowerPolicy(
+   QWidget & widget ) noexcept :
+widget_ { widget },
+is_watching_window_ { },
+is_update_pending_ { },
+// nothing is seen before the widget is shown
+mode_ { Mode::HIDDEN }
+{
+   widget_.installEventFilter(
+      this);
+
+   QObject::connect(
+      qGuiApp,
+      &QGuiApplication::applicationStateChanged,
+      this,
+      [ this ] ( )
+      {
+         Update();
+      });
+}
+
+PowerPolicy::Mode PowerPolicy::GetMode( ) const noexcept
+{
+   return
+      mode_;
+}
+
+void PowerPolicy::SetChangedCallback(
+   ChangedCallback callback ) noexcept
+{
+   changed_callback_ =
+      std::move(callback);
+}
+
+bool PowerPolicy::eventFilter(
+   QObject * watched,
+   QEvent * event )
+{
+   switch (event->type())
+   {
+   case QEvent::Type::Show:
+      // the native window, which reports being covered, only exists
+      // once the widget was shown
+      if (!is_watching_window_ && widget_.windowHandle())
+      {
+         widget_.windowHandle()->installEventFilter(
+            this);
+
+         is_watching_window_ = true;
+      }
+
+      [[fallthrough]];
+
+   case QEvent::Type::Hide: [[fallthrough]];
+   case QEvent::Type::Expose: [[fallthrough]];
+   case QEvent::Type::WindowStateChange: [[fallthrough]];
+   case QEvent::Type::ActivationChange:
+      // looked at once the event was handled, and only once for the
+      // events of one change
+      if (!is_update_pending_)
+      {
+         is_update_pending_ = true;
+
+         QMetaObject::invokeMethod(
+            this,
+            [ this ] ( )
+            {
+               is_update_pending_ = false;
+
+               Update();
+            },
+            Qt::ConnectionType::QueuedConnection);
+      }
+
+      break;
+
+   default:
+      break;
+   }
+
+   return
+      QObject::eventFilter(
+         watched,
+         event);
+}
+
+void PowerPolicy::Update( ) noexcept
+{
+   const Qt::ApplicationState application_state =
+      QGuiApplication::applicationState();
+   const QWindow * const window =
+      widget_.windowHandle();
+
+   const bool is_seen =
+      widget_.isVisible() &&
+      !widget_.isMinimized() &&
+      (!window || window->isExposed()) &&
+      application_state != Qt::ApplicationState::ApplicationHidden &&
+      application_state != Qt::ApplicationState::ApplicationSuspended;
+
+   const Mode mode =
+      !is_seen ? Mode::HIDDEN :
+      widget_.isActiveWindow() ? Mode::ACTIVE :
+      Mode::UNFOCUSED;
+
+   if (mode == mode_)
+      return;
+
+   mode_ = mode;
+
+   if (changed_callback_)
+   {
+      changed_callback_(
+         mode_);
+   }
+}
@@ -0,0 +1,67 @@
+#ifndef _POWER_POLICY_HPP_
+#define _POWER_POLICY_HPP_
+
+#include <QtCore/QObject>
+
+#include <cstdint>
+#include <functional>
+
+class QEvent;
+class QWidget;
+
+// how much of a window can be seen.  a window that is hidden, minimized
+// or fully covered shows nothing, and neither does an application that
+// is hidden or suspended, as it is behind a locked screen on platforms
+// that report it.  the owner is told of every change, so its timers only
+// run while they have something to show.
+class PowerPolicy :
+   public QObject
+{
+public:
+   enum class Mode : uint8_t
+   {
+      // seen and focused
+      ACTIVE,
+      // seen, while another window has the focus
+      UNFOCUSED,
+      // nothing can be seen
+      HIDDEN
+   };
+
+   using ChangedCallback =
+      std::function< void (
+         const Mode mode ) >;
+
+   explicit PowerPolicy(
+      QWidget & widget ) noexcept;
+
+   PowerPolicy(
+      const PowerPolicy & ) = delete;
+   PowerPolicy & operator = (
+      const PowerPolicy & ) = delete;
+
+   Mode GetMode( ) const noexcept;
+
+   // called on the gui thread after the mode changed
+   void SetChangedCallback(
+      ChangedCallback callback ) noexcept;
+
+protected:
+   virtual bool eventFilter(
+      QObject * watched,
+      QEvent * event ) override;
+
+private:
+   void Update( ) noexcept;
+
+   QWidget & widget_;
+   bool is_watching_window_;
+   // an update is already queued
+   bool is_update_pending_;
+
+   Mode mode_;
+   ChangedCallback changed_callback_;
+
+};
+
+#endif // _POWER_POLICY_HPP_
@@ -0,0 +1,1120 @@
+#include "practice-history.hpp"
+#include "answer-journal.hpp"
+#include "answer-record.hpp"
+#include "mapped-file.hpp"
+#include "streaming-writer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+namespace
+{
+
+// the index is only read back on the machine that wrote it, so values
+// are stored in host byte order
+constexpr char INDEX_MAGIC[4] { 'M', 'F', 'H', 'X' };
+constexpr uint16_t INDEX_VERSION { 1 };
+
+template < typename T >
+void Put(
+   std::vector< uint8_t > & data,
+   const T value )
+{
+   static_assert(std::is_arithmetic_v< T >);
+
+   const auto bytes =
+      reinterpret_cast< const uint8_t * >(&value);
+
+   data.insert(
+      data.end(),
+      bytes,
+      bytes + sizeof(value));
+}
+
+void PutString(
+   std::vector< uint8_t > & data,
+   const std::string_view text )
+{
+   Put(
+      data,
+      static_cast< uint16_t >(text.size()));
+
+   data.insert(
+      data.end(),
+      text.begin(),
+      text.begin() + static_cast< uint16_t >(text.size()));
+}
+
+template < typename T >
+bool Get(
+   const uint8_t * & position,
+   const uint8_t * const end,
+   T & value ) noexcept
+{
+   static_assert(std::is_arithmetic_v< T >);
+
+   if (static_cast< size_t >(end - position) < sizeof(value))
+      return false;
+
+   std::memcpy(
+      &value,
+      position,
+      sizeof(value));
+
+   position += sizeof(value);
+
+   return true;
+}
+
+bool GetString(
+   const uint8_t * & position,
+   const uint8_t * const end,
+   std::string & text )
+{
+   uint16_t size { };
+
+   if (!Get(position, end, size) ||
+       static_cast< size_t >(end - position) < size)
+   {
+      return false;
+   }
+
+   text.assign(
+      reinterpret_cast< const char * >(position),
+      size);
+
+   position += size;
+
+   return true;
+}
+
+template < typename T >
+bool ParseField(
+   const std::string_view text,
+   T & value ) noexcept
+{
+   const auto [end, error] =
+      std::from_chars(
+         text.data(),
+         text.data() + text.size(),
+         value);
+
+   return
+      error == std::errc { } &&
+      end == text.data() + text.size();
+}
+
+} // namespace
+
+PracticeHistory::PracticeHistory( ) noexcept :
+by_fact_ ( FACT_ID_COUNT )
+{
+}
+
+bool PracticeHistory::Update(
+   const std::filesystem::path & reports_directory ) noexcept
+{
+   bool changed { };
+
+   try
+   {
+      // report name to the best file written for it
+      std::map< std::string, std::pair< std::filesystem::path, SourceKind > > files;
+
+      std::error_code error;
+
+      for (std::filesystem::directory_iterator entry {
+              reports_directory,
+              error };
+           !error && entry != std::filesystem::directory_iterator { };
+           entry.increment(error))
+      {
+         const auto & path =
+            entry->path();
+         const auto extension =
+            path.extension();
+
+         SourceKind kind { };
+
+         if (extension == AnswerJournal::EXTENSION)
+            kind = SourceKind::JOURNAL;
+         else if (extension == ".txt")
+            kind = SourceKind::TEXT_REPORT;
+         else if (extension == SESSION_FORMAT_EXTENSION)
+            kind = SourceKind::SESSION_FILE;
+         else
+            continue;
+
+         auto & file =
+            files[path.stem().string()];
+
+         if (file.first.empty() || file.second < kind)
+         {
+            file = { path, kind };
+         }
+      }
+
+      for (const auto & [report_name, file] : files)
+      {
+         std::string_view username;
+         std::string_view date_time;
+         int32_t day { };
+
+         if (!ParseReportName(report_name, username, date_time) ||
+             !ParseReportDay(date_time, day))
+         {
+            continue;
+         }
+
+         auto source =
+            sources_.find(report_name);
+
+         if (source != sources_.end() &&
+             source->second.kind > file.second)
+         {
+            continue;
+         }
+
+         if (source != sources_.end() &&
+             source->second.kind < file.second)
+         {
+            // the text report was indexed before its session file appeared
+            Remove(
+               source->second.rows);
+
+            sources_.erase(
+               source);
+
+            source = sources_.end();
+            changed = true;
+         }
+
+         if (source == sources_.end())
+         {
+            source =
+               sources_.emplace(
+                  report_name,
+                  Source {
+                     file.second,
+                     StudentId(username),
+                     0,
+                     0,
+                     RoaringBitmap { } }).first;
+         }
+         else if (source->second.kind != SourceKind::JOURNAL)
+         {
+            continue;
+         }
+
+         changed |=
+            IndexFile(
+               file.first,
+               username,
+               day,
+               source->second);
+      }
+
+      // a journal disappears once its session file has been written;
+      // reports that were archived or removed stay in the history
+      std::erase_if(
+         sources_,
+         [ & ] (
+            auto & source )
+         {
+            if (source.second.kind != SourceKind::JOURNAL ||
+                files.contains(source.first))
+            {
+               return false;
+            }
+
+            Remove(
+               source.second.rows);
+
+            changed = true;
+
+            return true;
+         });
+
+      if (changed)
+      {
+         Compact();
+      }
+   }
+   catch (...)
+   {
+   }
+
+   return
+      changed;
+}
+
+RoaringBitmap PracticeHistory::AddReport(
+   const std::string_view username,
+   const int32_t day,
+   const std::vector< ParsedAnswer > & answers )
+{
+   const uint32_t student =
+      StudentId(
+         username);
+
+   RoaringBitmap rows;
+
+   for (const auto & answer : answers)
+   {
+      rows.Add(
+         AddAnswer(
+            student,
+            day,
+            answer.fact_id,
+            answer.response_time_ms,
+            answer.number_of_responses));
+   }
+
+   return
+      rows;
+}
+
+RoaringBitmap PracticeHistory::AddSession(
+   const std::string_view username,
+   const int32_t day,
+   const SessionColumns & session )
+{
+   const uint32_t student =
+      StudentId(
+         username);
+
+   RoaringBitmap rows;
+
+   for (size_t i { }; i < session.fact_ids.size(); ++i)
+   {
+      rows.Add(
+         AddAnswer(
+            student,
+            day,
+            session.fact_ids[i],
+            session.response_times_ms[i],
+            session.attempt_counts[i]));
+   }
+
+   return
+      rows;
+}
+
+RoaringBitmap PracticeHistory::Select(
+   const HistoryQuery & query ) const
+{
+   static const RoaringBitmap EMPTY;
+
+   std::vector< const RoaringBitmap * > predicates;
+
+   if (query.fact_id)
+   {
+      predicates.push_back(
+         *query.fact_id < by_fact_.size() ?
+            &by_fact_[*query.fact_id] :
+            &EMPTY);
+   }
+
+   if (query.operation)
+   {
+      const auto operation =
+         static_cast< size_t >(*query.operation);
+
+      predicates.push_back(
+         operation < by_operation_.size() ?
+            &by_operation_[operation] :
+            &EMPTY);
+   }
+
+   if (query.student)
+   {
+      const auto student =
+         student_ids_.find(
+            *query.student);
+
+      predicates.push_back(
+         student != student_ids_.end() ?
+            &by_student_[student->second] :
+            &EMPTY);
+   }
+
+   if (query.outcome == AnswerOutcome::RETRIED)
+   {
+      predicates.push_back(
+         &retried_);
+   }
+
+   RoaringBitmap days;
+
+   if (query.first_day || query.last_day)
+   {
+      const int32_t first_day =
+         query.first_day.value_or(
+            std::numeric_limits< int32_t >::min());
+      const int32_t last_day =
+         query.last_day.value_or(
+            std::numeric_limits< int32_t >::max());
+
+      if (first_day <= last_day)
+      {
+         const auto last =
+            by_day_.upper_bound(
+               last_day);
+
+         for (auto day { by_day_.lower_bound(first_day) }; day != last; ++day)
+         {
+            days |= day->second;
+         }
+      }
+
+      predicates.push_back(
+         &days);
+   }
+
+   // intersecting the smallest bitmaps first keeps every step small
+   std::sort(
+      predicates.begin(),
+      predicates.end(),
+      [ ] (
+         const RoaringBitmap * const left,
+         const RoaringBitmap * const right )
+      {
+         return
+            left->Cardinality() < right->Cardinality();
+      });
+
+   RoaringBitmap result {
+      predicates.empty() ?
+         live_ :
+         *predicates.front()
+   };
+
+   for (size_t i { 1 }; i < predicates.size(); ++i)
+   {
+      result &= *predicates[i];
+   }
+
+   if (!predicates.empty())
+   {
+      result &= live_;
+   }
+
+   if (query.outcome == AnswerOutcome::FIRST_TRY)
+   {
+      result -= retried_;
+   }
+
+   if (query.min_response_time_ms || query.max_response_time_ms)
+   {
+      const uint32_t min_ms =
+         query.min_response_time_ms.value_or(0);
+      const uint32_t max_ms =
+         query.max_response_time_ms.value_or(
+            std::numeric_limits< uint32_t >::max());
+
+      RoaringBitmap inside;
+      RoaringBitmap edge;
+
+      for (size_t band { }; band < RESPONSE_TIME_BANDS; ++band)
+      {
+         const uint32_t band_min =
+            band == 0 ? 0 : uint32_t { 1 } << (band - 1);
+         const uint32_t band_max =
+            band == 0 ? 0 : band_min + (band_min - 1);
+
+         if (band_max < min_ms || band_min > max_ms)
+            continue;
+
+         if (band_min >= min_ms && band_max <= max_ms)
+            inside |= by_response_time_[band];
+         else
+            edge |= by_response_time_[band];
+      }
+
+      edge &= result;
+      result &= inside;
+
+      // only the rows of the bands the range cuts through are looked at
+      edge.ForEach(
+         [ & ] (
+            const uint32_t row )
+         {
+            const uint32_t response_time_ms =
+               response_times_ms_[row];
+
+            if (response_time_ms >= min_ms && response_time_ms <= max_ms)
+            {
+               result.Add(
+                  row);
+            }
+         });
+   }
+
+   return
+      result;
+}
+
+std::vector< std::pair< std::string, uint64_t > > PracticeHistory::CountByStudent(
+   const RoaringBitmap & answers ) const
+{
+   std::vector< std::pair< std::string, uint64_t > > counts;
+
+   for (const auto & [username, student] : student_ids_)
+   {
+      const uint64_t count =
+         RoaringBitmap::AndCardinality(
+            answers,
+            by_student_[student]);
+
+      if (count)
+      {
+         counts.emplace_back(
+            username,
+            count);
+      }
+   }
+
+   return
+      counts;
+}
+
+std::vector< std::pair< uint16_t, uint64_t > > PracticeHistory::CountByFact(
+   const RoaringBitmap & answers ) const
+{
+   std::vector< std::pair< uint16_t, uint64_t > > counts;
+
+   for (uint16_t fact_id { }; fact_id < by_fact_.size(); ++fact_id)
+   {
+      const uint64_t count =
+         RoaringBitmap::AndCardinality(
+            answers,
+            by_fact_[fact_id]);
+
+      if (count)
+      {
+         counts.emplace_back(
+            fact_id,
+            count);
+      }
+   }
+
+   return
+      counts;
+}
+
+std::vector< std::pair< int32_t, uint64_t > > PracticeHistory::CountByDay(
+   const RoaringBitmap & answers ) const
+{
+   std::vector< std::pair< int32_t, uint64_t > > counts;
+
+   for (const auto & [day, rows] : by_day_)
+   {
+      const uint64_t count =
+         RoaringBitmap::AndCardinality(
+            answers,
+            rows);
+
+      if (count)
+      {
+         counts.emplace_back(
+            day,
+            count);
+      }
+   }
+
+   return
+      counts;
+}
+
+uint64_t PracticeHistory::Answers( ) const noexcept
+{
+   return
+      live_.Cardinality();
+}
+
+size_t PracticeHistory::SizeInBytes( ) const noexcept
+{
+   size_t size {
+      sizeof(*this) +
+      response_times_ms_.capacity() * sizeof(uint32_t) +
+      live_.SizeInBytes() +
+      retried_.SizeInBytes()
+   };
+
+   for (const auto & rows : by_fact_) size += rows.SizeInBytes();
+   for (const auto & rows : by_operation_) size += rows.SizeInBytes();
+   for (const auto & rows : by_student_) size += rows.SizeInBytes();
+   for (const auto & rows : by_response_time_) size += rows.SizeInBytes();
+   for (const auto & day : by_day_) size += day.second.SizeInBytes();
+   for (const auto & source : sources_) size += source.second.rows.SizeInBytes();
+
+   return
+      size;
+}
+
+bool PracticeHistory::Save(
+   const std::filesystem::path & path ) const noexcept
+{
+   try
+   {
+      std::vector< uint8_t > data;
+
+      for (const char c : INDEX_MAGIC)
+      {
+         Put(data, c);
+      }
+
+      Put(data, INDEX_VERSION);
+
+      Put(data, static_cast< uint32_t >(response_times_ms_.size()));
+
+      for (const uint32_t response_time_ms : response_times_ms_)
+      {
+         Put(data, response_time_ms);
+      }
+
+      live_.Serialize(data);
+      retried_.Serialize(data);
+
+      for (const auto & rows : by_fact_) rows.Serialize(data);
+      for (const auto & rows : by_operation_) rows.Serialize(data);
+      for (const auto & rows : by_response_time_) rows.Serialize(data);
+
+      Put(data, static_cast< uint32_t >(students_.size()));
+
+      for (size_t student { }; student < students_.size(); ++student)
+      {
+         PutString(data, students_[student]);
+         by_student_[student].Serialize(data);
+      }
+
+      Put(data, static_cast< uint32_t >(by_day_.size()));
+
+      for (const auto & [day, rows] : by_day_)
+      {
+         Put(data, day);
+         rows.Serialize(data);
+      }
+
+      Put(data, static_cast< uint32_t >(sources_.size()));
+
+      for (const auto & [report_name, source] : sources_)
+      {
+         PutString(data, report_name);
+         Put(data, static_cast< uint8_t >(source.kind));
+         Put(data, source.student);
+         Put(data, source.session_start_unix_ms);
+         Put(data, source.journal_offset);
+         source.rows.Serialize(data);
+      }
+
+      Put(data, static_cast< uint32_t >(finished_sessions_.size()));
+
+      for (const auto & [student, session_start_unix_ms] : finished_sessions_)
+      {
+         Put(data, student);
+         Put(data, session_start_unix_ms);
+      }
+
+      Put(
+         data,
+         Crc32(
+            data.data(),
+            data.size()));
+
+      std::error_code error;
+
+      std::filesystem::create_directories(
+         path.parent_path(),
+         error);
+
+      StreamingWriter index_file {
+         path
+      };
+
+      index_file.Append(
+         std::string_view {
+            reinterpret_cast< const char * >(data.data()),
+            data.size() });
+
+      return
+         index_file.Finish();
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+bool PracticeHistory::Load(
+   const std::filesystem::path & path ) noexcept
+{
+   try
+   {
+      const MappedFile index_file {
+         path
+      };
+
+      const auto begin =
+         reinterpret_cast< const uint8_t * >(index_file.Data());
+      const size_t size =
+         index_file.Size();
+
+      if (!index_file.IsOpen() ||
+          size < sizeof(INDEX_MAGIC) + sizeof(uint32_t) ||
+          std::memcmp(begin, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0)
+      {
+         return false;
+      }
+
+      const uint8_t * const end =
+         begin + size - sizeof(uint32_t);
+
+      uint32_t crc { };
+      const uint8_t * crc_position { end };
+
+      if (!Get(crc_position, begin + size, crc) ||
+          crc != Crc32(begin, end - begin))
+      {
+         return false;
+      }
+
+      const uint8_t * position =
+         begin + sizeof(INDEX_MAGIC);
+
+      uint16_t version { };
+
+      if (!Get(position, end, version) || version != INDEX_VERSION)
+         return false;
+
+      PracticeHistory history;
+
+      uint32_t rows { };
+
+      if (!Get(position, end, rows) ||
+          static_cast< size_t >(end - position) / sizeof(uint32_t) < rows)
+      {
+         return false;
+      }
+
+      history.response_times_ms_.resize(
+         rows);
+
+      for (auto & response_time_ms : history.response_times_ms_)
+      {
+         Get(position, end, response_time_ms);
+      }
+
+      bool read =
+         history.live_.Deserialize(position, end) &&
+         history.retried_.Deserialize(position, end);
+
+      for (auto & rows : history.by_fact_) read = read && rows.Deserialize(position, end);
+      for (auto & rows : history.by_operation_) read = read && rows.Deserialize(position, end);
+      for (auto & rows : history.by_response_time_) read = read && rows.Deserialize(position, end);
+
+      uint32_t students { };
+
+      read = read && Get(position, end, students);
+
+      for (uint32_t student { }; read && student < students; ++student)
+      {
+         std::string username;
+         RoaringBitmap student_rows;
+
+         read =
+            GetString(position, end, username) &&
+            student_rows.Deserialize(position, end);
+
+         if (read)
+         {
+            history.student_ids_.emplace(
+               username,
+               student);
+            history.students_.push_back(
+               std::move(username));
+            history.by_student_.push_back(
+               std::move(student_rows));
+         }
+      }
+
+      uint32_t days { };
+
+      read = read && Get(position, end, days);
+
+      for (uint32_t i { }; read && i < days; ++i)
+      {
+         int32_t day { };
+
+         read =
+            Get(position, end, day) &&
+            history.by_day_[day].Deserialize(position, end);
+      }
+
+      uint32_t sources { };
+
+      read = read && Get(position, end, sources);
+
+      for (uint32_t i { }; read && i < sources; ++i)
+      {
+         std::string report_name;
+         uint8_t kind { };
+         Source source { };
+
+         read =
+            GetString(position, end, report_name) &&
+            Get(position, end, kind) &&
+            kind <= static_cast< uint8_t >(SourceKind::SESSION_FILE) &&
+            Get(position, end, source.student) &&
+            source.student < students &&
+            Get(position, end, source.session_start_unix_ms) &&
+            Get(position, end, source.journal_offset) &&
+            source.rows.Deserialize(position, end);
+
+         source.kind =
+            static_cast< SourceKind >(kind);
+
+         if (read)
+         {
+            history.sources_.emplace(
+               std::move(report_name),
+               std::move(source));
+         }
+      }
+
+      uint32_t finished_sessions { };
+
+      read = read && Get(position, end, finished_sessions);
+
+      for (uint32_t i { }; read && i < finished_sessions; ++i)
+      {
+         uint32_t student { };
+         uint64_t session_start_unix_ms { };
+
+         read =
+            Get(position, end, student) &&
+            Get(position, end, session_start_unix_ms);
+
+         history.finished_sessions_.emplace(
+            student,
+            session_start_unix_ms);
+      }
+
+      if (!read || position != end)
+         return false;
+
+      *this = std::move(history);
+
+      return true;
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+bool PracticeHistory::ParseReportDay(
+   const std::string_view date_time,
+   int32_t & day ) noexcept
+{
+   // "YYYY-MM-DD-HH.MM.SS"
+   int32_t year { };
+   uint32_t month { };
+   uint32_t day_of_month { };
+
+   if (date_time.size() < 10 ||
+       !ParseField(date_time.substr(0, 4), year) ||
+       !ParseField(date_time.substr(5, 2), month) ||
+       !ParseField(date_time.substr(8, 2), day_of_month))
+   {
+      return false;
+   }
+
+   const std::chrono::year_month_day date {
+      std::chrono::year { year },
+      std::chrono::month { month },
+      std::chrono::day { day_of_month }
+   };
+
+   if (!date.ok())
+      return false;
+
+   day =
+      static_cast< int32_t >(
+         std::chrono::sys_days { date }.time_since_epoch().count());
+
+   return true;
+}
+
+uint32_t PracticeHistory::StudentId(
+   const std::string_view username )
+{
+   const auto student =
+      student_ids_.find(
+         username);
+
+   if (student != student_ids_.end())
+      return student->second;
+
+   const auto student_id =
+      static_cast< uint32_t >(students_.size());
+
+   students_.emplace_back(
+      username);
+   student_ids_.emplace(
+      username,
+      student_id);
+   by_student_.emplace_back();
+
+   return
+      student_id;
+}
+
+uint32_t PracticeHistory::AddAnswer(
+   const uint32_t student,
+   const int32_t day,
+   const uint16_t fact_id,
+   const uint32_t response_time_ms,
+   const uint32_t number_of_responses )
+{
+   const auto row =
+      static_cast< uint32_t >(response_times_ms_.size());
+
+   response_times_ms_.push_back(
+      response_time_ms);
+
+   // rows only ever grow, so every bitmap is appended to at its end
+   live_.Add(row);
+
+   if (fact_id < by_fact_.size())
+   {
+      by_fact_[fact_id].Add(row);
+      by_operation_[static_cast< size_t >(FactIdOperation(fact_id))].Add(row);
+   }
+
+   by_student_[student].Add(row);
+   by_day_[day].Add(row);
+   by_response_time_[ResponseTimeBand(response_time_ms)].Add(row);
+
+   if (number_of_responses > 1)
+   {
+      retried_.Add(row);
+   }
+
+   return
+      row;
+}
+
+void PracticeHistory::Remove(
+   const RoaringBitmap & rows )
+{
+   // the rows stay in the other bitmaps until the next Compact; every
+   // query ends with live_
+   live_ -= rows;
+}
+
+void PracticeHistory::Compact( )
+{
+   const uint64_t live_rows =
+      live_.Cardinality();
+
+   if (live_rows == response_times_ms_.size())
+   {
+      return;
+   }
+
+   // live rows keep their order, so every bitmap stays sorted and is
+   // appended to at its end
+   constexpr uint32_t REMOVED_ROW { std::numeric_limits< uint32_t >::max() };
+
+   std::vector< uint32_t > new_rows(
+      response_times_ms_.size(),
+      REMOVED_ROW);
+   std::vector< uint32_t > response_times_ms;
+
+   response_times_ms.reserve(
+      static_cast< size_t >(live_rows));
+
+   live_.ForEach(
+      [ & ] (
+         const uint32_t row )
+      {
+         new_rows[row] =
+            static_cast< uint32_t >(response_times_ms.size());
+
+         response_times_ms.push_back(
+            response_times_ms_[row]);
+      });
+
+   const auto renumber =
+      [ & ] (
+         RoaringBitmap & rows )
+      {
+         RoaringBitmap renumbered;
+
+         rows.ForEach(
+            [ & ] (
+               const uint32_t row )
+            {
+               if (row < new_rows.size() &&
+                   new_rows[row] != REMOVED_ROW)
+               {
+                  renumbered.Add(
+                     new_rows[row]);
+               }
+            });
+
+         rows = std::move(
+            renumbered);
+      };
+
+   for (auto & rows : by_fact_) renumber(rows);
+   for (auto & rows : by_operation_) renumber(rows);
+   for (auto & rows : by_student_) renumber(rows);
+   for (auto & rows : by_response_time_) renumber(rows);
+   for (auto & day : by_day_) renumber(day.second);
+   for (auto & source : sources_) renumber(source.second.rows);
+   renumber(retried_);
+
+   std::erase_if(
+      by_day_,
+      [ ] (
+         const auto & day )
+      {
+         return
+            day.second.IsEmpty();
+      });
+
+   response_times_ms_ =
+      std::move(response_times_ms);
+
+   live_ = RoaringBitmap { };
+   live_.AddRange(
+      0,
+      static_cast< uint32_t >(response_times_ms_.size()));
+}
+
+bool PracticeHistory::IndexFile(
+   const std::filesystem::path & path,
+   const std::string_view username,
+   const int32_t day,
+   Source & source )
+{
+   const uint64_t answers_before =
+      source.rows.Cardinality();
+
+   switch (source.kind)
+   {
+   case SourceKind::JOURNAL:
+   {
+      std::vector< AnswerRecord > answers;
+
+      if (!AnswerJournal::ReadFrom(
+             path,
+             source.journal_offset,
+             source.session_start_unix_ms,
+             answers) ||
+          finished_sessions_.contains({ source.student, source.session_start_unix_ms }))
+      {
+         // the session file of this journal has already been indexed
+         break;
+      }
+
+      for (const auto & answer : answers)
+      {
+         source.rows.Add(
+            AddAnswer(
+               source.student,
+               day,
+               answer.fact_id,
+               answer.response_time_ms,
+               static_cast< uint32_t >(answer.responses.size())));
+      }
+
+      break;
+   }
+
+   case SourceKind::TEXT_REPORT:
+   {
+      const MappedFile report {
+         path
+      };
+
+      std::vector< ParsedAnswer > answers;
+
+      if (report.IsOpen() &&
+          ParseReport(report.View(), answers))
+      {
+         source.rows =
+            AddReport(
+               username,
+               day,
+               answers);
+      }
+
+      break;
+   }
+
+   case SourceKind::SESSION_FILE:
+   {
+      SessionColumns session;
+
+      if (ReadSessionFile(path, session))
+      {
+         source.session_start_unix_ms =
+            session.header.session_start_unix_ms;
+         source.rows =
+            AddSession(
+               username,
+               day,
+               session);
+
+         finished_sessions_.emplace(
+            source.student,
+            source.session_start_unix_ms);
+
+         RemoveJournalOf(
+            source.student,
+            source.session_start_unix_ms);
+      }
+
+      break;
+   }
+   }
+
+   return
+      source.rows.Cardinality() != answers_before;
+}
+
+void PracticeHistory::RemoveJournalOf(
+   const uint32_t student,
+   const uint64_t session_start_unix_ms )
+{
+   // the journal may still be listed while its session file is written
+   for (auto & [report_name, source] : sources_)
+   {
+      if (source.kind == SourceKind::JOURNAL &&
+          source.student == student &&
+          source.session_start_unix_ms == session_start_unix_ms)
+      {
+         Remove(
+            source.rows);
+
+         source.rows = RoaringBitmap { };
+      }
+   }
+}
+
+size_t PracticeHistory::ResponseTimeBand(
+   const uint32_t response_time_ms ) noexcept
+{
+   return
+      std::bit_width(
+         response_time_ms);
+}
@@ -0,0 +1,169 @@
+#ifndef _PRACTICE_HISTORY_HPP_
+#define _PRACTICE_HISTORY_HPP_
+
+#include "fact-id.hpp"
+#include "fact-operation.hpp"
+#include "report-parser.hpp"
+#include "roaring-bitmap.hpp"
+#include "session-format.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum class AnswerOutcome : uint8_t
+{
+   FIRST_TRY,
+   RETRIED
+};
+
+// every predicate that is set must hold.  days count from 1970-01-01 in
+// the local date the report was named with, and ranges are inclusive.
+struct HistoryQuery
+{
+   std::optional< uint16_t > fact_id;
+   std::optional< FactOperation > operation;
+   std::optional< std::string > student;
+   std::optional< int32_t > first_day;
+   std::optional< int32_t > last_day;
+   std::optional< AnswerOutcome > outcome;
+   std::optional< uint32_t > min_response_time_ms;
+   std::optional< uint32_t > max_response_time_ms;
+};
+
+// every answer indexed is a row; the rows of each fact, operation,
+// student, day, outcome and response time band are kept as roaring
+// bitmaps, so a query is answered by intersecting a few bitmaps instead
+// of reading reports.  only the response time is kept per row, to
+// refine range predicates inside the bands at their edges.
+class PracticeHistory
+{
+public:
+   static constexpr const char * INDEX_FILE_NAME { "practice-history.mfx" };
+
+   // response times are banded by their bit width
+   static constexpr size_t RESPONSE_TIME_BANDS { 33 };
+
+   PracticeHistory( ) noexcept;
+
+   // indexes the sessions of the reports directory that were not indexed
+   // yet.  a session file is preferred over the text report of the same
+   // name, and journals of sessions that have not finished are indexed
+   // until their session file replaces them.  returns true if anything
+   // changed.
+   bool Update(
+      const std::filesystem::path & reports_directory ) noexcept;
+
+   // both return the rows of the added answers
+   RoaringBitmap AddReport(
+      const std::string_view username,
+      const int32_t day,
+      const std::vector< ParsedAnswer > & answers );
+   RoaringBitmap AddSession(
+      const std::string_view username,
+      const int32_t day,
+      const SessionColumns & session );
+
+   RoaringBitmap Select(
+      const HistoryQuery & query ) const;
+
+   // answers of the selection per student, fact or day; entries without
+   // answers are left out
+   std::vector< std::pair< std::string, uint64_t > > CountByStudent(
+      const RoaringBitmap & answers ) const;
+   std::vector< std::pair< uint16_t, uint64_t > > CountByFact(
+      const RoaringBitmap & answers ) const;
+   std::vector< std::pair< int32_t, uint64_t > > CountByDay(
+      const RoaringBitmap & answers ) const;
+
+   uint64_t Answers( ) const noexcept;
+   size_t SizeInBytes( ) const noexcept;
+
+   bool Save(
+      const std::filesystem::path & path ) const noexcept;
+   bool Load(
+      const std::filesystem::path & path ) noexcept;
+
+   // the local date of a report name, in days since 1970-01-01
+   static bool ParseReportDay(
+      const std::string_view date_time,
+      int32_t & day ) noexcept;
+
+private:
+   enum class SourceKind : uint8_t
+   {
+      JOURNAL,
+      TEXT_REPORT,
+      SESSION_FILE
+   };
+
+   struct Source
+   {
+      SourceKind kind;
+      uint32_t student;
+      uint64_t session_start_unix_ms;
+      uint64_t journal_offset;
+      RoaringBitmap rows;
+   };
+
+   uint32_t StudentId(
+      const std::string_view username );
+
+   uint32_t AddAnswer(
+      const uint32_t student,
+      const int32_t day,
+      const uint16_t fact_id,
+      const uint32_t response_time_ms,
+      const uint32_t number_of_responses );
+
+   void Remove(
+      const RoaringBitmap & rows );
+   // renumbers the live rows from 0 and drops the removed ones from every
+   // bitmap, so replaced sources do not stay in the saved index
+   void Compact( );
+
+   // returns true if rows were added
+   bool IndexFile(
+      const std::filesystem::path & path,
+      const std::string_view username,
+      const int32_t day,
+      Source & source );
+   void RemoveJournalOf(
+      const uint32_t student,
+      const uint64_t session_start_unix_ms );
+
+   static size_t ResponseTimeBand(
+      const uint32_t response_time_ms ) noexcept;
+
+   std::vector< uint32_t > response_times_ms_;
+
+   // rows that still count; rows of replaced sources are removed
+   RoaringBitmap live_;
+
+   std::vector< RoaringBitmap > by_fact_;
+   std::array< RoaringBitmap, FACT_OPERATION_COUNT > by_operation_;
+   std::vector< RoaringBitmap > by_student_;
+   std::map< int32_t, RoaringBitmap > by_day_;
+   std::array< RoaringBitmap, RESPONSE_TIME_BANDS > by_response_time_;
+   RoaringBitmap retried_;
+
+   std::vector< std::string > students_;
+   std::map< std::string, uint32_t, std::less< > > student_ids_;
+
+   // report name, without extension, to what was indexed from it
+   std::map< std::string, Source, std::less< > > sources_;
+   // student and session start of every indexed session file
+   std::set< std::pair< uint32_t, uint64_t > > finished_sessions_;
+
+};
+
+#endif // _PRACTICE_HISTORY_HPP_
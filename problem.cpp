@@ -1,13 +1,120 @@
 #include "problem.hpp"
 
+#include <QtGui/QImage>
+#include <QtGui/QPixmapCache>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace
+{
+
+struct SharedCanvas
+{
+   QPixmap pixmap;
+   uint64_t owner_id;
+   uint32_t owner_version;
+};
+
+std::array< SharedCanvas, 2 > & SharedCanvases( ) noexcept
+{
+   static std::array< SharedCanvas, 2 > canvases { };
+
+   return
+      canvases;
+}
+
+} // namespace
+
 Problem::~Problem( ) noexcept
 {
 }
 
+const QFont & Problem::GetFont( ) noexcept
+{
+   // built once, so that painting only shares it
+   static const QFont font {
+   #if _WIN32
+      "Comic Sans MS",
+   #else
+      "Noto Sans Mono",
+   #endif
+      200
+   };
+
+   return
+      font;
+}
+
+QString Problem::GetCharacters( ) noexcept
+{
+   return
+      "0123456789+-x\u00F7: What military time is it?";
+}
+
+QPixmap Problem::GetImage(
+   const QString & resource_id ) noexcept
+{
+   QPixmap image;
+
+   if (!QPixmapCache::find(resource_id, &image))
+   {
+      image =
+         QPixmap::fromImage(
+            QImage { resource_id });
+
+      QPixmapCache::insert(
+         resource_id,
+         image);
+   }
+
+   return
+      image;
+}
+
+void Problem::AddImage(
+   const QString & resource_id,
+   const QImage & image ) noexcept
+{
+   QPixmapCache::insert(
+      resource_id,
+      QPixmap::fromImage(image));
+}
+
+void Problem::ReleaseCanvases( ) noexcept
+{
+   for (auto & canvas : SharedCanvases())
+   {
+      canvas = SharedCanvas { };
+   }
+}
+
+uint64_t Problem::CanvasBytes( ) noexcept
+{
+   uint64_t bytes { };
+
+   for (const auto & canvas : SharedCanvases())
+   {
+      bytes +=
+         static_cast< uint64_t >(canvas.pixmap.width()) *
+         canvas.pixmap.height() *
+         canvas.pixmap.depth() / 8;
+   }
+
+   return
+      bytes;
+}
+
 void Problem::SetTextColor(
    const QColor & color ) noexcept
 {
-   text_color_ = color;
+   if (color != text_color_)
+   {
+      text_color_ = color;
+
+      InvalidateCanvases();
+   }
 }
 
 const QColor & Problem::GetTextColor( ) const noexcept
@@ -32,6 +139,23 @@ bool Problem::SetStartTime(
    return set;
 }
 
+bool Problem::SetPresentedTime(
+   const std::chrono::steady_clock::time_point presented_time ) noexcept
+{
+   bool set { };
+
+   if (start_time_.time_since_epoch().count() != 0 &&
+       presented_time_.time_since_epoch().count() == 0 &&
+       presented_time >= start_time_)
+   {
+      presented_time_ = presented_time;
+
+      set = true;
+   }
+
+   return set;
+}
+
 bool Problem::SetEndTime(
    const std::chrono::steady_clock::time_point end_time ) noexcept
 {
@@ -49,10 +173,126 @@ bool Problem::SetEndTime(
    return set;
 }
 
+void Problem::RecordKeyPress(
+   const std::chrono::steady_clock::time_point event_time,
+   const std::chrono::steady_clock::time_point handled_time ) noexcept
+{
+   if (first_key_press_time_.time_since_epoch().count() == 0)
+   {
+      first_key_press_time_ = event_time;
+   }
+
+   last_key_press_time_ = event_time;
+   last_key_press_delay_ =
+      handled_time >= event_time ?
+         handled_time - event_time :
+         std::chrono::steady_clock::duration { };
+}
+
+bool Problem::IsPresented( ) const noexcept
+{
+   return
+      presented_time_.time_since_epoch().count() != 0;
+}
+
+std::chrono::steady_clock::time_point Problem::GetLastKeyPressTime( ) const noexcept
+{
+   return
+      last_key_press_time_;
+}
+
+std::chrono::steady_clock::time_point Problem::GetEndTime( ) const noexcept
+{
+   return
+      end_time_;
+}
+
 std::chrono::steady_clock::duration Problem::GetResponseTime( ) const noexcept
+{
+   // a problem that was never painted falls back to the generation time
+   const auto shown_time =
+      IsPresented() ?
+         presented_time_ :
+         start_time_;
+
+   return
+      end_time_ >= shown_time ?
+         end_time_ - shown_time :
+         std::chrono::steady_clock::duration { };
+}
+
+std::chrono::steady_clock::duration Problem::GetThinkTime( ) const noexcept
+{
+   return
+      IsPresented() &&
+      first_key_press_time_ >= presented_time_ ?
+         first_key_press_time_ - presented_time_ :
+         std::chrono::steady_clock::duration { };
+}
+
+std::chrono::steady_clock::duration Problem::GetTypingTime( ) const noexcept
+{
+   return
+      first_key_press_time_.time_since_epoch().count() != 0 &&
+      end_time_ >= first_key_press_time_ ?
+         end_time_ - first_key_press_time_ :
+         std::chrono::steady_clock::duration { };
+}
+
+bool Problem::IsCanvasCurrent(
+   const Canvas canvas ) const noexcept
+{
+   const auto & shared_canvas =
+      SharedCanvases()[static_cast< size_t >(canvas)];
+
+   return
+      !shared_canvas.pixmap.isNull() &&
+      shared_canvas.owner_id == canvas_owner_id_ &&
+      shared_canvas.owner_version == canvas_version_;
+}
+
+QPixmap & Problem::ClaimCanvas(
+   const Canvas canvas ) noexcept
+{
+   auto & shared_canvas =
+      SharedCanvases()[static_cast< size_t >(canvas)];
+
+   shared_canvas.owner_id = canvas_owner_id_;
+   shared_canvas.owner_version = canvas_version_;
+
+   return
+      shared_canvas.pixmap;
+}
+
+const QPixmap & Problem::GetCanvas(
+   const Canvas canvas ) const noexcept
 {
    return
-      end_time_ >= start_time_ ?
-         end_time_ - start_time_ :
+      SharedCanvases()[static_cast< size_t >(canvas)].pixmap;
+}
+
+void Problem::InvalidateCanvases( ) noexcept
+{
+   ++canvas_version_;
+}
+
+uint64_t Problem::NextCanvasOwnerId( ) noexcept
+{
+   // 0 is never an owner
+   static std::atomic< uint64_t > next_owner_id { };
+
+   return
+      ++next_owner_id;
+}
+
+std::chrono::steady_clock::duration Problem::GetUiLatency( ) const noexcept
+{
+   const auto present_latency =
+      IsPresented() ?
+         presented_time_ - start_time_ :
          std::chrono::steady_clock::duration { };
+
+   return
+      present_latency +
+      last_key_press_delay_;
 }
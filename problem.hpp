@@ -1,16 +1,24 @@
 #ifndef _PROBLEM_HPP_
 #define _PROBLEM_HPP_
 
+#include "fact-operation.hpp"
+
 #include <QtCore/QObject>
+#include <QtCore/QString>
 #include <QtCore/QtContainerFwd>
 
 #include <QtGui/QColor>
+#include <QtGui/QFont>
+#include <QtGui/QPixmap>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
+class QImage;
 class QKeyEvent;
 class QPaintEvent;
+class QPainter;
 class QWidget;
 
 enum class AnswerResult : uint8_t {
@@ -26,24 +34,66 @@ class Problem :
 public:
    virtual ~Problem( ) noexcept;
 
+   // the font every problem is drawn in
+   static const QFont & GetFont( ) noexcept;
+   // characters any problem may show, for warming up the font
+   static QString GetCharacters( ) noexcept;
+
+   // an image from the resources; decoded on first use and then shared
+   // through the pixmap cache
+   static QPixmap GetImage(
+      const QString & resource_id ) noexcept;
+   // hands an image decoded off the gui thread to the pixmap cache
+   static void AddImage(
+      const QString & resource_id,
+      const QImage & image ) noexcept;
+   // frees the canvases problems are drawn on until the next paint
+   static void ReleaseCanvases( ) noexcept;
+   static uint64_t CanvasBytes( ) noexcept;
+
    void SetTextColor(
       const QColor & color ) noexcept;
    const QColor & GetTextColor( ) const noexcept;
 
    bool SetStartTime(
       const std::chrono::steady_clock::time_point start_time ) noexcept;
+   bool SetPresentedTime(
+      const std::chrono::steady_clock::time_point presented_time ) noexcept;
    bool SetEndTime(
       const std::chrono::steady_clock::time_point end_time ) noexcept;
+   void RecordKeyPress(
+      const std::chrono::steady_clock::time_point event_time,
+      const std::chrono::steady_clock::time_point handled_time ) noexcept;
+
+   bool IsPresented( ) const noexcept;
+   std::chrono::steady_clock::time_point GetLastKeyPressTime( ) const noexcept;
+   std::chrono::steady_clock::time_point GetEndTime( ) const noexcept;
+
+   // time from the first frame showing the problem to the final enter press
    std::chrono::steady_clock::duration GetResponseTime( ) const noexcept;
+   // time from the first frame showing the problem to the first key press
+   std::chrono::steady_clock::duration GetThinkTime( ) const noexcept;
+   // time from the first key press to the final enter press
+   std::chrono::steady_clock::duration GetTypingTime( ) const noexcept;
+   // time spent generating and painting the problem plus the delivery
+   // delay of the final enter press; not included in the response time
+   std::chrono::steady_clock::duration GetUiLatency( ) const noexcept;
 
    virtual QVector< QString > GetResponses( ) const noexcept = 0;
    virtual QString GetQuestionWithAnswer( ) const noexcept = 0;
    virtual size_t GetNumberOfResponses( ) const noexcept = 0;
+   virtual FactOperation GetOperation( ) const noexcept = 0;
+   virtual uint16_t GetFactId( ) const noexcept = 0;
+   // responses as stored in the binary session format
+   virtual std::vector< int32_t > GetResponseValues( ) const noexcept = 0;
 
+   // draws with the painter of the widget, which is already begun and
+   // shared with the rest of the paint, so no painter is begun per frame
    virtual void OnPaintEvent(
       QPaintEvent * paint_event,
+      QPainter & painter,
       QWidget & widget ) noexcept = 0;
-   virtual void OnKeyReleaseEvent(
+   virtual void OnKeyPressEvent(
       QKeyEvent * key_event,
       const QWidget & widget ) noexcept = 0;
 
@@ -51,12 +101,47 @@ signals:
    void Answered(
       const AnswerResult response ) const;
 
+protected:
+   // only one problem is shown at a time, so every problem draws on the
+   // same canvases.  a problem redraws a canvas only if another problem
+   // drew on it since, or if it changed its own looks, which keeps the
+   // paints between key presses down to copying the canvases.
+   enum class Canvas : uint8_t
+   {
+      TEXT,
+      PICTURE
+   };
+
+   // true if the canvas holds what this problem looks like now
+   bool IsCanvasCurrent(
+      const Canvas canvas ) const noexcept;
+   // the canvas, to be drawn as this problem looks now
+   QPixmap & ClaimCanvas(
+      const Canvas canvas ) noexcept;
+   const QPixmap & GetCanvas(
+      const Canvas canvas ) const noexcept;
+
+   // called once what a canvas would show changed
+   void InvalidateCanvases( ) noexcept;
+
 private:
+   static uint64_t NextCanvasOwnerId( ) noexcept;
+
+   // problems come and go, so a canvas remembers its owner by an id that
+   // is never reused rather than by address
+   const uint64_t canvas_owner_id_ { NextCanvasOwnerId() };
+   uint32_t canvas_version_ { };
+
    QColor text_color_;
 
    std::chrono::steady_clock::time_point start_time_;
+   std::chrono::steady_clock::time_point presented_time_;
+   std::chrono::steady_clock::time_point first_key_press_time_;
+   std::chrono::steady_clock::time_point last_key_press_time_;
    std::chrono::steady_clock::time_point end_time_;
 
+   std::chrono::steady_clock::duration last_key_press_delay_ { };
+
 };
 
 #endif // _PROBLEM_HPP_
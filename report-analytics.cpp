@@ -0,0 +1,276 @@
+#include "report-analytics.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+void LatencyAggregate::Add(
+   const ParsedAnswer & answer ) noexcept
+{
+   response_time_.Add(
+      answer.response_time_ms);
+   response_time_histogram_.Record(
+      answer.response_time_ms);
+
+   if (answer.number_of_responses > 1)
+   {
+      ++retried_answers_;
+      retries_ += answer.number_of_responses - 1;
+   }
+}
+
+void LatencyAggregate::Merge(
+   const LatencyAggregate & aggregate ) noexcept
+{
+   response_time_.Merge(
+      aggregate.response_time_);
+   response_time_histogram_.Merge(
+      aggregate.response_time_histogram_);
+
+   retried_answers_ += aggregate.retried_answers_;
+   retries_ += aggregate.retries_;
+}
+
+uint64_t LatencyAggregate::Count( ) const noexcept
+{
+   return
+      response_time_.Count();
+}
+
+double LatencyAggregate::MeanResponseTime( ) const noexcept
+{
+   return
+      response_time_.Mean();
+}
+
+const LatencyHistogram & LatencyAggregate::ResponseTimeHistogram( ) const noexcept
+{
+   return
+      response_time_histogram_;
+}
+
+double LatencyAggregate::RetryRate( ) const noexcept
+{
+   return
+      Count() ?
+         static_cast< double >(retried_answers_) / Count() :
+         0.0;
+}
+
+double LatencyAggregate::RetriesPerAnswer( ) const noexcept
+{
+   return
+      Count() ?
+         static_cast< double >(retries_) / Count() :
+         0.0;
+}
+
+double SessionTrend(
+   std::vector< SessionSummary > sessions ) noexcept
+{
+   if (sessions.size() < 2)
+      return 0.0;
+
+   std::sort(
+      sessions.begin(),
+      sessions.end(),
+      [ ] (
+         const SessionSummary & l,
+         const SessionSummary & r )
+      {
+         return
+            l.date_time < r.date_time;
+      });
+
+   const double mean_x =
+      (sessions.size() - 1) / 2.0;
+
+   double mean_y { };
+
+   for (const auto & session : sessions)
+   {
+      mean_y += session.mean_response_time_ms;
+   }
+
+   mean_y /= sessions.size();
+
+   double covariance { };
+   double variance { };
+
+   for (size_t i { }; i < sessions.size(); ++i)
+   {
+      const double dx = i - mean_x;
+
+      covariance += dx * (sessions[i].mean_response_time_ms - mean_y);
+      variance += dx * dx;
+   }
+
+   return
+      covariance / variance;
+}
+
+ReportAggregate::ReportAggregate( ) noexcept :
+reports_ { },
+skipped_reports_ { },
+answers_ { }
+{
+}
+
+void ReportAggregate::AddReport(
+   const std::string_view username,
+   const std::string_view date_time,
+   const std::vector< ParsedAnswer > & answers )
+{
+   if (facts_.empty())
+   {
+      facts_.resize(
+         FACT_ID_COUNT);
+   }
+
+   auto student =
+      students_.find(username);
+
+   if (student == students_.end())
+   {
+      student =
+         students_.emplace(
+            std::string { username },
+            StudentAggregate { }).first;
+   }
+
+   RunningStatistics session_response_time;
+
+   for (const auto & answer : answers)
+   {
+      operations_[static_cast< size_t >(answer.operation)].Add(
+         answer);
+
+      auto & fact =
+         facts_[answer.fact_id];
+
+      if (!fact)
+      {
+         fact = std::make_unique< LatencyAggregate >();
+      }
+
+      fact->Add(
+         answer);
+
+      student->second.latency.Add(
+         answer);
+
+      session_response_time.Add(
+         answer.response_time_ms);
+   }
+
+   if (!answers.empty())
+   {
+      student->second.sessions.push_back(
+         SessionSummary {
+            std::string { date_time },
+            static_cast< uint32_t >(answers.size()),
+            session_response_time.Mean() });
+   }
+
+   ++reports_;
+   answers_ += answers.size();
+}
+
+void ReportAggregate::AddSkippedReport( ) noexcept
+{
+   ++skipped_reports_;
+}
+
+void ReportAggregate::Merge(
+   ReportAggregate && aggregate )
+{
+   reports_ += aggregate.reports_;
+   skipped_reports_ += aggregate.skipped_reports_;
+   answers_ += aggregate.answers_;
+
+   for (size_t i { }; i < FACT_OPERATION_COUNT; ++i)
+   {
+      operations_[i].Merge(
+         aggregate.operations_[i]);
+   }
+
+   if (facts_.empty())
+   {
+      facts_ = std::move(aggregate.facts_);
+   }
+   else
+   {
+      for (size_t i { }; i < aggregate.facts_.size(); ++i)
+      {
+         auto & fact = facts_[i];
+         auto & other_fact = aggregate.facts_[i];
+
+         if (!other_fact)
+            continue;
+
+         if (!fact)
+            fact = std::move(other_fact);
+         else
+            fact->Merge(*other_fact);
+      }
+   }
+
+   for (auto & [username, other_student] : aggregate.students_)
+   {
+      const auto [student, inserted] =
+         students_.try_emplace(
+            username,
+            std::move(other_student));
+
+      if (!inserted)
+      {
+         student->second.latency.Merge(
+            other_student.latency);
+
+         student->second.sessions.insert(
+            student->second.sessions.end(),
+            std::make_move_iterator(other_student.sessions.begin()),
+            std::make_move_iterator(other_student.sessions.end()));
+      }
+   }
+}
+
+uint64_t ReportAggregate::Reports( ) const noexcept
+{
+   return
+      reports_;
+}
+
+uint64_t ReportAggregate::SkippedReports( ) const noexcept
+{
+   return
+      skipped_reports_;
+}
+
+uint64_t ReportAggregate::Answers( ) const noexcept
+{
+   return
+      answers_;
+}
+
+const LatencyAggregate & ReportAggregate::Operation(
+   const FactOperation operation ) const noexcept
+{
+   return
+      operations_[static_cast< size_t >(operation)];
+}
+
+const LatencyAggregate * ReportAggregate::Fact(
+   const uint16_t fact_id ) const noexcept
+{
+   return
+      fact_id < facts_.size() ?
+         facts_[fact_id].get() :
+         nullptr;
+}
+
+const ReportAggregate::Students & ReportAggregate::GetStudents( ) const noexcept
+{
+   return
+      students_;
+}
@@ -0,0 +1,108 @@
+#ifndef _REPORT_ANALYTICS_HPP_
+#define _REPORT_ANALYTICS_HPP_
+
+#include "fact-id.hpp"
+#include "fact-operation.hpp"
+#include "latency-histogram.hpp"
+#include "report-parser.hpp"
+#include "session-statistics.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// response times and retries of a group of answers
+class LatencyAggregate
+{
+public:
+   void Add(
+      const ParsedAnswer & answer ) noexcept;
+   void Merge(
+      const LatencyAggregate & aggregate ) noexcept;
+
+   uint64_t Count( ) const noexcept;
+   double MeanResponseTime( ) const noexcept;
+   // in milliseconds
+   const LatencyHistogram & ResponseTimeHistogram( ) const noexcept;
+
+   // fraction of answers that took more than one response
+   double RetryRate( ) const noexcept;
+   // average amount of wrong responses per answer
+   double RetriesPerAnswer( ) const noexcept;
+
+private:
+   RunningStatistics response_time_;
+   LatencyHistogram response_time_histogram_;
+
+   uint64_t retried_answers_ { };
+   uint64_t retries_ { };
+
+};
+
+struct SessionSummary
+{
+   // local date and time from the report name
+   std::string date_time;
+   uint32_t answers;
+   double mean_response_time_ms;
+};
+
+struct StudentAggregate
+{
+   LatencyAggregate latency;
+   std::vector< SessionSummary > sessions;
+};
+
+// least squares slope of the mean response time of the sessions in
+// chronological order, in milliseconds per session; negative is faster
+double SessionTrend(
+   std::vector< SessionSummary > sessions ) noexcept;
+
+// aggregates of a set of reports.  an aggregate is filled by one thread
+// only; the aggregates of several threads are combined with Merge.
+class ReportAggregate
+{
+public:
+   using Students = std::map< std::string, StudentAggregate, std::less< > >;
+
+   ReportAggregate( ) noexcept;
+
+   void AddReport(
+      const std::string_view username,
+      const std::string_view date_time,
+      const std::vector< ParsedAnswer > & answers );
+   void AddSkippedReport( ) noexcept;
+
+   void Merge(
+      ReportAggregate && aggregate );
+
+   uint64_t Reports( ) const noexcept;
+   uint64_t SkippedReports( ) const noexcept;
+   uint64_t Answers( ) const noexcept;
+
+   const LatencyAggregate & Operation(
+      const FactOperation operation ) const noexcept;
+   // nullptr for facts that were never answered
+   const LatencyAggregate * Fact(
+      const uint16_t fact_id ) const noexcept;
+   const Students & GetStudents( ) const noexcept;
+
+private:
+   uint64_t reports_;
+   uint64_t skipped_reports_;
+   uint64_t answers_;
+
+   std::array< LatencyAggregate, FACT_OPERATION_COUNT > operations_;
+   // allocated on first use, as most reports only practice a few tables
+   std::vector< std::unique_ptr< LatencyAggregate > > facts_;
+   Students students_;
+
+};
+
+#endif // _REPORT_ANALYTICS_HPP_
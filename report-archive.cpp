@@ -0,0 +1,619 @@
+#include "report-archive.hpp"
+#include "report-parser.hpp"
+#include "session-format.hpp"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QIODevice>
+#include <QtCore/QLockFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/Qt>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace
+{
+
+constexpr char HEADER_MAGIC[4] { 'M', 'F', 'A', 'R' };
+constexpr char FOOTER_MAGIC[4] { 'M', 'F', 'A', 'Z' };
+constexpr uint16_t HEADER_SIZE { 8 };
+constexpr uint16_t FOOTER_SIZE { 24 };
+constexpr qint64 COPY_CHUNK_SIZE { 1 << 20 };
+constexpr const char * LOCK_FILE_NAME { "reports-archive.lock" };
+// far longer than archiving takes; only then is the lock of an instance
+// on another machine, which cannot be asked whether it still runs, broken
+constexpr int LOCK_STALE_TIME_MS { 60 * 60 * 1000 };
+
+struct ArchiveCandidate
+{
+   std::filesystem::path path;
+   int64_t modified_unix_ms;
+};
+
+QString ToQString(
+   const std::filesystem::path & path )
+{
+   return
+      QString::fromStdString(
+         path.string());
+}
+
+uint32_t ByteArrayCrc32(
+   const QByteArray & data ) noexcept
+{
+   return
+      Crc32(
+         reinterpret_cast< const uint8_t * >(data.constData()),
+         static_cast< size_t >(data.size()));
+}
+
+bool CopyFrame(
+   QFile & source,
+   const ArchiveEntry & entry,
+   QSaveFile & destination )
+{
+   if (!source.seek(static_cast< qint64 >(entry.offset)))
+      return false;
+
+   qint64 remaining { entry.compressed_size };
+
+   while (remaining)
+   {
+      const QByteArray chunk =
+         source.read(
+            std::min(remaining, COPY_CHUNK_SIZE));
+
+      if (chunk.isEmpty() ||
+          destination.write(chunk) != chunk.size())
+      {
+         return false;
+      }
+
+      remaining -= chunk.size();
+   }
+
+   return true;
+}
+
+// rewrites the bundle with its current entries followed by the files.
+// files already in the bundle under the same name replace their entry.
+bool WriteBundle(
+   const std::filesystem::path & bundle_path,
+   const std::vector< ArchiveCandidate > & files,
+   const std::atomic< bool > & stop_requested,
+   QString & error_message )
+{
+   std::error_code exists_error;
+
+   const bool bundle_exists =
+      std::filesystem::exists(
+         bundle_path,
+         exists_error);
+
+   std::vector< ArchiveEntry > existing_entries;
+
+   QFile existing_bundle {
+      ToQString(bundle_path)
+   };
+
+   if (bundle_exists &&
+       (!ReadArchiveIndex(bundle_path, existing_entries) ||
+        !existing_bundle.open(QIODevice::OpenModeFlag::ReadOnly)))
+   {
+      error_message =
+         "Cannot read the archive '" +
+         ToQString(bundle_path) +
+         "'.";
+
+      return false;
+   }
+
+   QSaveFile bundle {
+      ToQString(bundle_path)
+   };
+
+   if (!bundle.open(QIODevice::OpenModeFlag::WriteOnly))
+   {
+      error_message =
+         "Cannot write the archive '" +
+         ToQString(bundle_path) +
+         "'.";
+
+      return false;
+   }
+
+   QDataStream stream {
+      &bundle
+   };
+
+   stream.setByteOrder(
+      QDataStream::ByteOrder::LittleEndian);
+
+   stream.writeRawData(
+      HEADER_MAGIC,
+      sizeof(HEADER_MAGIC));
+   stream
+      << quint16 { REPORT_ARCHIVE_VERSION }
+      << quint16 { HEADER_SIZE };
+
+   std::vector< ArchiveEntry > entries;
+   entries.reserve(
+      existing_entries.size() +
+      files.size());
+
+   for (auto entry : existing_entries)
+   {
+      const bool replaced =
+         std::any_of(
+            files.cbegin(),
+            files.cend(),
+            [ & ] (
+               const ArchiveCandidate & file )
+            {
+               return
+                  ToQString(file.path.filename()) == entry.name;
+            });
+
+      if (replaced)
+         continue;
+
+      // the uncommitted bundle is discarded and the original kept
+      if (stop_requested)
+         return false;
+
+      const qint64 offset =
+         bundle.pos();
+
+      if (!CopyFrame(existing_bundle, entry, bundle))
+      {
+         error_message =
+            "Cannot copy '" +
+            entry.name +
+            "' from the archive '" +
+            ToQString(bundle_path) +
+            "'.";
+
+         return false;
+      }
+
+      entry.offset = static_cast< uint64_t >(offset);
+
+      entries.push_back(
+         std::move(entry));
+   }
+
+   // one file at a time, so memory use is bounded by the largest file
+   for (const auto & file : files)
+   {
+      if (stop_requested)
+         return false;
+
+      QFile source {
+         ToQString(file.path)
+      };
+
+      if (!source.open(QIODevice::OpenModeFlag::ReadOnly))
+      {
+         error_message =
+            "Cannot read '" +
+            ToQString(file.path) +
+            "'.";
+
+         return false;
+      }
+
+      const QByteArray data =
+         source.readAll();
+      const QByteArray frame =
+         qCompress(
+            data,
+            9);
+
+      entries.push_back(
+         ArchiveEntry {
+            ToQString(file.path.filename()),
+            file.modified_unix_ms,
+            static_cast< uint64_t >(bundle.pos()),
+            static_cast< uint32_t >(frame.size()),
+            static_cast< uint32_t >(data.size()),
+            ByteArrayCrc32(data) });
+
+      if (bundle.write(frame) != frame.size())
+      {
+         error_message =
+            "Cannot write the archive '" +
+            ToQString(bundle_path) +
+            "'.";
+
+         return false;
+      }
+   }
+
+   QByteArray index;
+
+   {
+      QDataStream index_stream {
+         &index,
+         QIODevice::OpenModeFlag::WriteOnly
+      };
+
+      index_stream.setByteOrder(
+         QDataStream::ByteOrder::LittleEndian);
+
+      for (const auto & entry : entries)
+      {
+         const QByteArray name =
+            entry.name.toUtf8();
+
+         index_stream
+            << static_cast< quint16 >(name.size());
+         index_stream.writeRawData(
+            name.constData(),
+            name.size());
+         index_stream
+            << static_cast< qint64 >(entry.modified_unix_ms)
+            << static_cast< quint64 >(entry.offset)
+            << static_cast< quint32 >(entry.compressed_size)
+            << static_cast< quint32 >(entry.size)
+            << static_cast< quint32 >(entry.crc);
+      }
+   }
+
+   const qint64 index_offset =
+      bundle.pos();
+
+   bundle.write(
+      index);
+
+   stream
+      << static_cast< quint64 >(index_offset)
+      << static_cast< quint32 >(entries.size())
+      << static_cast< quint32 >(ByteArrayCrc32(index));
+   stream.writeRawData(
+      FOOTER_MAGIC,
+      sizeof(FOOTER_MAGIC));
+   stream
+      << quint16 { REPORT_ARCHIVE_VERSION }
+      << quint16 { FOOTER_SIZE };
+
+   if (stream.status() != QDataStream::Status::Ok ||
+       !bundle.commit())
+   {
+      error_message =
+         "Cannot write the archive '" +
+         ToQString(bundle_path) +
+         "'.";
+
+      return false;
+   }
+
+   return true;
+}
+
+} // namespace
+
+bool ReadArchiveIndex(
+   const std::filesystem::path & bundle_path,
+   std::vector< ArchiveEntry > & entries ) noexcept
+{
+   try
+   {
+      QFile bundle {
+         ToQString(bundle_path)
+      };
+
+      if (!bundle.open(QIODevice::OpenModeFlag::ReadOnly) ||
+          bundle.size() < HEADER_SIZE + FOOTER_SIZE ||
+          !bundle.seek(bundle.size() - FOOTER_SIZE))
+      {
+         return false;
+      }
+
+      QDataStream footer_stream {
+         bundle.read(FOOTER_SIZE)
+      };
+
+      footer_stream.setByteOrder(
+         QDataStream::ByteOrder::LittleEndian);
+
+      quint64 index_offset { };
+      quint32 entry_count { };
+      quint32 index_crc { };
+      char magic[4] { };
+      quint16 version { };
+      quint16 footer_size { };
+
+      footer_stream
+         >> index_offset
+         >> entry_count
+         >> index_crc;
+      footer_stream.readRawData(
+         magic,
+         sizeof(magic));
+      footer_stream
+         >> version
+         >> footer_size;
+
+      const quint64 index_end =
+         static_cast< quint64 >(bundle.size() - FOOTER_SIZE);
+
+      if (footer_stream.status() != QDataStream::Status::Ok ||
+          std::memcmp(magic, FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) != 0 ||
+          version != REPORT_ARCHIVE_VERSION ||
+          footer_size != FOOTER_SIZE ||
+          index_offset < HEADER_SIZE ||
+          index_offset > index_end ||
+          !bundle.seek(static_cast< qint64 >(index_offset)))
+      {
+         return false;
+      }
+
+      const QByteArray index =
+         bundle.read(
+            static_cast< qint64 >(index_end - index_offset));
+
+      if (static_cast< quint64 >(index.size()) != index_end - index_offset ||
+          ByteArrayCrc32(index) != index_crc)
+      {
+         return false;
+      }
+
+      QDataStream index_stream {
+         index
+      };
+
+      index_stream.setByteOrder(
+         QDataStream::ByteOrder::LittleEndian);
+
+      entries.clear();
+      entries.reserve(
+         entry_count);
+
+      for (quint32 i { }; i < entry_count; ++i)
+      {
+         quint16 name_size { };
+
+         index_stream
+            >> name_size;
+
+         QByteArray name {
+            name_size,
+            Qt::Initialization::Uninitialized
+         };
+
+         index_stream.readRawData(
+            name.data(),
+            name_size);
+
+         qint64 modified_unix_ms { };
+         quint64 offset { };
+         quint32 compressed_size { };
+         quint32 size { };
+         quint32 crc { };
+
+         index_stream
+            >> modified_unix_ms
+            >> offset
+            >> compressed_size
+            >> size
+            >> crc;
+
+         if (index_stream.status() != QDataStream::Status::Ok ||
+             offset < HEADER_SIZE ||
+             offset + compressed_size > index_offset)
+         {
+            return false;
+         }
+
+         entries.push_back(
+            ArchiveEntry {
+               QString::fromUtf8(name),
+               modified_unix_ms,
+               offset,
+               compressed_size,
+               size,
+               crc });
+      }
+
+      return true;
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+bool ExtractArchiveEntry(
+   const std::filesystem::path & bundle_path,
+   const ArchiveEntry & entry,
+   QByteArray & data ) noexcept
+{
+   try
+   {
+      QFile bundle {
+         ToQString(bundle_path)
+      };
+
+      if (!bundle.open(QIODevice::OpenModeFlag::ReadOnly) ||
+          !bundle.seek(static_cast< qint64 >(entry.offset)))
+      {
+         return false;
+      }
+
+      const QByteArray frame =
+         bundle.read(
+            entry.compressed_size);
+
+      if (static_cast< uint32_t >(frame.size()) != entry.compressed_size)
+         return false;
+
+      data =
+         qUncompress(
+            frame);
+
+      return
+         static_cast< uint32_t >(data.size()) == entry.size &&
+         ByteArrayCrc32(data) == entry.crc;
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+bool ExtractArchivedFile(
+   const std::filesystem::path & bundle_path,
+   const QString & name,
+   QByteArray & data ) noexcept
+{
+   std::vector< ArchiveEntry > entries;
+
+   if (!ReadArchiveIndex(bundle_path, entries))
+      return false;
+
+   const auto entry =
+      std::find_if(
+         entries.cbegin(),
+         entries.cend(),
+         [ & ] (
+            const ArchiveEntry & entry )
+         {
+            return
+               entry.name == name;
+         });
+
+   return
+      entry != entries.cend() &&
+      ExtractArchiveEntry(
+         bundle_path,
+         *entry,
+         data);
+}
+
+ArchiveResult ArchiveReports(
+   const std::filesystem::path & reports_directory,
+   const std::chrono::hours max_age,
+   const std::atomic< bool > & stop_requested ) noexcept
+{
+   ArchiveResult result { };
+
+   try
+   {
+      // instances sharing the reports directory, e.g. on a network drive,
+      // would each rewrite a bundle without the files of the other and
+      // then remove the originals of both
+      QLockFile lock {
+         ToQString(reports_directory / LOCK_FILE_NAME)
+      };
+
+      lock.setStaleLockTime(
+         LOCK_STALE_TIME_MS);
+
+      // the instance holding the lock archives the same files
+      if (!lock.tryLock(0))
+         return result;
+
+      const auto now =
+         std::filesystem::file_time_type::clock::now();
+      const auto system_now =
+         std::chrono::system_clock::now();
+
+      // files grouped by the year and month in their name
+      std::map< std::string, std::vector< ArchiveCandidate > > months;
+
+      std::error_code error;
+
+      for (std::filesystem::directory_iterator entry {
+              reports_directory,
+              error };
+           !error && entry != std::filesystem::directory_iterator { };
+           entry.increment(error))
+      {
+         std::error_code status_error;
+
+         if (!entry->is_regular_file(status_error))
+            continue;
+
+         const auto extension =
+            entry->path().extension();
+
+         if (extension != ".txt" &&
+             extension != SESSION_FORMAT_EXTENSION)
+         {
+            continue;
+         }
+
+         const std::string report_name =
+            entry->path().stem().string();
+
+         std::string_view username;
+         std::string_view date_time;
+
+         if (!ParseReportName(report_name, username, date_time))
+            continue;
+
+         const auto write_time =
+            entry->last_write_time(
+               status_error);
+
+         if (status_error ||
+             now - write_time < max_age)
+         {
+            continue;
+         }
+
+         const auto modified =
+            std::chrono::duration_cast<
+               std::chrono::milliseconds >(
+                  (write_time - now) +
+                  system_now.time_since_epoch());
+
+         months[std::string { date_time.substr(0, 7) }].push_back(
+            ArchiveCandidate {
+               entry->path(),
+               modified.count() });
+      }
+
+      for (const auto & [month, files] : months)
+      {
+         if (stop_requested)
+            break;
+
+         const auto bundle_path =
+            reports_directory /
+            ("reports-" +
+             month +
+             REPORT_ARCHIVE_EXTENSION);
+
+         if (!WriteBundle(bundle_path, files, stop_requested, result.error_message))
+            continue;
+
+         ++result.bundles_written;
+
+         for (const auto & file : files)
+         {
+            std::error_code remove_error;
+
+            std::filesystem::remove(
+               file.path,
+               remove_error);
+         }
+
+         result.archived_files += files.size();
+      }
+   }
+   catch (const std::exception & exception)
+   {
+      result.error_message =
+         QString { "Cannot archive the reports: " } +
+         exception.what();
+   }
+
+   return
+      result;
+}
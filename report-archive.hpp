@@ -0,0 +1,90 @@
+#ifndef _REPORT_ARCHIVE_HPP_
+#define _REPORT_ARCHIVE_HPP_
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// reports older than a configurable age are moved into one compressed
+// bundle per month, named reports-YYYY-MM.mfz.  every file is compressed
+// separately with qCompress, so any one of them can be extracted by
+// seeking to it through the index at the end of the bundle.
+//
+// all integers are little endian.
+//
+//    header
+//       char[4]  magic "MFAR"
+//       uint16   version
+//       uint16   header size in bytes
+//
+//    frames, one per file, each the output of qCompress
+//
+//    index, one entry per file
+//       uint16   name size in bytes
+//       char[]   utf-8 file name
+//       int64    last modification, unix time in milliseconds
+//       uint64   frame offset
+//       uint32   frame size
+//       uint32   uncompressed size
+//       uint32   crc32 of the uncompressed file
+//
+//    footer
+//       uint64   index offset
+//       uint32   amount of entries
+//       uint32   crc32 of the index
+//       char[4]  magic "MFAZ"
+//       uint16   version
+//       uint16   footer size in bytes
+struct ArchiveEntry
+{
+   QString name;
+   int64_t modified_unix_ms;
+   uint64_t offset;
+   uint32_t compressed_size;
+   uint32_t size;
+   uint32_t crc;
+};
+
+struct ArchiveResult
+{
+   size_t archived_files;
+   size_t bundles_written;
+   QString error_message;
+};
+
+constexpr uint16_t REPORT_ARCHIVE_VERSION { 1 };
+constexpr const char * REPORT_ARCHIVE_EXTENSION { ".mfz" };
+
+bool ReadArchiveIndex(
+   const std::filesystem::path & bundle_path,
+   std::vector< ArchiveEntry > & entries ) noexcept;
+
+bool ExtractArchiveEntry(
+   const std::filesystem::path & bundle_path,
+   const ArchiveEntry & entry,
+   QByteArray & data ) noexcept;
+
+// extracts a single report or session file by its original file name
+bool ExtractArchivedFile(
+   const std::filesystem::path & bundle_path,
+   const QString & name,
+   QByteArray & data ) noexcept;
+
+// moves the reports and session files of the directory that were last
+// modified at least max_age ago into their monthly bundles.  a bundle is
+// rewritten into a temporary file that replaces it only once complete,
+// and the original files are removed only after that, so an interrupted
+// run loses nothing and is finished by the next one.  setting
+// stop_requested from another thread ends a run at the next file.
+ArchiveResult ArchiveReports(
+   const std::filesystem::path & reports_directory,
+   const std::chrono::hours max_age,
+   const std::atomic< bool > & stop_requested ) noexcept;
+
+#endif // _REPORT_ARCHIVE_HPP_
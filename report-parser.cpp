@@ -0,0 +1,307 @@
+#include "report-parser.hpp"
+#include "fact-id.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <system_error>
+
+static bool IsDigit(
+   const char c ) noexcept
+{
+   return
+      c >= '0' && c <= '9';
+}
+
+// "-YYYY-MM-DD-HH.MM.SS"
+static bool IsDateTimeSuffix(
+   const std::string_view text ) noexcept
+{
+   constexpr std::string_view PATTERN { "-0000-00-00-00.00.00" };
+
+   if (text.size() < PATTERN.size())
+      return false;
+
+   for (size_t i { }; i < PATTERN.size(); ++i)
+   {
+      const bool matches =
+         PATTERN[i] == '0' ?
+            IsDigit(text[i]) :
+            PATTERN[i] == text[i];
+
+      if (!matches)
+         return false;
+   }
+
+   return true;
+}
+
+template < typename T >
+static bool ParseNumber(
+   std::string_view & text,
+   T & value ) noexcept
+{
+   const auto [end, error] =
+      std::from_chars(
+         text.data(),
+         text.data() + text.size(),
+         value);
+
+   if (error != std::errc { })
+      return false;
+
+   text.remove_prefix(
+      end - text.data());
+
+   return true;
+}
+
+static bool ConsumePrefix(
+   std::string_view & text,
+   const std::string_view prefix ) noexcept
+{
+   if (!text.starts_with(prefix))
+      return false;
+
+   text.remove_prefix(
+      prefix.size());
+
+   return true;
+}
+
+bool ParseReportName(
+   const std::string_view report_name,
+   std::string_view & username,
+   std::string_view & date_time ) noexcept
+{
+   // user names may contain dashes and digits themselves, so the date is
+   // searched for from the end of the name
+   for (size_t position { report_name.size() }; position-- > 0; )
+   {
+      if (report_name[position] == '-' &&
+          IsDateTimeSuffix(report_name.substr(position)))
+      {
+         username = report_name.substr(0, position);
+         date_time = report_name.substr(position + 1);
+
+         return
+            !username.empty();
+      }
+   }
+
+   return false;
+}
+
+bool ParseFact(
+   const std::string_view question_with_answer,
+   uint16_t & fact_id,
+   FactOperation & operation ) noexcept
+{
+   constexpr std::string_view CLOCK_QUESTION { "What time is it? It is " };
+   constexpr std::string_view MILITARY_QUESTION { "What military time is it? It is " };
+
+   std::string_view text { question_with_answer };
+
+   const bool is_clock = ConsumePrefix(text, CLOCK_QUESTION);
+   const bool is_military = !is_clock && ConsumePrefix(text, MILITARY_QUESTION);
+
+   if (is_clock || is_military)
+   {
+      int32_t hour { };
+      int32_t minute { };
+
+      if (!ParseNumber(text, hour) ||
+          !ConsumePrefix(text, ":") ||
+          !ParseNumber(text, minute) ||
+          minute < 0 || minute >= 60 || minute % 5 != 0)
+      {
+         return false;
+      }
+
+      TimeFactKind kind { TimeFactKind::CLOCK };
+
+      if (is_clock)
+      {
+         if (hour < 1 || hour > 12)
+            return false;
+      }
+      else
+      {
+         if (hour < 0 || hour > 23)
+            return false;
+
+         kind =
+            hour >= 12 ?
+               TimeFactKind::MILITARY_AFTERNOON :
+               TimeFactKind::MILITARY_MORNING;
+         hour =
+            hour % 12 == 0 ?
+               12 :
+               hour % 12;
+      }
+
+      fact_id =
+         TimeFactId(
+            kind,
+            static_cast< uint8_t >(hour),
+            static_cast< uint8_t >(minute));
+      operation =
+         FactOperation::TIME;
+
+      return true;
+   }
+
+   int32_t top { };
+   int32_t bottom { };
+
+   if (!ParseNumber(text, top) ||
+       text.size() < 3 ||
+       text[0] != ' ' ||
+       text[2] != ' ')
+   {
+      return false;
+   }
+
+   switch (text[1])
+   {
+   case '+': operation = FactOperation::ADD; break;
+   case '-': operation = FactOperation::SUB; break;
+   case '*': operation = FactOperation::MUL; break;
+   case '/': operation = FactOperation::DIV; break;
+   default: return false;
+   }
+
+   text.remove_prefix(3);
+
+   if (!ParseNumber(text, bottom))
+      return false;
+
+   constexpr int32_t MAX_OPERAND { ARITHMETIC_FACT_OPERANDS - 1 };
+
+   const bool valid =
+      operation == FactOperation::DIV ?
+         bottom >= 1 && bottom <= MAX_OPERAND &&
+         top >= 0 && top % bottom == 0 && top / bottom <= MAX_OPERAND :
+         top >= 0 && top <= MAX_OPERAND &&
+         bottom >= 0 && bottom <= MAX_OPERAND;
+
+   if (!valid)
+      return false;
+
+   fact_id =
+      ArithmeticFactId(
+         operation,
+         top,
+         bottom);
+
+   return true;
+}
+
+bool ParseAnswerLine(
+   const std::string_view line,
+   ParsedAnswer & answer ) noexcept
+{
+   constexpr std::string_view SEPARATOR { "; " };
+
+   size_t field_end =
+      line.find(SEPARATOR);
+
+   if (field_end == std::string_view::npos ||
+       !ParseFact(line.substr(0, field_end), answer.fact_id, answer.operation))
+   {
+      return false;
+   }
+
+   bool has_response_time { };
+   answer.number_of_responses = 0;
+
+   while (field_end != std::string_view::npos)
+   {
+      const size_t field_begin =
+         field_end + SEPARATOR.size();
+
+      field_end =
+         line.find(SEPARATOR, field_begin);
+
+      std::string_view field =
+         line.substr(
+            field_begin,
+            field_end == std::string_view::npos ?
+               std::string_view::npos :
+               field_end - field_begin);
+
+      if (ConsumePrefix(field, "response time ms = "))
+      {
+         has_response_time =
+            ParseNumber(
+               field,
+               answer.response_time_ms);
+      }
+      else if (ConsumePrefix(field, "responses = "))
+      {
+         for (size_t i { }; i < field.size(); ++i)
+         {
+            const bool token_start =
+               field[i] != ' ' &&
+               (i == 0 || field[i - 1] == ' ');
+
+            answer.number_of_responses += token_start;
+         }
+      }
+   }
+
+   return
+      has_response_time;
+}
+
+bool ParseReport(
+   const std::string_view report,
+   std::vector< ParsedAnswer > & answers )
+{
+   constexpr std::string_view ALL_ANSWERS { "\nall answers" };
+
+   size_t position =
+      report.find(ALL_ANSWERS);
+
+   if (position == std::string_view::npos)
+      return false;
+
+   position =
+      report.find('\n', position + ALL_ANSWERS.size());
+
+   while (position != std::string_view::npos &&
+          position < report.size())
+   {
+      const size_t line_begin =
+         position + 1;
+      const size_t line_end =
+         report.find('\n', line_begin);
+
+      std::string_view line =
+         report.substr(
+            line_begin,
+            line_end == std::string_view::npos ?
+               std::string_view::npos :
+               line_end - line_begin);
+
+      // reports written in text mode on windows
+      if (line.ends_with('\r'))
+         line.remove_suffix(1);
+
+      // the performance section follows the answers
+      if (line.empty())
+         break;
+
+      ParsedAnswer answer { };
+
+      if (ParseAnswerLine(line, answer))
+      {
+         answers.push_back(
+            answer);
+      }
+
+      position =
+         line_end;
+   }
+
+   return true;
+}
@@ -0,0 +1,46 @@
+#ifndef _REPORT_PARSER_HPP_
+#define _REPORT_PARSER_HPP_
+
+#include "fact-operation.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// one line of the "all answers" section of a text report
+struct ParsedAnswer
+{
+   uint16_t fact_id;
+   FactOperation operation;
+   uint32_t response_time_ms;
+   uint32_t number_of_responses;
+};
+
+// splits a report file name without its extension, as produced by
+// FormatReportName, into the user name and the local date and time the
+// session ended.  the date and time sorts in chronological order.
+bool ParseReportName(
+   const std::string_view report_name,
+   std::string_view & username,
+   std::string_view & date_time ) noexcept;
+
+// recognizes the fact from the question with answer of a report line,
+// such as "3 + 4 = 7" or "What military time is it? It is 15:05"
+bool ParseFact(
+   const std::string_view question_with_answer,
+   uint16_t & fact_id,
+   FactOperation & operation ) noexcept;
+
+bool ParseAnswerLine(
+   const std::string_view line,
+   ParsedAnswer & answer ) noexcept;
+
+// appends the answers of the "all answers" section, which ends at the
+// first blank line.  reports written before think time, typing time and
+// ui latency were recorded parse the same way.  returns false if the
+// section is missing.
+bool ParseReport(
+   const std::string_view report,
+   std::vector< ParsedAnswer > & answers );
+
+#endif // _REPORT_PARSER_HPP_
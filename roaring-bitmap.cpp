@@ -0,0 +1,757 @@
+#include "roaring-bitmap.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+namespace
+{
+
+template < typename T >
+void PutValue(
+   std::vector< uint8_t > & data,
+   const T value )
+{
+   static_assert(std::is_arithmetic_v< T >);
+
+   const auto bytes =
+      reinterpret_cast< const uint8_t * >(&value);
+
+   data.insert(
+      data.end(),
+      bytes,
+      bytes + sizeof(value));
+}
+
+template < typename T >
+bool GetValues(
+   const uint8_t * & position,
+   const uint8_t * const end,
+   T * const values,
+   const size_t count ) noexcept
+{
+   static_assert(std::is_arithmetic_v< T >);
+
+   if (static_cast< size_t >(end - position) / sizeof(T) < count)
+      return false;
+
+   std::memcpy(
+      values,
+      position,
+      count * sizeof(T));
+
+   position += count * sizeof(T);
+
+   return true;
+}
+
+bool TestBit(
+   const std::vector< uint64_t > & words,
+   const uint16_t low ) noexcept
+{
+   return
+      words[low / 64] >> (low % 64) & 1;
+}
+
+} // namespace
+
+void RoaringBitmap::Add(
+   const uint32_t value )
+{
+   auto & container =
+      *FindOrInsert(
+         static_cast< uint16_t >(value >> 16));
+
+   const auto low =
+      static_cast< uint16_t >(value);
+
+   if (container.IsBitmap())
+   {
+      auto & word =
+         container.words[low / 64];
+
+      const uint64_t bit =
+         uint64_t { 1 } << (low % 64);
+
+      container.cardinality += (word & bit) == 0;
+      word |= bit;
+
+      return;
+   }
+
+   auto & values =
+      container.values;
+
+   if (values.empty() || values.back() < low)
+   {
+      values.push_back(
+         low);
+   }
+   else
+   {
+      const auto position =
+         std::lower_bound(
+            values.begin(),
+            values.end(),
+            low);
+
+      if (*position == low)
+         return;
+
+      values.insert(
+         position,
+         low);
+   }
+
+   container.cardinality =
+      static_cast< uint32_t >(values.size());
+
+   Normalize(
+      container);
+}
+
+void RoaringBitmap::AddRange(
+   const uint32_t begin,
+   const uint32_t end )
+{
+   for (uint32_t value { begin }; value < end; ++value)
+   {
+      Add(
+         value);
+   }
+}
+
+bool RoaringBitmap::Contains(
+   const uint32_t value ) const noexcept
+{
+   const auto container =
+      Find(
+         static_cast< uint16_t >(value >> 16));
+
+   if (!container)
+      return false;
+
+   const auto low =
+      static_cast< uint16_t >(value);
+
+   return
+      container->IsBitmap() ?
+         TestBit(container->words, low) :
+         std::binary_search(
+            container->values.begin(),
+            container->values.end(),
+            low);
+}
+
+uint64_t RoaringBitmap::Cardinality( ) const noexcept
+{
+   uint64_t cardinality { };
+
+   for (const auto & container : containers_)
+   {
+      cardinality += container.cardinality;
+   }
+
+   return
+      cardinality;
+}
+
+bool RoaringBitmap::IsEmpty( ) const noexcept
+{
+   return
+      containers_.empty();
+}
+
+RoaringBitmap & RoaringBitmap::operator &= (
+   const RoaringBitmap & other )
+{
+   auto right =
+      other.containers_.begin();
+
+   std::erase_if(
+      containers_,
+      [ & ] (
+         Container & container )
+      {
+         while (right != other.containers_.end() &&
+                right->key < container.key)
+         {
+            ++right;
+         }
+
+         if (right == other.containers_.end() ||
+             right->key != container.key)
+         {
+            return true;
+         }
+
+         And(
+            container,
+            *right);
+
+         return
+            container.cardinality == 0;
+      });
+
+   return
+      *this;
+}
+
+RoaringBitmap & RoaringBitmap::operator |= (
+   const RoaringBitmap & other )
+{
+   std::vector< Container > merged;
+
+   merged.reserve(
+      std::max(
+         containers_.size(),
+         other.containers_.size()));
+
+   auto left = containers_.begin();
+   auto right = other.containers_.begin();
+
+   while (left != containers_.end() || right != other.containers_.end())
+   {
+      if (right == other.containers_.end() ||
+          (left != containers_.end() && left->key < right->key))
+      {
+         merged.push_back(
+            std::move(*left++));
+      }
+      else if (left == containers_.end() || right->key < left->key)
+      {
+         merged.push_back(
+            *right++);
+      }
+      else
+      {
+         Or(
+            *left,
+            *right++);
+
+         merged.push_back(
+            std::move(*left++));
+      }
+   }
+
+   containers_ =
+      std::move(merged);
+
+   return
+      *this;
+}
+
+RoaringBitmap & RoaringBitmap::operator -= (
+   const RoaringBitmap & other )
+{
+   auto right =
+      other.containers_.begin();
+
+   std::erase_if(
+      containers_,
+      [ & ] (
+         Container & container )
+      {
+         while (right != other.containers_.end() &&
+                right->key < container.key)
+         {
+            ++right;
+         }
+
+         if (right == other.containers_.end() ||
+             right->key != container.key)
+         {
+            return false;
+         }
+
+         AndNot(
+            container,
+            *right);
+
+         return
+            container.cardinality == 0;
+      });
+
+   return
+      *this;
+}
+
+uint64_t RoaringBitmap::AndCardinality(
+   const RoaringBitmap & left,
+   const RoaringBitmap & right ) noexcept
+{
+   uint64_t cardinality { };
+
+   auto left_container = left.containers_.begin();
+   auto right_container = right.containers_.begin();
+
+   while (left_container != left.containers_.end() &&
+          right_container != right.containers_.end())
+   {
+      if (left_container->key < right_container->key)
+      {
+         ++left_container;
+      }
+      else if (right_container->key < left_container->key)
+      {
+         ++right_container;
+      }
+      else
+      {
+         cardinality +=
+            AndCardinality(
+               *left_container++,
+               *right_container++);
+      }
+   }
+
+   return
+      cardinality;
+}
+
+void RoaringBitmap::Serialize(
+   std::vector< uint8_t > & data ) const
+{
+   PutValue(
+      data,
+      static_cast< uint32_t >(containers_.size()));
+
+   for (const auto & container : containers_)
+   {
+      PutValue(data, container.key);
+      PutValue(data, container.cardinality);
+
+      const auto bytes =
+         container.IsBitmap() ?
+            reinterpret_cast< const uint8_t * >(container.words.data()) :
+            reinterpret_cast< const uint8_t * >(container.values.data());
+      const size_t size =
+         container.IsBitmap() ?
+            container.words.size() * sizeof(uint64_t) :
+            container.values.size() * sizeof(uint16_t);
+
+      data.insert(
+         data.end(),
+         bytes,
+         bytes + size);
+   }
+}
+
+bool RoaringBitmap::Deserialize(
+   const uint8_t * & position,
+   const uint8_t * const end )
+{
+   uint32_t container_count { };
+
+   if (!GetValues(position, end, &container_count, 1))
+      return false;
+
+   std::vector< Container > containers;
+
+   for (uint32_t i { }; i < container_count; ++i)
+   {
+      Container container { };
+
+      if (!GetValues(position, end, &container.key, 1) ||
+          !GetValues(position, end, &container.cardinality, 1) ||
+          container.cardinality == 0 ||
+          container.cardinality > 65536 ||
+          (!containers.empty() && containers.back().key >= container.key))
+      {
+         return false;
+      }
+
+      bool read { };
+
+      if (container.cardinality > ARRAY_LIMIT)
+      {
+         container.words.resize(
+            BITMAP_WORDS);
+
+         read =
+            GetValues(
+               position,
+               end,
+               container.words.data(),
+               container.words.size());
+      }
+      else
+      {
+         container.values.resize(
+            container.cardinality);
+
+         read =
+            GetValues(
+               position,
+               end,
+               container.values.data(),
+               container.values.size());
+      }
+
+      if (!read)
+         return false;
+
+      containers.push_back(
+         std::move(container));
+   }
+
+   containers_ =
+      std::move(containers);
+
+   return true;
+}
+
+size_t RoaringBitmap::SizeInBytes( ) const noexcept
+{
+   size_t size { sizeof(*this) };
+
+   for (const auto & container : containers_)
+   {
+      size +=
+         sizeof(container) +
+         container.values.capacity() * sizeof(uint16_t) +
+         container.words.capacity() * sizeof(uint64_t);
+   }
+
+   return
+      size;
+}
+
+void RoaringBitmap::ToBitmap(
+   Container & container )
+{
+   container.words.assign(
+      BITMAP_WORDS,
+      0);
+
+   for (const uint16_t low : container.values)
+   {
+      container.words[low / 64] |= uint64_t { 1 } << (low % 64);
+   }
+
+   container.values.clear();
+   container.values.shrink_to_fit();
+}
+
+void RoaringBitmap::Normalize(
+   Container & container )
+{
+   if (container.IsBitmap() && container.cardinality <= ARRAY_LIMIT)
+   {
+      container.values.clear();
+      container.values.reserve(
+         container.cardinality);
+
+      for (size_t word { }; word < BITMAP_WORDS; ++word)
+      {
+         for (uint64_t bits { container.words[word] }; bits; bits &= bits - 1)
+         {
+            container.values.push_back(
+               static_cast< uint16_t >(word * 64 + std::countr_zero(bits)));
+         }
+      }
+
+      container.words.clear();
+      container.words.shrink_to_fit();
+   }
+   else if (!container.IsBitmap() && container.cardinality > ARRAY_LIMIT)
+   {
+      ToBitmap(
+         container);
+   }
+}
+
+RoaringBitmap::Container * RoaringBitmap::FindOrInsert(
+   const uint16_t key )
+{
+   // values mostly arrive in increasing order
+   if (containers_.empty() || containers_.back().key < key)
+   {
+      containers_.push_back(
+         Container { key, 0, { }, { } });
+
+      return
+         &containers_.back();
+   }
+
+   const auto position =
+      std::lower_bound(
+         containers_.begin(),
+         containers_.end(),
+         key,
+         [ ] (
+            const Container & container,
+            const uint16_t key )
+         {
+            return
+               container.key < key;
+         });
+
+   if (position->key == key)
+      return &*position;
+
+   return
+      &*containers_.insert(
+         position,
+         Container { key, 0, { }, { } });
+}
+
+const RoaringBitmap::Container * RoaringBitmap::Find(
+   const uint16_t key ) const noexcept
+{
+   const auto position =
+      std::lower_bound(
+         containers_.begin(),
+         containers_.end(),
+         key,
+         [ ] (
+            const Container & container,
+            const uint16_t key )
+         {
+            return
+               container.key < key;
+         });
+
+   return
+      position != containers_.end() && position->key == key ?
+         &*position :
+         nullptr;
+}
+
+void RoaringBitmap::And(
+   Container & left,
+   const Container & right )
+{
+   if (left.IsBitmap() && right.IsBitmap())
+   {
+      uint32_t cardinality { };
+
+      for (size_t word { }; word < BITMAP_WORDS; ++word)
+      {
+         left.words[word] &= right.words[word];
+         cardinality += std::popcount(left.words[word]);
+      }
+
+      left.cardinality = cardinality;
+   }
+   else if (left.IsBitmap())
+   {
+      // the result is never larger than the array
+      std::vector< uint16_t > values;
+
+      for (const uint16_t low : right.values)
+      {
+         if (TestBit(left.words, low))
+            values.push_back(low);
+      }
+
+      left.words.clear();
+      left.values = std::move(values);
+      left.cardinality = static_cast< uint32_t >(left.values.size());
+   }
+   else if (right.IsBitmap())
+   {
+      std::erase_if(
+         left.values,
+         [ & ] (
+            const uint16_t low )
+         {
+            return
+               !TestBit(
+                  right.words,
+                  low);
+         });
+
+      left.cardinality = static_cast< uint32_t >(left.values.size());
+   }
+   else
+   {
+      std::vector< uint16_t > values;
+
+      std::set_intersection(
+         left.values.begin(),
+         left.values.end(),
+         right.values.begin(),
+         right.values.end(),
+         std::back_inserter(values));
+
+      left.values = std::move(values);
+      left.cardinality = static_cast< uint32_t >(left.values.size());
+   }
+
+   Normalize(
+      left);
+}
+
+void RoaringBitmap::Or(
+   Container & left,
+   const Container & right )
+{
+   if (!left.IsBitmap() && !right.IsBitmap() &&
+       left.values.size() + right.values.size() <= ARRAY_LIMIT)
+   {
+      std::vector< uint16_t > values;
+
+      std::set_union(
+         left.values.begin(),
+         left.values.end(),
+         right.values.begin(),
+         right.values.end(),
+         std::back_inserter(values));
+
+      left.values = std::move(values);
+      left.cardinality = static_cast< uint32_t >(left.values.size());
+
+      return;
+   }
+
+   if (!left.IsBitmap())
+   {
+      ToBitmap(
+         left);
+   }
+
+   if (right.IsBitmap())
+   {
+      for (size_t word { }; word < BITMAP_WORDS; ++word)
+      {
+         left.words[word] |= right.words[word];
+      }
+   }
+   else
+   {
+      for (const uint16_t low : right.values)
+      {
+         left.words[low / 64] |= uint64_t { 1 } << (low % 64);
+      }
+   }
+
+   uint32_t cardinality { };
+
+   for (const uint64_t word : left.words)
+   {
+      cardinality += std::popcount(word);
+   }
+
+   left.cardinality = cardinality;
+
+   Normalize(
+      left);
+}
+
+void RoaringBitmap::AndNot(
+   Container & left,
+   const Container & right )
+{
+   if (left.IsBitmap())
+   {
+      if (right.IsBitmap())
+      {
+         for (size_t word { }; word < BITMAP_WORDS; ++word)
+         {
+            left.words[word] &= ~right.words[word];
+         }
+      }
+      else
+      {
+         for (const uint16_t low : right.values)
+         {
+            left.words[low / 64] &= ~(uint64_t { 1 } << (low % 64));
+         }
+      }
+
+      uint32_t cardinality { };
+
+      for (const uint64_t word : left.words)
+      {
+         cardinality += std::popcount(word);
+      }
+
+      left.cardinality = cardinality;
+   }
+   else if (right.IsBitmap())
+   {
+      std::erase_if(
+         left.values,
+         [ & ] (
+            const uint16_t low )
+         {
+            return
+               TestBit(
+                  right.words,
+                  low);
+         });
+
+      left.cardinality = static_cast< uint32_t >(left.values.size());
+   }
+   else
+   {
+      std::vector< uint16_t > values;
+
+      std::set_difference(
+         left.values.begin(),
+         left.values.end(),
+         right.values.begin(),
+         right.values.end(),
+         std::back_inserter(values));
+
+      left.values = std::move(values);
+      left.cardinality = static_cast< uint32_t >(left.values.size());
+   }
+
+   Normalize(
+      left);
+}
+
+uint64_t RoaringBitmap::AndCardinality(
+   const Container & left,
+   const Container & right ) noexcept
+{
+   uint64_t cardinality { };
+
+   if (left.IsBitmap() && right.IsBitmap())
+   {
+      for (size_t word { }; word < BITMAP_WORDS; ++word)
+      {
+         cardinality += std::popcount(left.words[word] & right.words[word]);
+      }
+   }
+   else if (left.IsBitmap() || right.IsBitmap())
+   {
+      const auto & bitmap = left.IsBitmap() ? left : right;
+      const auto & array = left.IsBitmap() ? right : left;
+
+      for (const uint16_t low : array.values)
+      {
+         cardinality += TestBit(bitmap.words, low);
+      }
+   }
+   else
+   {
+      auto left_value = left.values.begin();
+      auto right_value = right.values.begin();
+
+      while (left_value != left.values.end() &&
+             right_value != right.values.end())
+      {
+         if (*left_value < *right_value)
+         {
+            ++left_value;
+         }
+         else if (*right_value < *left_value)
+         {
+            ++right_value;
+         }
+         else
+         {
+            ++cardinality;
+            ++left_value;
+            ++right_value;
+         }
+      }
+   }
+
+   return
+      cardinality;
+}
@@ -0,0 +1,139 @@
+#ifndef _ROARING_BITMAP_HPP_
+#define _ROARING_BITMAP_HPP_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// compressed set of 32 bit integers.  values are split by their upper 16
+// bits into containers; a container holds its lower 16 bits as a sorted
+// array while it has at most ARRAY_LIMIT values and as a 65536 bit
+// bitmap once it has more.  set operations work container by container
+// and pick the cheapest algorithm for the pair of representations.
+class RoaringBitmap
+{
+public:
+   static constexpr size_t ARRAY_LIMIT { 4096 };
+   static constexpr size_t BITMAP_WORDS { 65536 / 64 };
+
+   RoaringBitmap( ) noexcept = default;
+
+   // cheapest when values are added in increasing order
+   void Add(
+      const uint32_t value );
+   // adds every value in [begin, end)
+   void AddRange(
+      const uint32_t begin,
+      const uint32_t end );
+
+   bool Contains(
+      const uint32_t value ) const noexcept;
+
+   uint64_t Cardinality( ) const noexcept;
+   bool IsEmpty( ) const noexcept;
+
+   RoaringBitmap & operator &= (
+      const RoaringBitmap & other );
+   RoaringBitmap & operator |= (
+      const RoaringBitmap & other );
+   // removes the values of other
+   RoaringBitmap & operator -= (
+      const RoaringBitmap & other );
+
+   // the cardinality of the intersection, without building it
+   static uint64_t AndCardinality(
+      const RoaringBitmap & left,
+      const RoaringBitmap & right ) noexcept;
+
+   // calls function with every value in increasing order
+   template < typename Function >
+   void ForEach(
+      Function && function ) const
+   {
+      for (const auto & container : containers_)
+      {
+         const uint32_t high =
+            static_cast< uint32_t >(container.key) << 16;
+
+         if (container.IsBitmap())
+         {
+            for (size_t word { }; word < BITMAP_WORDS; ++word)
+            {
+               for (uint64_t bits { container.words[word] }; bits; bits &= bits - 1)
+               {
+                  function(
+                     high |
+                     static_cast< uint32_t >(word * 64 + std::countr_zero(bits)));
+               }
+            }
+         }
+         else
+         {
+            for (const uint16_t low : container.values)
+            {
+               function(
+                  high | low);
+            }
+         }
+      }
+   }
+
+   // host byte order; only read back on the machine that wrote it
+   void Serialize(
+      std::vector< uint8_t > & data ) const;
+   // advances position past the bitmap
+   bool Deserialize(
+      const uint8_t * & position,
+      const uint8_t * const end );
+
+   size_t SizeInBytes( ) const noexcept;
+
+private:
+   struct Container
+   {
+      uint16_t key;
+      uint32_t cardinality;
+
+      // sorted lower 16 bits while the container is small
+      std::vector< uint16_t > values;
+      // BITMAP_WORDS words once it is not
+      std::vector< uint64_t > words;
+
+      bool IsBitmap( ) const noexcept
+      {
+         return
+            !words.empty();
+      }
+   };
+
+   static void ToBitmap(
+      Container & container );
+   // switches the representation after the cardinality changed
+   static void Normalize(
+      Container & container );
+
+   Container * FindOrInsert(
+      const uint16_t key );
+   const Container * Find(
+      const uint16_t key ) const noexcept;
+
+   static void And(
+      Container & left,
+      const Container & right );
+   static void Or(
+      Container & left,
+      const Container & right );
+   static void AndNot(
+      Container & left,
+      const Container & right );
+   static uint64_t AndCardinality(
+      const Container & left,
+      const Container & right ) noexcept;
+
+   // sorted by key
+   std::vector< Container > containers_;
+
+};
+
+#endif // _ROARING_BITMAP_HPP_
@@ -0,0 +1,222 @@
+#include "session-export.hpp"
+#include "fact-id.hpp"
+#include "fact-operation.hpp"
+#include "streaming-writer.hpp"
+
+#include <string_view>
+
+static void AppendResponse(
+   StreamingWriter & writer,
+   const FactOperation operation,
+   const int32_t response ) noexcept
+{
+   if (operation == FactOperation::TIME)
+   {
+      char characters[MAX_TIME_RESPONSE_SIZE] { };
+
+      writer.Append(
+         std::string_view {
+            characters,
+            DecodeTimeResponse(response, characters)
+         });
+   }
+   else
+   {
+      writer.AppendNumber(
+         response);
+   }
+}
+
+static void AppendCsvField(
+   StreamingWriter & writer,
+   const std::string_view field ) noexcept
+{
+   writer.Append('"');
+
+   for (const char c : field)
+   {
+      if (c == '"')
+      {
+         writer.Append('"');
+      }
+
+      writer.Append(c);
+   }
+
+   writer.Append('"');
+}
+
+static void AppendJsonString(
+   StreamingWriter & writer,
+   const std::string_view text ) noexcept
+{
+   constexpr char HEX_DIGITS[] { "0123456789abcdef" };
+
+   writer.Append('"');
+
+   for (const char c : text)
+   {
+      if (c == '"' || c == '\\')
+      {
+         writer.Append('\\');
+         writer.Append(c);
+      }
+      else if (static_cast< unsigned char >(c) < 0x20)
+      {
+         writer.Append("\\u00");
+         writer.Append(HEX_DIGITS[c >> 4]);
+         writer.Append(HEX_DIGITS[c & 0xF]);
+      }
+      else
+      {
+         writer.Append(c);
+      }
+   }
+
+   writer.Append('"');
+}
+
+bool ExportSessionCsv(
+   const std::filesystem::path & path,
+   const SessionSnapshot & snapshot ) noexcept
+{
+   StreamingWriter writer {
+      path
+   };
+
+   if (!writer.IsOpen())
+      return false;
+
+   writer.Append(
+      "answer,fact_id,operation,question,answered_at_ms,response_time_ms,"
+      "think_time_ms,typing_time_ms,ui_latency_ms,responses\n");
+
+   for (size_t i { }; i < snapshot.answers.size(); ++i)
+   {
+      const auto & answer =
+         snapshot.answers[i];
+
+      writer.AppendNumber(i);
+      writer.Append(',');
+      writer.AppendNumber(answer.fact_id);
+      writer.Append(',');
+      writer.Append(FactOperationName(answer.operation));
+      writer.Append(',');
+      AppendCsvField(writer, answer.question_with_answer);
+      writer.Append(',');
+      writer.AppendNumber(answer.answered_at_ms);
+      writer.Append(',');
+      writer.AppendNumber(answer.response_time_ms);
+      writer.Append(',');
+      writer.AppendNumber(answer.think_time_ms);
+      writer.Append(',');
+      writer.AppendNumber(answer.typing_time_ms);
+      writer.Append(',');
+      writer.AppendNumber(answer.ui_latency_ms);
+      writer.Append(',');
+
+      for (size_t r { }; r < answer.responses.size(); ++r)
+      {
+         if (r)
+         {
+            writer.Append(' ');
+         }
+
+         AppendResponse(
+            writer,
+            answer.operation,
+            answer.responses[r]);
+      }
+
+      writer.Append('\n');
+   }
+
+   return
+      writer.Finish();
+}
+
+bool ExportSessionJson(
+   const std::filesystem::path & path,
+   const SessionSnapshot & snapshot ) noexcept
+{
+   StreamingWriter writer {
+      path
+   };
+
+   if (!writer.IsOpen())
+      return false;
+
+   const auto & header =
+      snapshot.header;
+
+   writer.Append("{\n  \"username\": ");
+   AppendJsonString(writer, snapshot.username);
+   writer.Append(",\n  \"session_start_unix_ms\": ");
+   writer.AppendNumber(header.session_start_unix_ms);
+   writer.Append(",\n  \"practice_duration_ms\": ");
+   writer.AppendNumber(header.practice_duration_ms);
+   writer.Append(",\n  \"minimum_amount_to_practice\": ");
+   writer.AppendNumber(header.minimum_amount_to_practice);
+   writer.Append(",\n  \"enabled_math_facts\": ");
+   writer.AppendNumber(header.enabled_math_facts);
+   writer.Append(",\n  \"answers\": [");
+
+   for (size_t i { }; i < snapshot.answers.size(); ++i)
+   {
+      const auto & answer =
+         snapshot.answers[i];
+
+      writer.Append(i ? ",\n    {" : "\n    {");
+      writer.Append("\"fact_id\": ");
+      writer.AppendNumber(answer.fact_id);
+      writer.Append(", \"operation\": \"");
+      writer.Append(FactOperationName(answer.operation));
+      writer.Append("\", \"question\": ");
+      AppendJsonString(writer, answer.question_with_answer);
+      writer.Append(", \"answered_at_ms\": ");
+      writer.AppendNumber(answer.answered_at_ms);
+      writer.Append(", \"response_time_ms\": ");
+      writer.AppendNumber(answer.response_time_ms);
+      writer.Append(", \"think_time_ms\": ");
+      writer.AppendNumber(answer.think_time_ms);
+      writer.Append(", \"typing_time_ms\": ");
+      writer.AppendNumber(answer.typing_time_ms);
+      writer.Append(", \"ui_latency_ms\": ");
+      writer.AppendNumber(answer.ui_latency_ms);
+      writer.Append(", \"responses\": [");
+
+      for (size_t r { }; r < answer.responses.size(); ++r)
+      {
+         if (r)
+         {
+            writer.Append(", ");
+         }
+
+         // time responses are strings such as "3:05"
+         if (answer.operation == FactOperation::TIME)
+         {
+            writer.Append('"');
+         }
+
+         AppendResponse(
+            writer,
+            answer.operation,
+            answer.responses[r]);
+
+         if (answer.operation == FactOperation::TIME)
+         {
+            writer.Append('"');
+         }
+      }
+
+      writer.Append("]}");
+   }
+
+   writer.Append(
+      snapshot.answers.empty() ?
+         "]\n}\n" :
+         "\n  ]\n}\n");
+
+   return
+      writer.Finish();
+}
@@ -0,0 +1,27 @@
+#ifndef _SESSION_EXPORT_HPP_
+#define _SESSION_EXPORT_HPP_
+
+#include "session-report.hpp"
+
+#include <cstdint>
+#include <filesystem>
+
+enum ExportFormatBits : uint32_t
+{
+   CSV = 0x01,
+   JSON = 0x02
+};
+
+// one row per answer; the responses are separated by spaces in the last
+// column.  memory use does not depend on the amount of answers.
+bool ExportSessionCsv(
+   const std::filesystem::path & path,
+   const SessionSnapshot & snapshot ) noexcept;
+
+// an object with the session header and an array with one object per
+// answer.  memory use does not depend on the amount of answers.
+bool ExportSessionJson(
+   const std::filesystem::path & path,
+   const SessionSnapshot & snapshot ) noexcept;
+
+#endif // _SESSION_EXPORT_HPP_
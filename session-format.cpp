@@ -0,0 +1,465 @@
+#include "session-format.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <system_error>
+
+namespace
+{
+
+constexpr char SESSION_MAGIC[4] { 'M', 'F', 'S', 'B' };
+constexpr size_t SESSION_COLUMNS { 6 };
+constexpr size_t SESSION_HEADER_SIZE { 40 + SESSION_COLUMNS * 4 };
+constexpr size_t MAX_VARINT_SIZE { 10 };
+
+constexpr std::array< uint32_t, 256 > GenerateCrc32Table( ) noexcept
+{
+   std::array< uint32_t, 256 > table { };
+
+   for (uint32_t i { }; i < table.size(); ++i)
+   {
+      uint32_t crc { i };
+
+      for (int32_t bit { }; bit < 8; ++bit)
+      {
+         crc =
+            crc & 1u ?
+               0xEDB88320u ^ (crc >> 1) :
+               crc >> 1;
+      }
+
+      table[i] = crc;
+   }
+
+   return
+      table;
+}
+
+constexpr auto CRC32_TABLE { GenerateCrc32Table() };
+
+void PutFixed(
+   std::vector< uint8_t > & buffer,
+   uint64_t value,
+   const size_t bytes )
+{
+   for (size_t i { }; i < bytes; ++i, value >>= 8)
+   {
+      buffer.push_back(
+         static_cast< uint8_t >(value));
+   }
+}
+
+void PutVarint(
+   std::vector< uint8_t > & buffer,
+   uint64_t value )
+{
+   while (value >= 0x80)
+   {
+      buffer.push_back(
+         static_cast< uint8_t >(value | 0x80));
+
+      value >>= 7;
+   }
+
+   buffer.push_back(
+      static_cast< uint8_t >(value));
+}
+
+uint64_t ZigZag(
+   const int64_t value ) noexcept
+{
+   return
+      (static_cast< uint64_t >(value) << 1) ^
+      static_cast< uint64_t >(value >> 63);
+}
+
+int64_t UnZigZag(
+   const uint64_t value ) noexcept
+{
+   return
+      static_cast< int64_t >(value >> 1) ^
+      -static_cast< int64_t >(value & 1);
+}
+
+uint64_t GetFixed(
+   const uint8_t * const data,
+   const size_t bytes ) noexcept
+{
+   uint64_t value { };
+
+   for (size_t i { }; i < bytes; ++i)
+   {
+      value |= static_cast< uint64_t >(data[i]) << (i * 8);
+   }
+
+   return
+      value;
+}
+
+// reads varints from a column.  while at least MAX_VARINT_SIZE bytes
+// remain no bounds are checked per byte, which keeps the hot loop tight.
+class VarintReader
+{
+public:
+   VarintReader(
+      const uint8_t * const begin,
+      const uint8_t * const end ) noexcept :
+   current_ { begin },
+   end_ { end },
+   valid_ { true }
+   {
+   }
+
+   uint64_t Next( ) noexcept
+   {
+      uint64_t value { };
+
+      if (static_cast< size_t >(end_ - current_) >= MAX_VARINT_SIZE)
+      {
+         for (uint32_t shift { }; shift < 70; shift += 7)
+         {
+            const uint8_t byte = *current_++;
+
+            value |= static_cast< uint64_t >(byte & 0x7F) << shift;
+
+            if (!(byte & 0x80))
+               return value;
+         }
+
+         valid_ = false;
+      }
+      else
+      {
+         for (uint32_t shift { }; shift < 70; shift += 7)
+         {
+            if (current_ == end_)
+               break;
+
+            const uint8_t byte = *current_++;
+
+            value |= static_cast< uint64_t >(byte & 0x7F) << shift;
+
+            if (!(byte & 0x80))
+               return value;
+         }
+
+         valid_ = false;
+      }
+
+      return
+         value;
+   }
+
+   bool Finished( ) const noexcept
+   {
+      return
+         valid_ && current_ == end_;
+   }
+
+private:
+   const uint8_t * current_;
+   const uint8_t * const end_;
+   bool valid_;
+
+};
+
+} // namespace
+
+uint32_t Crc32(
+   const uint8_t * const data,
+   const size_t size,
+   uint32_t crc ) noexcept
+{
+   crc = ~crc;
+
+   for (size_t i { }; i < size; ++i)
+   {
+      crc = CRC32_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+   }
+
+   return
+      ~crc;
+}
+
+std::vector< uint8_t > EncodeSession(
+   const SessionHeader & header,
+   const std::vector< AnswerRecord > & answers )
+{
+   std::array< std::vector< uint8_t >, SESSION_COLUMNS > columns;
+
+   columns[1].reserve(answers.size());
+
+   uint64_t previous_answered_at_ms { };
+   uint32_t attempt_value_count { };
+
+   for (const auto & answer : answers)
+   {
+      PutVarint(
+         columns[0],
+         answer.fact_id);
+
+      columns[1].push_back(
+         static_cast< uint8_t >(answer.operation));
+
+      // answers are recorded in order, but never trust it blindly
+      PutVarint(
+         columns[2],
+         answer.answered_at_ms >= previous_answered_at_ms ?
+            answer.answered_at_ms - previous_answered_at_ms :
+            0);
+
+      previous_answered_at_ms =
+         std::max(
+            previous_answered_at_ms,
+            answer.answered_at_ms);
+
+      PutVarint(
+         columns[3],
+         answer.response_time_ms);
+      PutVarint(
+         columns[4],
+         answer.responses.size());
+
+      for (const auto response : answer.responses)
+      {
+         PutVarint(
+            columns[5],
+            ZigZag(response));
+      }
+
+      attempt_value_count +=
+         static_cast< uint32_t >(answer.responses.size());
+   }
+
+   std::vector< uint8_t > session;
+
+   size_t session_size { SESSION_HEADER_SIZE + 4 };
+
+   for (const auto & column : columns)
+   {
+      session_size += column.size();
+   }
+
+   session.reserve(
+      session_size);
+
+   for (const char magic : SESSION_MAGIC)
+   {
+      session.push_back(
+         static_cast< uint8_t >(magic));
+   }
+
+   PutFixed(session, SESSION_FORMAT_VERSION, 2);
+   PutFixed(session, SESSION_HEADER_SIZE, 2);
+   PutFixed(session, header.session_start_unix_ms, 8);
+   PutFixed(session, header.practice_duration_ms, 4);
+   PutFixed(session, header.minimum_amount_to_practice, 4);
+   PutFixed(session, header.enabled_math_facts, 4);
+   PutFixed(session, header.chosen_problems, 4);
+   PutFixed(session, answers.size(), 4);
+   PutFixed(session, attempt_value_count, 4);
+
+   for (const auto & column : columns)
+   {
+      PutFixed(session, column.size(), 4);
+   }
+
+   for (const auto & column : columns)
+   {
+      session.insert(
+         session.end(),
+         column.begin(),
+         column.end());
+   }
+
+   PutFixed(
+      session,
+      Crc32(session.data(), session.size()),
+      4);
+
+   return
+      session;
+}
+
+bool DecodeSession(
+   const uint8_t * const data,
+   const size_t size,
+   SessionColumns & columns )
+{
+   if (size < SESSION_HEADER_SIZE + 4 ||
+       std::memcmp(data, SESSION_MAGIC, sizeof(SESSION_MAGIC)) != 0 ||
+       GetFixed(data + 4, 2) != SESSION_FORMAT_VERSION)
+   {
+      return false;
+   }
+
+   const size_t header_size = GetFixed(data + 6, 2);
+
+   if (header_size < SESSION_HEADER_SIZE ||
+       header_size > size - 4 ||
+       Crc32(data, size - 4) != GetFixed(data + size - 4, 4))
+   {
+      return false;
+   }
+
+   columns.header.session_start_unix_ms = GetFixed(data + 8, 8);
+   columns.header.practice_duration_ms = static_cast< uint32_t >(GetFixed(data + 16, 4));
+   columns.header.minimum_amount_to_practice = static_cast< uint32_t >(GetFixed(data + 20, 4));
+   columns.header.enabled_math_facts = static_cast< uint32_t >(GetFixed(data + 24, 4));
+   columns.header.chosen_problems = static_cast< uint32_t >(GetFixed(data + 28, 4));
+
+   const size_t answer_count = GetFixed(data + 32, 4);
+   const size_t attempt_value_count = GetFixed(data + 36, 4);
+
+   std::array< const uint8_t *, SESSION_COLUMNS + 1 > column_bounds { };
+
+   column_bounds[0] = data + header_size;
+
+   for (size_t i { }; i < SESSION_COLUMNS; ++i)
+   {
+      const size_t column_size = GetFixed(data + 40 + i * 4, 4);
+
+      if (column_size > static_cast< size_t >(data + size - 4 - column_bounds[i]))
+         return false;
+
+      column_bounds[i + 1] = column_bounds[i] + column_size;
+   }
+
+   // every answer takes at least one byte in each per answer column, and
+   // every attempt value at least one byte in its own
+   if (column_bounds[2] - column_bounds[1] != static_cast< ptrdiff_t >(answer_count) ||
+       static_cast< size_t >(column_bounds[1] - column_bounds[0]) < answer_count ||
+       static_cast< size_t >(column_bounds[6] - column_bounds[5]) < attempt_value_count)
+   {
+      return false;
+   }
+
+   columns.fact_ids.resize(answer_count);
+   columns.operations.assign(column_bounds[1], column_bounds[2]);
+   columns.answered_at_ms.resize(answer_count);
+   columns.response_times_ms.resize(answer_count);
+   columns.attempt_counts.resize(answer_count);
+   columns.attempt_values.resize(attempt_value_count);
+
+   VarintReader fact_ids { column_bounds[0], column_bounds[1] };
+   VarintReader answered_at { column_bounds[2], column_bounds[3] };
+   VarintReader response_times { column_bounds[3], column_bounds[4] };
+   VarintReader attempt_counts { column_bounds[4], column_bounds[5] };
+   VarintReader attempt_values { column_bounds[5], column_bounds[6] };
+
+   uint64_t answered_at_ms { };
+
+   for (size_t i { }; i < answer_count; ++i)
+   {
+      columns.fact_ids[i] = static_cast< uint16_t >(fact_ids.Next());
+   }
+
+   for (size_t i { }; i < answer_count; ++i)
+   {
+      answered_at_ms += answered_at.Next();
+      columns.answered_at_ms[i] = answered_at_ms;
+   }
+
+   for (size_t i { }; i < answer_count; ++i)
+   {
+      columns.response_times_ms[i] = static_cast< uint32_t >(response_times.Next());
+   }
+
+   uint64_t total_attempts { };
+
+   for (size_t i { }; i < answer_count; ++i)
+   {
+      columns.attempt_counts[i] = static_cast< uint32_t >(attempt_counts.Next());
+      total_attempts += columns.attempt_counts[i];
+   }
+
+   for (size_t i { }; i < attempt_value_count; ++i)
+   {
+      columns.attempt_values[i] = static_cast< int32_t >(UnZigZag(attempt_values.Next()));
+   }
+
+   return
+      total_attempts == attempt_value_count &&
+      fact_ids.Finished() &&
+      answered_at.Finished() &&
+      response_times.Finished() &&
+      attempt_counts.Finished() &&
+      attempt_values.Finished();
+}
+
+bool WriteSessionFile(
+   const std::filesystem::path & path,
+   const SessionHeader & header,
+   const std::vector< AnswerRecord > & answers ) noexcept
+{
+   try
+   {
+      const auto session =
+         EncodeSession(
+            header,
+            answers);
+
+      std::ofstream session_file {
+         path,
+         std::ios_base::out | std::ios_base::binary
+      };
+
+      session_file.write(
+         reinterpret_cast< const char * >(session.data()),
+         session.size());
+
+      return
+         session_file.good();
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+bool ReadSessionFile(
+   const std::filesystem::path & path,
+   SessionColumns & columns ) noexcept
+{
+   try
+   {
+      std::ifstream session_file {
+         path,
+         std::ios_base::in | std::ios_base::binary
+      };
+
+      if (!session_file.is_open())
+         return false;
+
+      std::error_code error;
+
+      const auto file_size =
+         std::filesystem::file_size(
+            path,
+            error);
+
+      if (error)
+         return false;
+
+      std::vector< uint8_t > session(
+         file_size);
+
+      session_file.read(
+         reinterpret_cast< char * >(session.data()),
+         session.size());
+
+      return
+         session_file.good() &&
+         DecodeSession(
+            session.data(),
+            session.size(),
+            columns);
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
@@ -0,0 +1,86 @@
+#ifndef _SESSION_FORMAT_HPP_
+#define _SESSION_FORMAT_HPP_
+
+#include "answer-record.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// compact binary session format written next to the text report.
+//
+// all integers are little endian.  the file is a fixed size header, six
+// columns and a trailing crc32 of every byte before it.
+//
+//    header
+//       char[4]  magic "MFSB"
+//       uint16   version
+//       uint16   header size in bytes
+//       uint64   session start, unix time in milliseconds
+//       uint32   practice duration in milliseconds
+//       uint32   minimum amount to practice
+//       uint32   enabled math facts bit pattern
+//       uint32   chosen problems (title button id)
+//       uint32   amount of answers
+//       uint32   amount of attempt values
+//       uint32   byte size of each of the six columns
+//
+//    columns, one value per answer unless noted
+//       fact id           varint
+//       operation         uint8
+//       answered at       varint, delta from the previous answer in ms
+//       response time     varint, ms
+//       attempt count     varint
+//       attempt values    zigzag varint, one per attempt in answer order
+//
+//    uint32   crc32
+struct SessionHeader
+{
+   uint64_t session_start_unix_ms;
+   uint32_t practice_duration_ms;
+   uint32_t minimum_amount_to_practice;
+   uint32_t enabled_math_facts;
+   uint32_t chosen_problems;
+};
+
+// decoded session in structure of arrays form
+struct SessionColumns
+{
+   SessionHeader header;
+
+   std::vector< uint16_t > fact_ids;
+   std::vector< uint8_t > operations;
+   std::vector< uint64_t > answered_at_ms;
+   std::vector< uint32_t > response_times_ms;
+   std::vector< uint32_t > attempt_counts;
+   std::vector< int32_t > attempt_values;
+};
+
+constexpr uint16_t SESSION_FORMAT_VERSION { 1 };
+constexpr const char * SESSION_FORMAT_EXTENSION { ".mfs" };
+
+std::vector< uint8_t > EncodeSession(
+   const SessionHeader & header,
+   const std::vector< AnswerRecord > & answers );
+
+bool DecodeSession(
+   const uint8_t * const data,
+   const size_t size,
+   SessionColumns & columns );
+
+bool WriteSessionFile(
+   const std::filesystem::path & path,
+   const SessionHeader & header,
+   const std::vector< AnswerRecord > & answers ) noexcept;
+
+bool ReadSessionFile(
+   const std::filesystem::path & path,
+   SessionColumns & columns ) noexcept;
+
+uint32_t Crc32(
+   const uint8_t * const data,
+   const size_t size,
+   const uint32_t crc = 0 ) noexcept;
+
+#endif // _SESSION_FORMAT_HPP_
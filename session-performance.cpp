@@ -0,0 +1,280 @@
+#include "session-performance.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+#if _WIN32
+#  define NOMINMAX
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  if __GLIBC__
+#     include <malloc.h>
+#  endif // __GLIBC__
+#  include <sys/resource.h>
+#endif // _WIN32
+
+namespace
+{
+
+uint64_t ToMicroseconds(
+   const std::chrono::steady_clock::duration duration ) noexcept
+{
+   return
+      duration.count() > 0 ?
+         static_cast< uint64_t >(
+            std::chrono::duration_cast<
+               std::chrono::microseconds >(duration).count()) :
+         0;
+}
+
+void PrintHistogram(
+   std::ostream & report,
+   const char * const name,
+   const LatencyHistogram & histogram )
+{
+   report
+      << name
+      << " us; count = "
+      << histogram.Count()
+      << "; p50 = "
+      << histogram.Percentile(50.0)
+      << "; p90 = "
+      << histogram.Percentile(90.0)
+      << "; p99 = "
+      << histogram.Percentile(99.0)
+      << "; max = "
+      << histogram.Max()
+      << "\n";
+}
+
+} // namespace
+
+SessionPerformance::SessionPerformance( ) noexcept :
+tick_interval_ { },
+repaints_ { },
+dropped_ticks_ { },
+peak_pixmap_bytes_ { },
+peak_heap_bytes_ { }
+{
+}
+
+void SessionPerformance::Start(
+   const TimePoint start_time,
+   const std::chrono::milliseconds tick_interval ) noexcept
+{
+   *this = SessionPerformance { };
+
+   start_time_ = start_time;
+   tick_interval_ = tick_interval;
+}
+
+void SessionPerformance::RecordFrame(
+   const TimePoint frame_start_time,
+   const TimePoint frame_end_time ) noexcept
+{
+   ++repaints_;
+
+   frame_time_us_.Record(
+      ToMicroseconds(frame_end_time - frame_start_time));
+
+   if (!first_frame_time_)
+   {
+      first_frame_time_ = frame_end_time;
+   }
+
+   if (pending_input_time_)
+   {
+      input_to_frame_us_.Record(
+         ToMicroseconds(frame_end_time - *pending_input_time_));
+
+      pending_input_time_.reset();
+   }
+}
+
+void SessionPerformance::RecordInput(
+   const TimePoint event_time ) noexcept
+{
+   if (!pending_input_time_)
+   {
+      pending_input_time_ = event_time;
+   }
+}
+
+void SessionPerformance::RecordTick(
+   const TimePoint tick_time ) noexcept
+{
+   if (last_tick_time_ && tick_interval_.count() > 0)
+   {
+      // rounded, so that ordinary timer jitter drops nothing
+      const auto ticks =
+         (tick_time - *last_tick_time_ + tick_interval_ / 2) /
+         tick_interval_;
+
+      if (ticks > 1)
+      {
+         dropped_ticks_ +=
+            static_cast< uint64_t >(ticks - 1);
+      }
+   }
+
+   last_tick_time_ = tick_time;
+}
+
+void SessionPerformance::SkipTicks( ) noexcept
+{
+   last_tick_time_.reset();
+}
+
+void SessionPerformance::SampleMemory(
+   const uint64_t pixmap_bytes ) noexcept
+{
+   peak_pixmap_bytes_ =
+      std::max(
+         peak_pixmap_bytes_,
+         pixmap_bytes);
+   peak_heap_bytes_ =
+      std::max(
+         peak_heap_bytes_,
+         GetHeapBytes());
+}
+
+std::chrono::microseconds SessionPerformance::TimeToFirstFrame( ) const noexcept
+{
+   return
+      std::chrono::microseconds {
+         first_frame_time_ ?
+            ToMicroseconds(*first_frame_time_ - start_time_) :
+            0
+      };
+}
+
+uint64_t GetHeapBytes( ) noexcept
+{
+#if _WIN32
+   PROCESS_MEMORY_COUNTERS_EX counters { };
+
+   // the private bytes, which is where the heaps live
+   if (GetProcessMemoryInfo(
+          GetCurrentProcess(),
+          reinterpret_cast< PROCESS_MEMORY_COUNTERS * >(&counters),
+          sizeof(counters)))
+   {
+      return
+         counters.PrivateUsage;
+   }
+
+   return
+      0;
+#elif __GLIBC__ && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+   // walks the arenas, so it is only sampled now and then
+   const struct mallinfo2 info =
+      mallinfo2();
+
+   return
+      info.uordblks + info.hblkhd;
+#else
+   return
+      0;
+#endif // _WIN32
+}
+
+uint64_t GetPeakResidentBytes( ) noexcept
+{
+#if _WIN32
+   PROCESS_MEMORY_COUNTERS counters { };
+
+   if (GetProcessMemoryInfo(
+          GetCurrentProcess(),
+          &counters,
+          sizeof(counters)))
+   {
+      return
+         counters.PeakWorkingSetSize;
+   }
+
+   return
+      0;
+#else
+   struct rusage usage { };
+
+   if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+
+#if __APPLE__
+   // bytes on macos, kilobytes everywhere else
+   return
+      static_cast< uint64_t >(usage.ru_maxrss);
+#else
+   return
+      static_cast< uint64_t >(usage.ru_maxrss) * 1024;
+#endif // __APPLE__
+#endif // _WIN32
+}
+
+void PrintSessionPerformance(
+   std::ostream & report,
+   const SessionPerformance & performance )
+{
+   report
+      << "repaints = "
+      << performance.Repaints()
+      << "\n";
+
+   report
+      << "time to first frame us = "
+      << performance.TimeToFirstFrame().count()
+      << "\n";
+
+   PrintHistogram(
+      report,
+      "frame time",
+      performance.FrameTimeUs());
+
+   report
+      << "frame time distribution us =";
+
+   const auto & buckets =
+      performance.FrameTimeUs().Buckets();
+
+   for (size_t bucket { }; bucket < buckets.size(); ++bucket)
+   {
+      if (buckets[bucket])
+      {
+         report
+            << " "
+            << LatencyHistogram::BucketHighestValue(bucket)
+            << ":"
+            << buckets[bucket];
+      }
+   }
+
+   report
+      << "\n";
+
+   PrintHistogram(
+      report,
+      "input to frame latency",
+      performance.InputToFrameUs());
+
+   report
+      << "peak pixmap bytes = "
+      << performance.PeakPixmapBytes()
+      << "\n";
+
+   report
+      << "peak heap bytes = "
+      << performance.PeakHeapBytes()
+      << "\n";
+
+   report
+      << "peak resident bytes = "
+      << GetPeakResidentBytes()
+      << "\n";
+
+   report
+      << "dropped timer ticks = "
+      << performance.DroppedTicks()
+      << "\n";
+}
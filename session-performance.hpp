@@ -0,0 +1,82 @@
+#ifndef _SESSION_PERFORMANCE_HPP_
+#define _SESSION_PERFORMANCE_HPP_
+
+#include "latency-histogram.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+
+// how the machine kept up while a session was practiced, so that a slow
+// student can be told apart from a slow computer.  recording never
+// allocates and costs a few additions, so it is always on.
+class SessionPerformance
+{
+public:
+   using TimePoint = std::chrono::steady_clock::time_point;
+
+   SessionPerformance( ) noexcept;
+
+   // starts over; the tick interval is that of the practice timer
+   void Start(
+      const TimePoint start_time,
+      const std::chrono::milliseconds tick_interval ) noexcept;
+
+   // a paint of the practice stage
+   void RecordFrame(
+      const TimePoint frame_start_time,
+      const TimePoint frame_end_time ) noexcept;
+   // a key press, by the time it happened; it is answered by the end of
+   // the next frame
+   void RecordInput(
+      const TimePoint event_time ) noexcept;
+   // a timeout of the practice timer; a late one stands in for the ticks
+   // that were missed
+   void RecordTick(
+      const TimePoint tick_time ) noexcept;
+   // the practice timer was stopped or slowed on purpose; the time until
+   // the next tick is not counted as missed ticks
+   void SkipTicks( ) noexcept;
+   void SampleMemory(
+      const uint64_t pixmap_bytes ) noexcept;
+
+   uint64_t Repaints( ) const noexcept { return repaints_; }
+   // 0 if nothing was painted
+   std::chrono::microseconds TimeToFirstFrame( ) const noexcept;
+   const LatencyHistogram & FrameTimeUs( ) const noexcept { return frame_time_us_; }
+   const LatencyHistogram & InputToFrameUs( ) const noexcept { return input_to_frame_us_; }
+   uint64_t PeakPixmapBytes( ) const noexcept { return peak_pixmap_bytes_; }
+   uint64_t PeakHeapBytes( ) const noexcept { return peak_heap_bytes_; }
+   uint64_t DroppedTicks( ) const noexcept { return dropped_ticks_; }
+
+private:
+   LatencyHistogram frame_time_us_;
+   LatencyHistogram input_to_frame_us_;
+
+   TimePoint start_time_;
+   std::optional< TimePoint > first_frame_time_;
+   // the earliest key press no frame has shown yet
+   std::optional< TimePoint > pending_input_time_;
+
+   std::chrono::milliseconds tick_interval_;
+   std::optional< TimePoint > last_tick_time_;
+
+   uint64_t repaints_;
+   uint64_t dropped_ticks_;
+   uint64_t peak_pixmap_bytes_;
+   uint64_t peak_heap_bytes_;
+};
+
+// heap in use by this process, or 0 where it cannot be told cheaply
+uint64_t GetHeapBytes( ) noexcept;
+// the most memory this process ever had resident
+uint64_t GetPeakResidentBytes( ) noexcept;
+
+// the performance section of a text report: one "key = value" line per
+// measure, with distributions as "highest value:count" pairs
+void PrintSessionPerformance(
+   std::ostream & report,
+   const SessionPerformance & performance );
+
+#endif // _SESSION_PERFORMANCE_HPP_
@@ -0,0 +1,407 @@
+#include "session-report.hpp"
+#include "durable-file.hpp"
+#include "fact-id.hpp"
+#include "session-export.hpp"
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <ios>
+#include <sstream>
+#include <system_error>
+
+#if __has_include(<format>)
+#  include <format>
+#else
+#  include <ctime>
+#  include <time.h>
+#endif // __has_include(<format>)
+
+static void PrintAnswer(
+   std::ostream & report,
+   const AnswerRecord & answer )
+{
+   report
+      << answer.question_with_answer
+      << "; response time ms = "
+      << std::chrono::milliseconds { answer.response_time_ms }
+      << "; think time ms = "
+      << std::chrono::milliseconds { answer.think_time_ms }
+      << "; typing time ms = "
+      << std::chrono::milliseconds { answer.typing_time_ms }
+      << "; ui latency ms = "
+      << std::chrono::milliseconds { answer.ui_latency_ms }
+      << "; responses = ";
+
+   for (const auto response : answer.responses)
+   {
+      if (answer.operation == FactOperation::TIME)
+      {
+         char characters[MAX_TIME_RESPONSE_SIZE] { };
+
+         report.write(
+            characters,
+            DecodeTimeResponse(response, characters));
+      }
+      else
+      {
+         report << response;
+      }
+
+      report << "   ";
+   }
+
+   report << "\n";
+}
+
+std::string FormatReportName(
+   const std::string & username,
+   const std::chrono::system_clock::time_point time )
+{
+#if __has_include(<format>)
+   // may throw but lets assume not
+   const std::string date_time =
+      std::format(
+         "{:%F-%H.%M.%OS}",
+         std::chrono::current_zone()->to_local(
+            time));
+#else
+   const auto sys_time =
+      std::chrono::system_clock::to_time_t(
+         time);
+
+   std::string date_time;
+   date_time.resize(512);
+
+   std::tm local_time;
+
+   // assume no failures for both
+#ifdef _WIN32
+   localtime_s(
+      &local_time,
+      &sys_time);
+#else
+   localtime_r(
+      &sys_time,
+      &local_time);
+#endif // _WIN32
+
+   const size_t bytes_written =
+      std::strftime(
+         date_time.data(),
+         date_time.size(),
+         "%F-%H.%M.%S",
+         &local_time);
+
+   date_time.resize(
+      bytes_written);
+#endif // __has_include(<format>)
+
+   return
+      username +
+      "-" +
+      date_time;
+}
+
+std::string FormatSessionReport(
+   const SessionSnapshot & snapshot )
+{
+   const auto & statistics =
+      snapshot.statistics;
+
+   std::ostringstream report;
+
+   report
+      << "duration = "
+      << std::chrono::milliseconds { snapshot.header.practice_duration_ms }
+      << "\n";
+
+   report
+      << "total problems answered = "
+      << statistics.Count()
+      << "\n";
+
+   report
+      << "average response time = "
+      << statistics.MeanResponseTime()
+      << "\n";
+
+   report
+      << "standard deviation response time = "
+      << statistics.StandardDeviationResponseTime()
+      << "\n";
+
+   report
+      << "average think time = "
+      << statistics.MeanThinkTime()
+      << "\n";
+
+   report
+      << "average typing time = "
+      << statistics.MeanTypingTime()
+      << "\n";
+
+   report
+      << "average ui latency = "
+      << statistics.MeanUiLatency()
+      << "\n";
+
+   report
+      << "percentage correct = "
+      << statistics.PercentageCorrect()
+      << "\n";
+
+   report
+      << "\nresponse time percentiles\n";
+
+   for (size_t operation { }; operation < FACT_OPERATION_COUNT; ++operation)
+   {
+      const auto & histogram =
+         statistics.ResponseTimeHistogram(
+            static_cast< FactOperation >(operation));
+
+      if (histogram.Count())
+      {
+         report
+            << FactOperationName(static_cast< FactOperation >(operation))
+            << "; count = "
+            << histogram.Count()
+            << "; p50 ms = "
+            << histogram.Percentile(50.0)
+            << "; p90 ms = "
+            << histogram.Percentile(90.0)
+            << "; p99 ms = "
+            << histogram.Percentile(99.0)
+            << "\n";
+      }
+   }
+
+   report
+      << "\ntop ten most responses\n";
+
+   for (const auto index : statistics.MostResponses())
+   {
+      PrintAnswer(
+         report,
+         snapshot.answers[index]);
+   }
+
+   report
+      << "\ntop ten longest responses\n";
+
+   for (const auto index : statistics.LongestResponses())
+   {
+      PrintAnswer(
+         report,
+         snapshot.answers[index]);
+   }
+
+   report
+      << "\nall answers\n";
+
+   for (const auto & answer : snapshot.answers)
+   {
+      PrintAnswer(
+         report,
+         answer);
+   }
+
+   // last, and after a blank line, so that readers of the answers stop
+   // before it
+   report
+      << "\nperformance\n";
+
+   PrintSessionPerformance(
+      report,
+      snapshot.performance);
+
+   return
+      std::move(report).str();
+}
+
+bool WriteFileAtomically(
+   const std::filesystem::path & path,
+   const void * const data,
+   const size_t size ) noexcept
+{
+   try
+   {
+      auto temporary_path = path;
+      temporary_path += ".tmp";
+
+      {
+         std::ofstream file {
+            temporary_path,
+            std::ios_base::out | std::ios_base::binary | std::ios_base::trunc
+         };
+
+         if (!file.is_open())
+            return false;
+
+         file.write(
+            static_cast< const char * >(data),
+            size);
+
+         if (!file.flush())
+         {
+            file.close();
+
+            std::error_code remove_error { };
+
+            std::filesystem::remove(
+               temporary_path,
+               remove_error);
+
+            return false;
+         }
+      }
+
+      return
+         CommitTemporaryFile(
+            temporary_path,
+            path);
+   }
+   catch (...)
+   {
+      return false;
+   }
+}
+
+SessionReportResult WriteSessionReport(
+   const SessionSnapshot & snapshot ) noexcept
+{
+   SessionReportResult result { };
+
+   try
+   {
+      const auto & report_directory =
+         snapshot.reports_directory;
+
+      if (std::filesystem::exists(report_directory) &&
+          !std::filesystem::is_directory(report_directory))
+      {
+         result.error_message =
+            "Cannot write to report directory.  The directory '" +
+            report_directory.string() +
+            "' already exists and is not a directory.";
+
+         return result;
+      }
+
+      if (!std::filesystem::exists(report_directory))
+      {
+         std::error_code create_dir_error { };
+
+         if (!std::filesystem::create_directories(
+                report_directory,
+                create_dir_error))
+         {
+            result.error_message =
+               "Cannot write to report directory.  The directory '" +
+               report_directory.string() +
+               "' could not be created (EC: " +
+               create_dir_error.message() +
+               ").";
+
+            return result;
+         }
+      }
+
+      const std::string report_name =
+         FormatReportName(
+            snapshot.username,
+            snapshot.end_time);
+
+      result.report_path =
+         report_directory /
+         (report_name +
+          ".txt");
+
+      const auto session_path =
+         report_directory /
+         (report_name +
+          SESSION_FORMAT_EXTENSION);
+
+      const std::string report =
+         FormatSessionReport(
+            snapshot);
+
+      if (!WriteFileAtomically(
+             result.report_path,
+             report.data(),
+             report.size()))
+      {
+         result.error_message =
+            "Cannot write to report file.  The file '" +
+            result.report_path.string() +
+            "' could not be written.";
+
+         return result;
+      }
+
+      const auto session =
+         EncodeSession(
+            snapshot.header,
+            snapshot.answers);
+
+      if (!WriteFileAtomically(
+             session_path,
+             session.data(),
+             session.size()))
+      {
+         result.error_message =
+            "Cannot write to session file.  The file '" +
+            session_path.string() +
+            "' could not be written.";
+
+         return result;
+      }
+
+      const auto export_path =
+         [ & ] (
+            const char * const extension )
+         {
+            return
+               report_directory /
+               (report_name +
+                extension);
+         };
+
+      const bool exported =
+         (!(snapshot.export_formats & ExportFormatBits::CSV) ||
+          ExportSessionCsv(export_path(".csv"), snapshot)) &&
+         (!(snapshot.export_formats & ExportFormatBits::JSON) ||
+          ExportSessionJson(export_path(".json"), snapshot));
+
+      if (!exported)
+      {
+         result.error_message =
+            "Cannot write the session exports for '" +
+            result.report_path.string() +
+            "'.";
+
+         return result;
+      }
+
+      // the session file holds everything the journal did
+      if (!snapshot.journal_path.empty())
+      {
+         std::error_code remove_error { };
+
+         std::filesystem::remove(
+            snapshot.journal_path,
+            remove_error);
+      }
+
+      result.written = true;
+   }
+   catch (const std::exception & exception)
+   {
+      result.error_message =
+         std::string { "Cannot write the report: " } +
+         exception.what();
+   }
+
+   return
+      result;
+}
@@ -0,0 +1,61 @@
+#ifndef _SESSION_REPORT_HPP_
+#define _SESSION_REPORT_HPP_
+
+#include "answer-record.hpp"
+#include "session-format.hpp"
+#include "session-performance.hpp"
+#include "session-statistics.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+// everything needed to write the reports of a finished session.  once
+// created it is never modified, so it can be handed to another thread.
+struct SessionSnapshot
+{
+   std::string username;
+   std::chrono::system_clock::time_point end_time;
+
+   std::filesystem::path reports_directory;
+   std::filesystem::path journal_path;
+
+   SessionHeader header;
+   // ExportFormatBits of the exports written next to the report
+   uint32_t export_formats;
+   SessionStatistics statistics;
+   std::vector< AnswerRecord > answers;
+   SessionPerformance performance;
+};
+
+struct SessionReportResult
+{
+   bool written;
+   std::filesystem::path report_path;
+   std::string error_message;
+};
+
+std::string FormatReportName(
+   const std::string & username,
+   const std::chrono::system_clock::time_point time );
+
+// the human readable report
+std::string FormatSessionReport(
+   const SessionSnapshot & snapshot );
+
+// writes the text report, binary session file and requested exports.  each file is written
+// with a single write into a temporary file that is synced to disk and
+// then renamed over the destination, so neither readers nor a power cut
+// ever leave a partial report.
+SessionReportResult WriteSessionReport(
+   const SessionSnapshot & snapshot ) noexcept;
+
+bool WriteFileAtomically(
+   const std::filesystem::path & path,
+   const void * const data,
+   const size_t size ) noexcept;
+
+#endif // _SESSION_REPORT_HPP_
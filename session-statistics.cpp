@@ -0,0 +1,128 @@
+#include "session-statistics.hpp"
+
+#include <cmath>
+
+template < typename Duration >
+static double ToMilliseconds(
+   const Duration duration ) noexcept
+{
+   return
+      std::chrono::duration_cast<
+         std::chrono::duration< double, std::milli > >(
+            duration).count();
+}
+
+static std::chrono::milliseconds FromMilliseconds(
+   const double milliseconds ) noexcept
+{
+   return
+      std::chrono::milliseconds {
+         static_cast< std::chrono::milliseconds::rep >(
+            std::llround(milliseconds))
+      };
+}
+
+void SessionStatistics::Add(
+   const Answer & answer ) noexcept
+{
+   const size_t index { count_++ };
+
+   if (answer.number_of_responses == 1)
+   {
+      ++correct_on_first_response_;
+   }
+
+   response_time_.Add(
+      ToMilliseconds(answer.response_time));
+   think_time_.Add(
+      ToMilliseconds(answer.think_time));
+   typing_time_.Add(
+      ToMilliseconds(answer.typing_time));
+   ui_latency_.Add(
+      ToMilliseconds(answer.ui_latency));
+
+   const uint64_t response_time_ms =
+      std::chrono::duration_cast<
+         std::chrono::milliseconds >(
+            answer.response_time).count();
+
+   response_time_histograms_[static_cast< size_t >(answer.operation)].Record(
+      response_time_ms);
+
+   most_responses_.Offer(
+      answer.number_of_responses,
+      index);
+   longest_responses_.Offer(
+      std::chrono::duration_cast<
+         std::chrono::nanoseconds >(
+            answer.response_time).count(),
+      index);
+}
+
+size_t SessionStatistics::Count( ) const noexcept
+{
+   return
+      count_;
+}
+
+double SessionStatistics::PercentageCorrect( ) const noexcept
+{
+   return
+      count_ ?
+         static_cast< double >(correct_on_first_response_) / count_ :
+         0.0;
+}
+
+std::chrono::milliseconds SessionStatistics::MeanResponseTime( ) const noexcept
+{
+   return
+      FromMilliseconds(
+         response_time_.Mean());
+}
+
+std::chrono::milliseconds SessionStatistics::StandardDeviationResponseTime( ) const noexcept
+{
+   return
+      FromMilliseconds(
+         std::sqrt(response_time_.SampleVariance()));
+}
+
+std::chrono::milliseconds SessionStatistics::MeanThinkTime( ) const noexcept
+{
+   return
+      FromMilliseconds(
+         think_time_.Mean());
+}
+
+std::chrono::milliseconds SessionStatistics::MeanTypingTime( ) const noexcept
+{
+   return
+      FromMilliseconds(
+         typing_time_.Mean());
+}
+
+std::chrono::milliseconds SessionStatistics::MeanUiLatency( ) const noexcept
+{
+   return
+      FromMilliseconds(
+         ui_latency_.Mean());
+}
+
+const LatencyHistogram & SessionStatistics::ResponseTimeHistogram(
+   const FactOperation operation ) const noexcept
+{
+   return
+      response_time_histograms_[static_cast< size_t >(operation)];
+}
+
+std::vector< size_t > SessionStatistics::MostResponses( ) const noexcept
+{
+   return
+      most_responses_.Sorted();
+}
+
+std::vector< size_t > SessionStatistics::LongestResponses( ) const noexcept
+{
+   return
+      longest_responses_.Sorted();
+}
@@ -0,0 +1,209 @@
+#ifndef _SESSION_STATISTICS_HPP_
+#define _SESSION_STATISTICS_HPP_
+
+#include "fact-operation.hpp"
+#include "latency-histogram.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// welford's online mean and variance
+class RunningStatistics
+{
+public:
+   RunningStatistics( ) noexcept = default;
+
+   // restores statistics saved through Count, Mean and SumOfSquares
+   RunningStatistics(
+      const uint64_t count,
+      const double mean,
+      const double sum_of_squares ) noexcept :
+   count_ { count },
+   mean_ { mean },
+   m2_ { sum_of_squares }
+   {
+   }
+
+   void Add(
+      const double value ) noexcept
+   {
+      ++count_;
+
+      const double delta = value - mean_;
+      mean_ += delta / count_;
+      m2_ += delta * (value - mean_);
+   }
+
+   // chan's parallel combination of two sets of values
+   void Merge(
+      const RunningStatistics & statistics ) noexcept
+   {
+      if (!statistics.count_)
+         return;
+
+      const uint64_t count = count_ + statistics.count_;
+      const double delta = statistics.mean_ - mean_;
+
+      mean_ += delta * statistics.count_ / count;
+      m2_ +=
+         statistics.m2_ +
+         delta * delta * count_ * statistics.count_ / count;
+      count_ = count;
+   }
+
+   uint64_t Count( ) const noexcept { return count_; }
+   double Mean( ) const noexcept { return mean_; }
+   // of the differences from the mean
+   double SumOfSquares( ) const noexcept { return m2_; }
+
+   double SampleVariance( ) const noexcept
+   {
+      return
+         count_ > 1 ?
+            m2_ / (count_ - 1.0) :
+            0.0;
+   }
+
+private:
+   uint64_t count_ { };
+   double mean_ { };
+   double m2_ { };
+
+};
+
+// keeps the N largest keys seen along with the index of their answer.
+// ties keep the earliest answer.
+template < size_t N >
+class BoundedTopN
+{
+public:
+   using Entry = std::pair< uint64_t, size_t >;
+
+   void Offer(
+      const uint64_t key,
+      const size_t index ) noexcept
+   {
+      if (size_ < N)
+      {
+         entries_[size_++] = { key, index };
+
+         std::push_heap(
+            entries_.begin(),
+            entries_.begin() + size_,
+            IsBetter);
+      }
+      else if (N != 0 && IsBetter(Entry { key, index }, entries_.front()))
+      {
+         std::pop_heap(
+            entries_.begin(),
+            entries_.begin() + size_,
+            IsBetter);
+
+         entries_[size_ - 1] = { key, index };
+
+         std::push_heap(
+            entries_.begin(),
+            entries_.begin() + size_,
+            IsBetter);
+      }
+   }
+
+   // answer indices, best first
+   std::vector< size_t > Sorted( ) const noexcept
+   {
+      std::array< Entry, N > sorted { entries_ };
+
+      std::sort(
+         sorted.begin(),
+         sorted.begin() + size_,
+         IsBetter);
+
+      std::vector< size_t > indices;
+      indices.reserve(size_);
+
+      for (size_t i { }; i < size_; ++i)
+      {
+         indices.push_back(
+            sorted[i].second);
+      }
+
+      return
+         indices;
+   }
+
+private:
+   // the heap keeps the worst entry on top
+   static bool IsBetter(
+      const Entry & l,
+      const Entry & r ) noexcept
+   {
+      return
+         l.first != r.first ?
+            l.first > r.first :
+            l.second < r.second;
+   }
+
+   std::array< Entry, N > entries_ { };
+   size_t size_ { };
+
+};
+
+// session statistics maintained as problems are answered, so that
+// finalizing the report does not depend on the length of the session
+class SessionStatistics
+{
+public:
+   static constexpr size_t TOP_ANSWERS { 10 };
+
+   struct Answer
+   {
+      FactOperation operation;
+      std::chrono::steady_clock::duration response_time;
+      std::chrono::steady_clock::duration think_time;
+      std::chrono::steady_clock::duration typing_time;
+      std::chrono::steady_clock::duration ui_latency;
+      size_t number_of_responses;
+   };
+
+   // the answer is assigned the index Count() had before the call
+   void Add(
+      const Answer & answer ) noexcept;
+
+   size_t Count( ) const noexcept;
+   double PercentageCorrect( ) const noexcept;
+
+   std::chrono::milliseconds MeanResponseTime( ) const noexcept;
+   std::chrono::milliseconds StandardDeviationResponseTime( ) const noexcept;
+   std::chrono::milliseconds MeanThinkTime( ) const noexcept;
+   std::chrono::milliseconds MeanTypingTime( ) const noexcept;
+   std::chrono::milliseconds MeanUiLatency( ) const noexcept;
+
+   // response times in milliseconds
+   const LatencyHistogram & ResponseTimeHistogram(
+      const FactOperation operation ) const noexcept;
+
+   std::vector< size_t > MostResponses( ) const noexcept;
+   std::vector< size_t > LongestResponses( ) const noexcept;
+
+private:
+   size_t count_ { };
+   size_t correct_on_first_response_ { };
+
+   RunningStatistics response_time_;
+   RunningStatistics think_time_;
+   RunningStatistics typing_time_;
+   RunningStatistics ui_latency_;
+
+   std::array< LatencyHistogram, FACT_OPERATION_COUNT > response_time_histograms_;
+
+   BoundedTopN< TOP_ANSWERS > most_responses_;
+   BoundedTopN< TOP_ANSWERS > longest_responses_;
+
+};
+
+#endif // _SESSION_STATISTICS_HPP_
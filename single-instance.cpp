@@ -0,0 +1,198 @@
+#include "single-instance.hpp"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QObject>
+#include <QtCore/QThread>
+#include <QtNetwork/QAbstractSocket>
+#include <QtNetwork/QLocalSocket>
+
+#include <chrono>
+#include <utility>
+
+#if _WIN32
+#  define NOMINMAX
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#endif // _WIN32
+
+namespace
+{
+
+// both ends are the same binary, but the version is pinned anyway
+constexpr QDataStream::Version STREAM_VERSION { QDataStream::Version::Qt_5_15 };
+
+} // namespace
+
+SingleInstance::SingleInstance(
+   const QString & name ) noexcept :
+name_ { name },
+lock_ { QDir::tempPath() + "/" + name + ".lock" }
+{
+   // the lock is held for as long as the instance runs, so it is only
+   // stale once its process is gone, never because of its age
+   lock_.setStaleLockTime(
+      0);
+
+   QObject::connect(
+      &server_,
+      &QLocalServer::newConnection,
+      &server_,
+      [ this ] ( )
+      {
+         OnNewConnection();
+      });
+}
+
+bool SingleInstance::HandOff(
+   const QStringList & arguments ) noexcept
+{
+   const auto deadline =
+      std::chrono::steady_clock::now() +
+      START_TIMEOUT;
+
+   // a launch that gets the lock is the first, or follows an instance
+   // that did not shut down cleanly
+   while (!lock_.tryLock(0))
+   {
+      if (SendArguments(arguments))
+         return true;
+
+      // without a usable lock file, only a listening instance counts
+      if (lock_.error() != QLockFile::LockError::LockFailedError)
+         return false;
+
+      // the running instance may be starting up and not listen yet
+      if (std::chrono::steady_clock::now() >= deadline)
+         return false;
+
+      QThread::msleep(
+         50);
+   }
+
+   return
+      false;
+}
+
+bool SingleInstance::SendArguments(
+   const QStringList & arguments ) noexcept
+{
+   QLocalSocket socket;
+
+   socket.connectToServer(
+      name_);
+
+   if (!socket.waitForConnected(static_cast< int >(TIMEOUT.count())))
+      return false;
+
+#if _WIN32
+   // only the process the user just started may bring a window to the
+   // front, so it passes that right on to the running instance
+   AllowSetForegroundWindow(
+      ASFW_ANY);
+#endif // _WIN32
+
+   QDataStream stream {
+      &socket
+   };
+
+   stream.setVersion(
+      STREAM_VERSION);
+
+   stream << arguments;
+
+   while (socket.bytesToWrite() > 0)
+   {
+      if (!socket.waitForBytesWritten(static_cast< int >(TIMEOUT.count())))
+         return false;
+   }
+
+   socket.disconnectFromServer();
+
+   if (socket.state() != QLocalSocket::LocalSocketState::UnconnectedState)
+   {
+      socket.waitForDisconnected(
+         static_cast< int >(TIMEOUT.count()));
+   }
+
+   return
+      true;
+}
+
+bool SingleInstance::Listen(
+   LaunchCallback callback ) noexcept
+{
+   // another instance runs, or started while this one did
+   if (!lock_.isLocked() &&
+       lock_.error() == QLockFile::LockError::LockFailedError)
+   {
+      return false;
+   }
+
+   launch_callback_ =
+      std::move(callback);
+
+   // other users of the same machine run their own instance
+   server_.setSocketOptions(
+      QLocalServer::SocketOption::UserAccessOption);
+
+   if (server_.listen(name_))
+      return true;
+
+   // only the lock proves that the name was left behind by an instance
+   // that is gone, rather than taken by one that just started
+   if (!lock_.isLocked() ||
+       server_.serverError() != QAbstractSocket::SocketError::AddressInUseError)
+   {
+      return false;
+   }
+
+   QLocalServer::removeServer(
+      name_);
+
+   return
+      server_.listen(
+         name_);
+}
+
+void SingleInstance::OnNewConnection( ) noexcept
+{
+   while (QLocalSocket * const socket = server_.nextPendingConnection())
+   {
+      QObject::connect(
+         socket,
+         &QLocalSocket::disconnected,
+         socket,
+         &QObject::deleteLater);
+
+      QObject::connect(
+         socket,
+         &QLocalSocket::readyRead,
+         socket,
+         [ this, socket ] ( )
+         {
+            QDataStream stream {
+               socket
+            };
+
+            stream.setVersion(
+               STREAM_VERSION);
+
+            // the arguments may arrive in more than one piece
+            stream.startTransaction();
+
+            QStringList arguments;
+
+            stream >> arguments;
+
+            if (!stream.commitTransaction())
+               return;
+
+            if (launch_callback_)
+            {
+               launch_callback_(
+                  arguments);
+            }
+         });
+   }
+}
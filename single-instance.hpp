@@ -0,0 +1,60 @@
+#ifndef _SINGLE_INSTANCE_HPP_
+#define _SINGLE_INSTANCE_HPP_
+
+#include <QtCore/QLockFile>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtNetwork/QLocalServer>
+
+#include <chrono>
+#include <functional>
+
+// one practice process per user.  the first process holds a lock file and
+// listens on a local socket, both named after the user; a later launch
+// hands its arguments to it and exits instead of starting a second
+// application.
+class SingleInstance
+{
+public:
+   using LaunchCallback =
+      std::function< void (
+         const QStringList & arguments ) >;
+
+   static constexpr std::chrono::milliseconds TIMEOUT { 1000 };
+   // how long a launch waits for a running instance that is still
+   // starting up to listen
+   static constexpr std::chrono::milliseconds START_TIMEOUT { 5000 };
+
+   explicit SingleInstance(
+      const QString & name ) noexcept;
+
+   SingleInstance(
+      const SingleInstance & ) = delete;
+   SingleInstance & operator = (
+      const SingleInstance & ) = delete;
+
+   // true if a running instance took the arguments.  false once this
+   // launch holds the lock, or if the running instance never listened.
+   bool HandOff(
+      const QStringList & arguments ) noexcept;
+
+   // makes this the running instance; fails unless the lock is held.  the
+   // callback is called on the gui thread with the arguments of every
+   // later launch.
+   bool Listen(
+      LaunchCallback callback ) noexcept;
+
+private:
+   bool SendArguments(
+      const QStringList & arguments ) noexcept;
+   void OnNewConnection( ) noexcept;
+
+   QString name_;
+   // held by the running instance for as long as it runs
+   QLockFile lock_;
+   QLocalServer server_;
+   LaunchCallback launch_callback_;
+
+};
+
+#endif // _SINGLE_INSTANCE_HPP_
@@ -0,0 +1,102 @@
+#ifndef _SPSC_RING_HPP_
+#define _SPSC_RING_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+// bounded single producer / single consumer queue.  neither side ever
+// blocks or allocates; a full ring rejects the push and an empty ring
+// rejects the pop.
+template < typename T, size_t CAPACITY >
+class SpscRing
+{
+   static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                 "capacity must be a power of two");
+   static_assert(std::is_trivially_copyable_v< T >);
+
+public:
+   // producer side
+   bool TryPush(
+      const T & value ) noexcept
+   {
+      const size_t tail =
+         tail_.load(std::memory_order_relaxed);
+
+      if (tail - cached_head_ == CAPACITY)
+      {
+         cached_head_ =
+            head_.load(std::memory_order_acquire);
+
+         if (tail - cached_head_ == CAPACITY)
+            return false;
+      }
+
+      slots_[tail & (CAPACITY - 1)] = value;
+
+      tail_.store(
+         tail + 1,
+         std::memory_order_release);
+
+      return true;
+   }
+
+   // consumer side
+   std::optional< T > TryPop( ) noexcept
+   {
+      const size_t head =
+         head_.load(std::memory_order_relaxed);
+
+      if (head == cached_tail_)
+      {
+         cached_tail_ =
+            tail_.load(std::memory_order_acquire);
+
+         if (head == cached_tail_)
+            return std::nullopt;
+      }
+
+      const T value =
+         slots_[head & (CAPACITY - 1)];
+
+      head_.store(
+         head + 1,
+         std::memory_order_release);
+
+      return
+         value;
+   }
+
+   // approximate when called from either side
+   size_t Size( ) const noexcept
+   {
+      return
+         tail_.load(std::memory_order_acquire) -
+         head_.load(std::memory_order_acquire);
+   }
+
+   static constexpr size_t Capacity( ) noexcept
+   {
+      return
+         CAPACITY;
+   }
+
+private:
+   static constexpr size_t CACHE_LINE { 64 };
+
+   // producer owned
+   alignas(CACHE_LINE) std::atomic< size_t > tail_ { };
+   size_t cached_head_ { };
+
+   // consumer owned
+   alignas(CACHE_LINE) std::atomic< size_t > head_ { };
+   size_t cached_tail_ { };
+
+   alignas(CACHE_LINE) std::array< T, CAPACITY > slots_ { };
+
+};
+
+#endif // _SPSC_RING_HPP_
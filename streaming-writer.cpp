@@ -0,0 +1,121 @@
+#include "streaming-writer.hpp"
+#include "durable-file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ios>
+#include <system_error>
+
+StreamingWriter::StreamingWriter(
+   const std::filesystem::path & path ) noexcept :
+path_ { path },
+size_ { },
+finished_ { }
+{
+   try
+   {
+      temporary_path_ = path_;
+      temporary_path_ += ".tmp";
+
+      buffer_ = std::make_unique< char [] >(BUFFER_SIZE);
+
+      // the stream's own buffer would only add a copy
+      file_.rdbuf()->pubsetbuf(
+         nullptr,
+         0);
+
+      file_.open(
+         temporary_path_,
+         std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+   }
+   catch (...)
+   {
+      buffer_.reset();
+   }
+}
+
+StreamingWriter::~StreamingWriter( ) noexcept
+{
+   if (!finished_ && file_.is_open())
+   {
+      file_.close();
+
+      std::error_code remove_error;
+
+      std::filesystem::remove(
+         temporary_path_,
+         remove_error);
+   }
+}
+
+bool StreamingWriter::IsOpen( ) const noexcept
+{
+   return
+      buffer_ &&
+      file_.is_open();
+}
+
+void StreamingWriter::Append(
+   std::string_view text ) noexcept
+{
+   while (!text.empty())
+   {
+      if (size_ == BUFFER_SIZE)
+      {
+         Flush();
+      }
+
+      const size_t count =
+         std::min(
+            text.size(),
+            BUFFER_SIZE - size_);
+
+      std::memcpy(
+         buffer_.get() + size_,
+         text.data(),
+         count);
+
+      size_ += count;
+      text.remove_prefix(count);
+   }
+}
+
+bool StreamingWriter::Finish( ) noexcept
+{
+   if (!IsOpen() || finished_)
+      return false;
+
+   Flush();
+
+   file_.close();
+
+   finished_ = true;
+
+   if (!file_)
+   {
+      std::error_code remove_error;
+
+      std::filesystem::remove(
+         temporary_path_,
+         remove_error);
+
+      return false;
+   }
+
+   return
+      CommitTemporaryFile(
+         temporary_path_,
+         path_);
+}
+
+void StreamingWriter::Flush( ) noexcept
+{
+   if (size_ && file_.is_open())
+   {
+      file_.write(
+         buffer_.get(),
+         size_);
+   }
+
+   size_ = 0;
+}
@@ -0,0 +1,87 @@
+#ifndef _STREAMING_WRITER_HPP_
+#define _STREAMING_WRITER_HPP_
+
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+// writes a file through one fixed buffer that is handed to the operating
+// system in large chunks.  numbers are formatted with std::to_chars
+// straight into the buffer, so nothing is allocated per value.  the file
+// is written under a temporary name and renamed into place by Finish.
+class StreamingWriter
+{
+public:
+   static constexpr size_t BUFFER_SIZE { 1 << 16 };
+
+   StreamingWriter(
+      const std::filesystem::path & path ) noexcept;
+   // a writer that was not finished removes its temporary file
+   ~StreamingWriter( ) noexcept;
+
+   StreamingWriter(
+      const StreamingWriter & ) = delete;
+   StreamingWriter & operator = (
+      const StreamingWriter & ) = delete;
+
+   bool IsOpen( ) const noexcept;
+
+   void Append(
+      const char c ) noexcept
+   {
+      if (size_ == BUFFER_SIZE)
+      {
+         Flush();
+      }
+
+      buffer_[size_++] = c;
+   }
+
+   void Append(
+      const std::string_view text ) noexcept;
+
+   template < typename T >
+   void AppendNumber(
+      const T value ) noexcept
+   {
+      static_assert(std::is_arithmetic_v< T >);
+
+      // enough for any integer or shortest round trip double
+      constexpr size_t MAX_NUMBER_SIZE { 32 };
+
+      if (BUFFER_SIZE - size_ < MAX_NUMBER_SIZE)
+      {
+         Flush();
+      }
+
+      const auto result =
+         std::to_chars(
+            buffer_.get() + size_,
+            buffer_.get() + BUFFER_SIZE,
+            value);
+
+      size_ = result.ptr - buffer_.get();
+   }
+
+   // flushes, closes, syncs and renames the file into place
+   bool Finish( ) noexcept;
+
+private:
+   void Flush( ) noexcept;
+
+   std::filesystem::path path_;
+   std::filesystem::path temporary_path_;
+   std::ofstream file_;
+
+   std::unique_ptr< char [] > buffer_;
+   size_t size_;
+
+   bool finished_;
+
+};
+
+#endif // _STREAMING_WRITER_HPP_
@@ -1,11 +1,11 @@
 #include "time-problem.hpp"
+#include "fact-id.hpp"
+#include "fact-table.hpp"
 
 #include <QtCore/QRect>
 #include <QtCore/QRectF>
 #include <QtCore/QSize>
-#include <QtCore/QStringView>
 #include <QtCore/Qt>
-#include <QtCore/QTime>
 #include <QtGui/QColor>
 #include <QtGui/QFont>
 #include <QtGui/QKeyEvent>
@@ -79,28 +79,6 @@ static auto GetHourAndMinute(
          problem);
 }
 
-static bool GradeResponse(
-   const std::variant< TimeProblem::Time, TimeProblem::MilitaryTime > & problem,
-   const QString & response ) noexcept
-{
-   return
-      std::visit(
-         [ & ] (
-            auto && argument )
-         {
-            using T = std::decay_t< decltype(argument) >;
-
-            if constexpr (std::is_same_v< T, TimeProblem::Time > ||
-                          std::is_same_v< T, TimeProblem::MilitaryTime >)
-               return
-                  argument.GradeResponse(
-                     response);
-            else
-               static_assert(false);
-         },
-         problem);
-}
-
 TimeProblem::Time::Time(
    const uint8_t hour,
    const uint8_t minute ) noexcept :
@@ -109,18 +87,12 @@ minute_ { static_cast< uint8_t >((minute % 60) / 5 * 5) }
 {
 }
 
-bool TimeProblem::Time::GradeResponse(
-   const QString & response ) const noexcept
-{
-   return
-      response == Answer();
-}
-
 QString TimeProblem::Time::Answer( ) const noexcept
 {
    return
-      QTime { hour_, minute_ }.toString(
-         QStringView { L"h:mm", 4 });
+      QString::fromStdString(
+         GetTimeAnswer(
+            TimeFactId(TimeFactKind::CLOCK, hour_, minute_)));
 }
 
 std::pair< QString, QSize > TimeProblem::Time::Question( ) const noexcept
@@ -141,28 +113,17 @@ is_afternoon_ { is_afternoon }
 {
 }
 
-bool TimeProblem::MilitaryTime::GradeResponse(
-   const QString & response ) const noexcept
-{
-   return
-      response == Answer();
-}
-
 QString TimeProblem::MilitaryTime::Answer( ) const noexcept
 {
-   const uint8_t hour =
+   const TimeFactKind kind =
       is_afternoon_ ?
-         hour_ == 12 ?
-            hour_ :
-            hour_ + 12
-         :
-         hour_ != 12 ?
-            hour_ :
-            0u;
+         TimeFactKind::MILITARY_AFTERNOON :
+         TimeFactKind::MILITARY_MORNING;
 
    return
-      QTime { hour, minute_ }.toString(
-         QStringView { L"hh:mm", 5 });
+      QString::fromStdString(
+         GetTimeAnswer(
+            TimeFactId(kind, hour_, minute_)));
 }
 
 std::pair< QString, QSize > TimeProblem::MilitaryTime::Question( ) const noexcept
@@ -173,16 +134,45 @@ std::pair< QString, QSize > TimeProblem::MilitaryTime::Question( ) const noexcep
    };
 }
 
+QVector< QString > TimeProblem::GetImageResourceIds( ) noexcept
+{
+   return {
+      ":/clock-face-image",
+      ":/clock-hour-hand-image",
+      ":/clock-minute-hand-image",
+      ":/clock-center-post-image",
+      ":/morning-afternoon-scene-image",
+      ":/morning-sun-image",
+      ":/afternoon-sun-image"
+   };
+}
+
 TimeProblem::TimeProblem(
    Time time ) noexcept :
-problem_ { std::move(time) }
+problem_ { std::move(time) },
+fact_id_ {
+   TimeFactId(
+      TimeFactKind::CLOCK,
+      std::get< Time >(problem_).Hour(),
+      std::get< Time >(problem_).Minute()) }
 {
+   response_.reserve(
+      MAX_RESPONSE_LENGTH);
 }
 
 TimeProblem::TimeProblem(
    MilitaryTime time ) noexcept :
-problem_ { std::move(time) }
+problem_ { std::move(time) },
+fact_id_ {
+   TimeFactId(
+      std::get< MilitaryTime >(problem_).IsAfternoon() ?
+         TimeFactKind::MILITARY_AFTERNOON :
+         TimeFactKind::MILITARY_MORNING,
+      std::get< MilitaryTime >(problem_).Hour(),
+      std::get< MilitaryTime >(problem_).Minute()) }
 {
+   response_.reserve(
+      MAX_RESPONSE_LENGTH);
 }
 
 TimeProblem::~TimeProblem( ) noexcept
@@ -209,8 +199,39 @@ size_t TimeProblem::GetNumberOfResponses( ) const noexcept
       responses_.size();
 }
 
+FactOperation TimeProblem::GetOperation( ) const noexcept
+{
+   return
+      FactOperation::TIME;
+}
+
+uint16_t TimeProblem::GetFactId( ) const noexcept
+{
+   return
+      fact_id_;
+}
+
+std::vector< int32_t > TimeProblem::GetResponseValues( ) const noexcept
+{
+   std::vector< int32_t > response_values;
+
+   response_values.reserve(
+      responses_.size());
+
+   for (const auto & response : responses_)
+   {
+      response_values.push_back(
+         EncodeTimeResponse(
+            response.toStdString()));
+   }
+
+   return
+      response_values;
+}
+
 void TimeProblem::OnPaintEvent(
    QPaintEvent * paint_event,
+   QPainter & painter,
    QWidget & widget ) noexcept
 {
    std::visit(
@@ -220,16 +241,16 @@ void TimeProblem::OnPaintEvent(
          using T = std::decay_t< decltype(argument) >;
 
          if constexpr (std::is_same_v< T, Time >)
-            PaintTimeProblem(widget);
+            PaintTimeProblem(painter, widget);
          else if constexpr (std::is_same_v< T, MilitaryTime >)
-            PaintMilitaryTimeProblem(widget);
+            PaintMilitaryTimeProblem(painter, widget);
          else
             static_assert(false);
       },
       problem_);
 }
 
-void TimeProblem::OnKeyReleaseEvent(
+void TimeProblem::OnKeyPressEvent(
    QKeyEvent * key_event,
    const QWidget & widget ) noexcept
 {
@@ -250,7 +271,7 @@ void TimeProblem::OnKeyReleaseEvent(
    case Qt::Key::Key_9: [[fall_through]];
    case Qt::Key::Key_Colon: [[fall_through]];
    case Qt::Key::Key_Semicolon:
-      if (response_.size() < 5)
+      if (response_.size() < MAX_RESPONSE_LENGTH)
       {
          // sometimes the user will release the shift key and
          // sometimes qt doesn't always register the shift key
@@ -264,12 +285,20 @@ void TimeProblem::OnKeyReleaseEvent(
          {
             response_ += static_cast< QChar >(key);
          }
+
+         InvalidateCanvases();
       }
 
       break;
 
    case Qt::Key::Key_Backspace:
-      response_.removeLast();
+      if (!response_.isEmpty())
+      {
+         response_.removeLast();
+
+         InvalidateCanvases();
+      }
+
       break;
 
    case Qt::Key::Key_Enter: [[fall_through]];
@@ -280,17 +309,21 @@ void TimeProblem::OnKeyReleaseEvent(
 }
 
 void TimeProblem::PaintTimeProblem(
+   QPainter & widget_painter,
    QWidget & widget ) noexcept
 {
-   const QPixmap clock_face =
-      RenderClock();
+   if (!IsCanvasCurrent(Canvas::PICTURE))
+   {
+      ClaimCanvas(Canvas::PICTURE) =
+         RenderClock();
+   }
+
+   const QPixmap & clock_face =
+      GetCanvas(
+         Canvas::PICTURE);
    QSize clock_face_size =
       clock_face.size();
 
-   QPainter widget_painter {
-      &widget
-   };
-
    widget_painter.setRenderHint(
       QPainter::RenderHint::SmoothPixmapTransform,
       true);
@@ -325,11 +358,106 @@ void TimeProblem::PaintTimeProblem(
       clock_face);
 
    PaintQuestionAndResponse(
+      widget_painter,
       widget);
 }
 
 void TimeProblem::PaintMilitaryTimeProblem(
+   QPainter & widget_painter,
    QWidget & widget ) noexcept
+{
+   if (!IsCanvasCurrent(Canvas::PICTURE))
+   {
+      ClaimCanvas(Canvas::PICTURE) =
+         RenderClockAndSunScene();
+   }
+
+   const QPixmap & combined_clock_and_scene =
+      GetCanvas(
+         Canvas::PICTURE);
+
+   QSize combined_clock_and_scene_size =
+      combined_clock_and_scene.size();
+
+   widget_painter.setRenderHint(
+      QPainter::RenderHint::SmoothPixmapTransform,
+      true);
+
+   const QSize widget_size =
+      QSize {
+         widget.width() - 60,
+         (widget.height() - 60) / 2
+      };
+
+   if (widget_size.width() >= widget_size.height())
+   {
+      combined_clock_and_scene_size.scale(
+         widget_size.width(),
+         widget_size.height(),
+         Qt::AspectRatioMode::KeepAspectRatio);
+   }
+   else
+   {
+      combined_clock_and_scene_size.scale(
+         widget_size.width(),
+         widget_size.height(),
+         Qt::AspectRatioMode::KeepAspectRatio);
+   }
+
+   widget_painter.drawPixmap(
+      QRect {
+         widget.width() / 2 - combined_clock_and_scene_size.width() / 2,
+         30,
+         combined_clock_and_scene_size.width(),
+         combined_clock_and_scene_size.height() },
+      combined_clock_and_scene);
+
+   PaintQuestionAndResponse(
+      widget_painter,
+      widget);
+}
+
+void TimeProblem::PaintQuestionAndResponse(
+   QPainter & widget_painter,
+   QWidget & widget ) noexcept
+{
+   if (!IsCanvasCurrent(Canvas::TEXT))
+   {
+      RenderQuestionAndResponse(
+         ClaimCanvas(Canvas::TEXT));
+   }
+
+   const QPixmap & text_pixmap =
+      GetCanvas(
+         Canvas::TEXT);
+
+   widget_painter.setRenderHint(
+      QPainter::RenderHint::SmoothPixmapTransform,
+      true);
+
+   QSize text_size =
+      text_pixmap.size();
+
+   text_size.scale(
+      widget.width() - 120.0,
+      (widget.height() - 120.0) / 2.0 - 2.0,
+      Qt::AspectRatioMode::KeepAspectRatio);
+
+   widget_painter.drawPixmap(
+      QRectF { 
+         widget.width() / 2.0 - text_size.width() / 2.0,
+         widget.height() / 2.0 + 2.0,
+         static_cast< qreal >(text_size.width()),
+         static_cast< qreal >(text_size.height()), },
+      text_pixmap,
+      QRectF {
+         0.0,
+         0.0,
+         static_cast< qreal >(text_pixmap.width()),
+         static_cast< qreal >(text_pixmap.height()) });
+}
+
+QPixmap TimeProblem::RenderClockAndSunScene( ) const noexcept
 {
    QPixmap morning_afternoon_scene =
       RenderSunScene();
@@ -372,9 +500,6 @@ void TimeProblem::PaintMilitaryTimeProblem(
       clock_face_size.height()
    };
 
-   QSize combined_clock_and_scene_size =
-      combined_clock_and_scene.size();
-
    combined_clock_and_scene.fill(
       Qt::transparent);
 
@@ -389,49 +514,14 @@ void TimeProblem::PaintMilitaryTimeProblem(
       clock_face_size.width() + 10, 0,
       morning_afternoon_scene);
 
-   QPainter widget_painter {
-      &widget
-   };
-
-   widget_painter.setRenderHint(
-      QPainter::RenderHint::SmoothPixmapTransform,
-      true);
-
-   const QSize widget_size =
-      QSize {
-         widget.width() - 60,
-         (widget.height() - 60) / 2
-      };
-
-   if (widget_size.width() >= widget_size.height())
-   {
-      combined_clock_and_scene_size.scale(
-         widget_size.width(),
-         widget_size.height(),
-         Qt::AspectRatioMode::KeepAspectRatio);
-   }
-   else
-   {
-      combined_clock_and_scene_size.scale(
-         widget_size.width(),
-         widget_size.height(),
-         Qt::AspectRatioMode::KeepAspectRatio);
-   }
-
-   widget_painter.drawPixmap(
-      QRect {
-         widget.width() / 2 - combined_clock_and_scene_size.width() / 2,
-         30,
-         combined_clock_and_scene_size.width(),
-         combined_clock_and_scene_size.height() },
-      combined_clock_and_scene);
+   combined_clock_and_scene_painter.end();
 
-   PaintQuestionAndResponse(
-      widget);
+   return
+      combined_clock_and_scene;
 }
 
-void TimeProblem::PaintQuestionAndResponse(
-   QWidget & widget ) noexcept
+void TimeProblem::RenderQuestionAndResponse(
+   QPixmap & text_pixmap ) const noexcept
 {
    const auto [
       question,
@@ -439,9 +529,13 @@ void TimeProblem::PaintQuestionAndResponse(
       GetQuestion(problem_);
 
    // pixmap is at pixel ratio of 1.0
-   QPixmap text_pixmap {
-      text_pixmap_size
-   };
+   if (text_pixmap.size() != text_pixmap_size)
+   {
+      text_pixmap =
+         QPixmap {
+            text_pixmap_size
+         };
+   }
 
    text_pixmap.fill(
       QColor { 0, 0, 0, 0 });
@@ -457,17 +551,8 @@ void TimeProblem::PaintQuestionAndResponse(
       QPainter::RenderHint::TextAntialiasing,
       true);
 
-   const QFont font {
-   #if _WIN32
-      "Comic Sans MS",
-   #else
-      "Noto Sans Mono",
-   #endif
-      200
-   };
-
    text_painter.setFont(
-      font);
+      GetFont());
 
    // set the line thickness
    // set the color of the font
@@ -481,43 +566,23 @@ void TimeProblem::PaintQuestionAndResponse(
       QRect { 0, 0, text_pixmap.width(), text_pixmap.height() },
       question + "\n" + response_,
       QTextOption { Qt::AlignmentFlag::AlignHCenter });
-
-   QPainter widget_painter {
-      &widget
-   };
-
-   widget_painter.setRenderHint(
-      QPainter::RenderHint::SmoothPixmapTransform,
-      true);
-
-   QSize text_size =
-      text_pixmap.size();
-
-   text_size.scale(
-      widget.width() - 120.0,
-      (widget.height() - 120.0) / 2.0 - 2.0,
-      Qt::AspectRatioMode::KeepAspectRatio);
-
-   widget_painter.drawPixmap(
-      QRectF { 
-         widget.width() / 2.0 - text_size.width() / 2.0,
-         widget.height() / 2.0 + 2.0,
-         static_cast< qreal >(text_size.width()),
-         static_cast< qreal >(text_size.height()), },
-      text_pixmap,
-      QRectF {
-         0.0,
-         0.0,
-         static_cast< qreal >(text_pixmap.width()),
-         static_cast< qreal >(text_pixmap.height()) });
 }
 
 QPixmap TimeProblem::RenderClock( ) const noexcept
 {
-   QPixmap clock_face { ":/clock-face-image" };
-   const QPixmap hour_hand { ":/clock-hour-hand-image" };
-   const QPixmap minute_hand { ":/clock-minute-hand-image" };
-   const QPixmap center_post { ":/clock-center-post-image" };
+   // painting on the face detaches it from the cached image
+   QPixmap clock_face =
+      GetImage(
+         ":/clock-face-image");
+   const QPixmap hour_hand =
+      GetImage(
+         ":/clock-hour-hand-image");
+   const QPixmap minute_hand =
+      GetImage(
+         ":/clock-minute-hand-image");
+   const QPixmap center_post =
+      GetImage(
+         ":/clock-center-post-image");
 
    QPainter clock_face_painter {
       &clock_face
@@ -594,9 +659,15 @@ QPixmap TimeProblem::RenderClock( ) const noexcept
 
 QPixmap TimeProblem::RenderSunScene( ) const noexcept
 {
-   QPixmap morning_afternoon_scene { ":/morning-afternoon-scene-image" };
-   const QPixmap morning_sun { ":/morning-sun-image" };
-   const QPixmap afternoon_sun { ":/afternoon-sun-image" };
+   QPixmap morning_afternoon_scene =
+      GetImage(
+         ":/morning-afternoon-scene-image");
+   const QPixmap morning_sun =
+      GetImage(
+         ":/morning-sun-image");
+   const QPixmap afternoon_sun =
+      GetImage(
+         ":/afternoon-sun-image");
 
    QPainter scene_painter {
       &morning_afternoon_scene
@@ -639,15 +710,19 @@ void TimeProblem::GradeAnswer( ) noexcept
       response_);
 
    const auto result =
-      GradeResponse(
-         problem_,
-         response_) ?
+      GradeTimeResponse(
+         fact_id_,
+         response_.toStdString()) ?
       AnswerResult::CORRECT :
       AnswerResult::INCORRECT;
 
    if (result == AnswerResult::INCORRECT)
    {
-      response_.clear();
+      // clear would give up the reserved capacity
+      response_.truncate(
+         0);
+
+      InvalidateCanvases();
    }
 
    emit
@@ -10,6 +10,7 @@
 #include <variant>
 #include <utility>
 
+class QPainter;
 class QPixmap;
 class QSize;
 class QString;
@@ -26,9 +27,6 @@ public:
          const uint8_t hour,
          const uint8_t minute ) noexcept;
 
-      bool GradeResponse(
-         const QString & response ) const noexcept;
-
       QString Answer( ) const noexcept;
       std::pair< QString, QSize > Question( ) const noexcept;
 
@@ -49,9 +47,6 @@ public:
          const uint8_t minute,
          const bool is_afternoon ) noexcept;
 
-      bool GradeResponse(
-         const QString & response ) const noexcept;
-
       QString Answer( ) const noexcept;
       std::pair< QString, QSize > Question( ) const noexcept;
 
@@ -72,36 +67,54 @@ public:
       MilitaryTime time ) noexcept;
    virtual ~TimeProblem( ) noexcept;
 
+   // every image a time problem is drawn from
+   static QVector< QString > GetImageResourceIds( ) noexcept;
+
    virtual QVector< QString > GetResponses( ) const noexcept override;
    virtual QString GetQuestionWithAnswer( ) const noexcept override;
    virtual size_t GetNumberOfResponses( ) const noexcept override;
+   virtual FactOperation GetOperation( ) const noexcept override;
+   virtual uint16_t GetFactId( ) const noexcept override;
+   virtual std::vector< int32_t > GetResponseValues( ) const noexcept override;
 
    virtual void OnPaintEvent(
       QPaintEvent * paint_event,
+      QPainter & painter,
       QWidget & widget ) noexcept override;
-   virtual void OnKeyReleaseEvent(
+   virtual void OnKeyPressEvent(
       QKeyEvent * key_event,
       const QWidget & widget ) noexcept override;
 
 private:
+   static constexpr qsizetype MAX_RESPONSE_LENGTH { 5 };
+
    void PaintTimeProblem(
+      QPainter & widget_painter,
       QWidget & widget ) noexcept;
    void PaintMilitaryTimeProblem(
+      QPainter & widget_painter,
       QWidget & widget ) noexcept;
    void PaintQuestionAndResponse(
+      QPainter & widget_painter,
       QWidget & widget ) noexcept;
 
    QPixmap RenderClock( ) const noexcept;
    QPixmap RenderSunScene( ) const noexcept;
+   QPixmap RenderClockAndSunScene( ) const noexcept;
+   void RenderQuestionAndResponse(
+      QPixmap & text_pixmap ) const noexcept;
 
    void GradeAnswer( ) noexcept;
 
+   // its capacity is reserved, so typing never allocates
    QString response_;
 
    QVector< QString > responses_;
 
    std::variant< Time, MilitaryTime > problem_;
 
+   uint16_t fact_id_;
+
 };
 
 #endif // _TIME_PROBLEM_HPP_
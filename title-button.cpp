@@ -0,0 +1,143 @@
+#include "title-button.hpp"
+
+#include <QtCore/QRect>
+#include <QtCore/QRectF>
+#include <QtCore/Qt>
+#include <QtGui/QBrush>
+#include <QtGui/QColor>
+#include <QtGui/QPainter>
+#include <QtGui/QPen>
+
+TitleButton::TitleButton(
+   QWidget * const parent ) noexcept :
+QPushButton { parent },
+scaled_for_device_pixel_ratio_ { }
+{
+   // entering and leaving changes the background
+   setAttribute(
+      Qt::WidgetAttribute::WA_Hover);
+}
+
+void TitleButton::SetImage(
+   const QString & resource_id ) noexcept
+{
+   image_.load(
+      resource_id);
+
+   scaled_image_ =
+      QPixmap { };
+
+   update();
+}
+
+void TitleButton::paintEvent(
+   QPaintEvent * /*paint_event*/ )
+{
+   QPainter painter {
+      this
+   };
+
+   painter.setRenderHint(
+      QPainter::RenderHint::Antialiasing);
+
+   const qreal half_border_width {
+      BORDER_WIDTH / 2.0
+   };
+
+   painter.setPen(
+      QPen {
+         QColor { 0xF5F5DC },
+         BORDER_WIDTH
+      });
+
+   painter.setBrush(
+      underMouse() && !isDown() ?
+         QBrush { QColor { 0xACFF7E } } :
+         QBrush { Qt::BrushStyle::NoBrush });
+
+   painter.drawRoundedRect(
+      QRectF { rect() }.adjusted(
+         half_border_width, half_border_width,
+         -half_border_width, -half_border_width),
+      BORDER_RADIUS,
+      BORDER_RADIUS);
+
+   const int inset =
+      static_cast< int >(BORDER_WIDTH) + PADDING;
+
+   const QRect contents =
+      rect().adjusted(
+         inset, inset,
+         -inset, -inset);
+
+   if (contents.isEmpty())
+      return;
+
+   const QPixmap & image =
+      ScaledImage(
+         contents.size());
+
+   if (image.isNull())
+      return;
+
+   const QSize image_size =
+      (QSizeF { image.size() } / image.devicePixelRatio()).toSize();
+
+   painter.drawPixmap(
+      QRect {
+         contents.x() + (contents.width() - image_size.width()) / 2,
+         contents.y() + (contents.height() - image_size.height()) / 2,
+         image_size.width(),
+         image_size.height()
+      },
+      image);
+}
+
+const QPixmap & TitleButton::ScaledImage(
+   const QSize & contents_size ) noexcept
+{
+   const qreal device_pixel_ratio =
+      devicePixelRatioF();
+
+   if (!scaled_image_.isNull() &&
+       scaled_for_size_ == contents_size &&
+       scaled_for_device_pixel_ratio_ == device_pixel_ratio)
+   {
+      return
+         scaled_image_;
+   }
+
+   scaled_for_size_ =
+      contents_size;
+   scaled_for_device_pixel_ratio_ =
+      device_pixel_ratio;
+
+   if (image_.isNull())
+   {
+      scaled_image_ =
+         QPixmap { };
+
+      return
+         scaled_image_;
+   }
+
+   const QSize image_size =
+      image_.width() > contents_size.width() ||
+      image_.height() > contents_size.height() ?
+         image_.size().scaled(
+            contents_size,
+            Qt::AspectRatioMode::KeepAspectRatio) :
+         image_.size();
+
+   scaled_image_ =
+      image_.scaled(
+         image_size * device_pixel_ratio,
+         Qt::AspectRatioMode::KeepAspectRatio,
+         Qt::TransformationMode::SmoothTransformation);
+
+   scaled_image_.setDevicePixelRatio(
+      device_pixel_ratio);
+
+   return
+      scaled_image_;
+}
@@ -0,0 +1,46 @@
+#ifndef _TITLE_BUTTON_HPP_
+#define _TITLE_BUTTON_HPP_
+
+#include <QtCore/QSize>
+#include <QtCore/QString>
+#include <QtCore/QtTypes>
+#include <QtGui/QPaintEvent>
+#include <QtGui/QPixmap>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QWidget>
+
+// a title stage button that draws its frame and image itself.  the image
+// is scaled once for the size of the button and kept until the size or
+// the screen changes, so a paint is a rounded rectangle and one blit.
+class TitleButton :
+   public QPushButton
+{
+public:
+   static constexpr qreal BORDER_WIDTH { 2.0 };
+   static constexpr qreal BORDER_RADIUS { 10.0 };
+   static constexpr int PADDING { 1 };
+
+   explicit TitleButton(
+      QWidget * const parent = nullptr ) noexcept;
+
+   void SetImage(
+      const QString & resource_id ) noexcept;
+
+protected:
+   virtual void paintEvent(
+      QPaintEvent * paint_event ) override;
+
+private:
+   // like a style sheet image, shrunk to fit but never enlarged
+   const QPixmap & ScaledImage(
+      const QSize & contents_size ) noexcept;
+
+   QPixmap image_;
+
+   QPixmap scaled_image_;
+   QSize scaled_for_size_;
+   qreal scaled_for_device_pixel_ratio_;
+
+};
+
+#endif // _TITLE_BUTTON_HPP_
@@ -0,0 +1,233 @@
+#include "work-stealing-pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+WorkStealingPool::WorkStealingPool(
+   const size_t worker_count ) noexcept :
+stop_requested_ { },
+queued_tasks_ { },
+pending_tasks_ { },
+next_queue_ { }
+{
+   const size_t count =
+      worker_count ?
+         worker_count :
+         std::max< size_t >(std::thread::hardware_concurrency(), 1);
+
+   try
+   {
+      for (size_t i { }; i < count; ++i)
+      {
+         queues_.push_back(
+            std::make_unique< Queue >());
+      }
+
+      for (size_t i { }; i < count; ++i)
+      {
+         workers_.emplace_back(
+            &WorkStealingPool::WorkerLoop,
+            this,
+            i);
+      }
+   }
+   catch (...)
+   {
+      // run with whatever workers could be created; queues without a
+      // worker are drained by stealing
+      queues_.resize(
+         std::max< size_t >(workers_.size(), 1));
+   }
+}
+
+WorkStealingPool::~WorkStealingPool( ) noexcept
+{
+   Wait();
+
+   {
+      const std::lock_guard< std::mutex > lock {
+         idle_mutex_
+      };
+
+      stop_requested_ = true;
+   }
+
+   work_available_.notify_all();
+
+   for (auto & worker : workers_)
+   {
+      worker.join();
+   }
+}
+
+size_t WorkStealingPool::WorkerCount( ) const noexcept
+{
+   return
+      std::max< size_t >(workers_.size(), 1);
+}
+
+void WorkStealingPool::Submit(
+   Task task )
+{
+   if (workers_.empty())
+   {
+      // no worker could be started
+      task(0);
+
+      return;
+   }
+
+   pending_tasks_.fetch_add(
+      1,
+      std::memory_order_relaxed);
+
+   Queue & queue =
+      *queues_[next_queue_];
+
+   next_queue_ =
+      (next_queue_ + 1) % workers_.size();
+
+   {
+      const std::lock_guard< std::mutex > lock {
+         queue.mutex
+      };
+
+      queue.tasks.push_back(
+         std::move(task));
+   }
+
+   queued_tasks_.fetch_add(
+      1,
+      std::memory_order_release);
+
+   {
+      // taken so that a worker cannot miss the wake up between checking
+      // for queued tasks and waiting
+      const std::lock_guard< std::mutex > lock {
+         idle_mutex_
+      };
+   }
+
+   work_available_.notify_one();
+}
+
+void WorkStealingPool::Wait( ) noexcept
+{
+   std::unique_lock< std::mutex > lock {
+      idle_mutex_
+   };
+
+   work_done_.wait(
+      lock,
+      [ this ] ( )
+      {
+         return
+            pending_tasks_.load(std::memory_order_acquire) == 0;
+      });
+}
+
+void WorkStealingPool::WorkerLoop(
+   const size_t worker_index ) noexcept
+{
+   Task task;
+
+   while (true)
+   {
+      if (TryPop(worker_index, task) ||
+          TrySteal(worker_index, task))
+      {
+         try
+         {
+            task(worker_index);
+         }
+         catch (...)
+         {
+         }
+
+         task = nullptr;
+
+         if (pending_tasks_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+         {
+            const std::lock_guard< std::mutex > lock {
+               idle_mutex_
+            };
+
+            work_done_.notify_all();
+         }
+
+         continue;
+      }
+
+      std::unique_lock< std::mutex > lock {
+         idle_mutex_
+      };
+
+      work_available_.wait(
+         lock,
+         [ this ] ( )
+         {
+            return
+               stop_requested_ ||
+               queued_tasks_.load(std::memory_order_acquire) != 0;
+         });
+
+      if (stop_requested_ &&
+          queued_tasks_.load(std::memory_order_acquire) == 0)
+      {
+         return;
+      }
+   }
+}
+
+bool WorkStealingPool::TryPop(
+   const size_t worker_index,
+   Task & task ) noexcept
+{
+   Queue & queue =
+      *queues_[worker_index];
+
+   const std::lock_guard< std::mutex > lock {
+      queue.mutex
+   };
+
+   if (queue.tasks.empty())
+      return false;
+
+   task = std::move(queue.tasks.back());
+   queue.tasks.pop_back();
+
+   queued_tasks_.fetch_sub(
+      1,
+      std::memory_order_relaxed);
+
+   return true;
+}
+
+bool WorkStealingPool::TrySteal(
+   const size_t worker_index,
+   Task & task ) noexcept
+{
+   for (size_t offset { 1 }; offset < queues_.size(); ++offset)
+   {
+      Queue & queue =
+         *queues_[(worker_index + offset) % queues_.size()];
+
+      const std::lock_guard< std::mutex > lock {
+         queue.mutex
+      };
+
+      if (!queue.tasks.empty())
+      {
+         task = std::move(queue.tasks.front());
+         queue.tasks.pop_front();
+
+         queued_tasks_.fetch_sub(
+            1,
+            std::memory_order_relaxed);
+
+         return true;
+      }
+   }
+
+   return false;
+}
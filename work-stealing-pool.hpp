@@ -0,0 +1,76 @@
+#ifndef _WORK_STEALING_POOL_HPP_
+#define _WORK_STEALING_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads, each with its own task queue.  a worker
+// runs its own tasks newest first and, when it runs dry, steals the
+// oldest task of another worker, so uneven tasks still keep every
+// worker busy until the end.
+class WorkStealingPool
+{
+public:
+   // tasks receive the index of the worker running them, which allows
+   // per worker state that needs no synchronization
+   using Task = std::function< void ( const size_t worker_index ) >;
+
+   // zero uses one worker per hardware thread
+   explicit WorkStealingPool(
+      const size_t worker_count ) noexcept;
+   // waits for all tasks to finish
+   ~WorkStealingPool( ) noexcept;
+
+   WorkStealingPool(
+      const WorkStealingPool & ) = delete;
+   WorkStealingPool & operator = (
+      const WorkStealingPool & ) = delete;
+
+   size_t WorkerCount( ) const noexcept;
+
+   // called from a single thread only
+   void Submit(
+      Task task );
+   void Wait( ) noexcept;
+
+private:
+   struct Queue
+   {
+      std::mutex mutex;
+      std::deque< Task > tasks;
+   };
+
+   void WorkerLoop(
+      const size_t worker_index ) noexcept;
+
+   bool TryPop(
+      const size_t worker_index,
+      Task & task ) noexcept;
+   bool TrySteal(
+      const size_t worker_index,
+      Task & task ) noexcept;
+
+   std::vector< std::unique_ptr< Queue > > queues_;
+   std::vector< std::thread > workers_;
+
+   std::mutex idle_mutex_;
+   std::condition_variable work_available_;
+   std::condition_variable work_done_;
+   bool stop_requested_;
+
+   // tasks waiting in a queue, and tasks submitted but not yet finished
+   std::atomic< size_t > queued_tasks_;
+   std::atomic< size_t > pending_tasks_;
+
+   size_t next_queue_;
+
+};
+
+#endif // _WORK_STEALING_POOL_HPP_